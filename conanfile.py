@@ -0,0 +1,14 @@
+from conans import ConanFile
+
+
+class GramtoolsConan(ConanFile):
+    settings = "os", "compiler", "build_type", "arch"
+    options = {"benchmarks": [True, False]}
+    default_options = {"benchmarks": False}
+    requires = ("boost/1.69.0", "nlohmann_json/3.7.3", "gtest/1.10.0")
+    generators = "cmake"
+
+    def requirements(self):
+        # Only bench_main needs it: see libgramtools/benchmarks/README.md
+        if self.options.benchmarks:
+            self.requires("benchmark/1.5.0")
@@ -27,7 +27,7 @@ def setup_parser(common_parser, subparsers):
         nargs="+",
         action="append",
         type=str,
-        required=True,
+        required=False,
     )
 
     parser.add_argument(
@@ -59,3 +59,120 @@ def setup_parser(common_parser, subparsers):
         type=int,
         required=False,
     )
+
+    parser.add_argument(
+        "--max_allele_combinations",
+        help="Maximum number of alleles considered per haplogroup of a site, when"
+        " combining the alleles of nested sites. Default: 10000.",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--regions",
+        help="BED file of regions of the reference to genotype: only the sites"
+        " overlapping them get genotyped and output, and only the reads reaching"
+        " them get mapped. Default: None (all sites get genotyped).",
+        type=str,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--read_cache_size",
+        help="Maximum number of reads whose mappings are cached, so that"
+        " duplicate reads only get mapped once. 0 disables the cache."
+        " Default: 100000.",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--search_mode",
+        help="Where searching a read in the prg starts: 'backward' starts from"
+        " its last kmer; 'seed_extend' from its kmer with fewest occurrences,"
+        " which keeps fewer candidate mappings in highly variable regions."
+        " Default: backward.",
+        choices=["backward", "seed_extend"],
+        required=False,
+    )
+
+    parser.add_argument(
+        "--max_mismatches",
+        help="Reads with no exact mapping get mapped again allowing up to this"
+        " many base substitutions, at the positions their missing kmers point"
+        " to. Default: 0 (reads are only mapped exactly).",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--max_search_states",
+        help="Maximum number of candidate mappings kept per read when mapping"
+        " with substitutions. Default: 1000.",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--quasimap_only",
+        help="Only map the reads, writing their coverage to a partial coverage"
+        " file (coverage/partial_coverage.bin). Partial coverage files from"
+        " parts of a sample's reads, mapped on several processes or machines,"
+        " can then be genotyped together with --merge_coverage.",
+        action="store_true",
+    )
+
+    parser.add_argument(
+        "--compress_coverage",
+        help="Gzip the binary coverage file (coverage/coverage.bin.gz).",
+        action="store_true",
+    )
+
+    parser.add_argument(
+        "--no_coverage_json",
+        help="Do not write per base and grouped allele coverage in the legacy"
+        " JSON files, only in the binary coverage file. The submods"
+        " coverage_to_json converter produces them from it.",
+        action="store_true",
+    )
+
+    parser.add_argument(
+        "--checkpoint_seconds",
+        help="Seconds between checkpoints of read mapping, which --resume restarts"
+        " from. 0, the default, disables checkpoints.",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--resume",
+        help="Restart read mapping from the last checkpoint in --genotype_dir,"
+        " instead of overwriting it. The other arguments must be those of the"
+        " interrupted run.",
+        action="store_true",
+    )
+
+    parser.add_argument(
+        "--progress_seconds",
+        help="Seconds between reports of read mapping progress, to stderr."
+        " 0 disables them, but for a last one to --progress_file, if given.",
+        type=int,
+        required=False,
+    )
+
+    parser.add_argument(
+        "--progress_file",
+        help="File replaced with each progress report, in JSON, for job"
+        " schedulers to poll.",
+        required=False,
+    )
+
+    parser.add_argument(
+        "--merge_coverage",
+        help="Partial coverage files written with --quasimap_only. They get"
+        " summed and genotyped instead of reads.",
+        nargs="+",
+        action="append",
+        type=str,
+        required=False,
+    )
@@ -21,6 +21,9 @@ log = logging.getLogger("gramtools")
 
 
 def run(args):
+    if (args.reads is None) == (args.merge_coverage is None):
+        log.error("Exactly one of --reads and --merge_coverage must be used")
+        exit(1)
     geno_paths = GenotypePaths(args.geno_dir, args.force)
     geno_paths.setup(args)
 
@@ -35,9 +38,10 @@ def run(args):
     _execute_command_cpp_genotype(geno_report, "gramtools_genotype", geno_paths, args)
     geno_report["ploidy"] = args.ploidy
 
-    _check_read_stats(geno_report, "check_read_stats", geno_paths)
+    if not args.quasimap_only:
+        _check_read_stats(geno_report, "check_read_stats", geno_paths)
 
-    _make_rebasing_map(geno_paths)
+        _make_rebasing_map(geno_paths)
 
     log.debug("Computing sha256 hash of project paths")
     command_hash_paths = common.hash_command_paths(geno_paths)
@@ -72,8 +76,6 @@ def _execute_command_cpp_genotype(geno_report, action, geno_paths, args):
         "genotype",
         "--gram_dir",
         str(geno_paths.gram_dir),
-        "--reads",
-        *list(map(str, geno_paths.reads_files)),
         "--sample_id",
         args.sample_id,
         "--ploidy",
@@ -86,8 +88,39 @@ def _execute_command_cpp_genotype(geno_report, action, geno_paths, args):
         str(args.max_threads),
     ]
 
+    if geno_paths.reads_files:
+        command += ["--reads", *list(map(str, geno_paths.reads_files))]
+    if args.merge_coverage is not None:
+        merge_fpaths = [fpath for arglist in args.merge_coverage for fpath in arglist]
+        command += ["--merge_coverage", *merge_fpaths]
+    if args.quasimap_only:
+        command += ["--quasimap_only"]
+    if args.compress_coverage:
+        command += ["--compress_coverage"]
+    if args.no_coverage_json:
+        command += ["--no_coverage_json"]
+    if args.checkpoint_seconds is not None:
+        command += ["--checkpoint_seconds", str(args.checkpoint_seconds)]
+    if args.resume:
+        command += ["--resume"]
+    if args.progress_seconds is not None:
+        command += ["--progress_seconds", str(args.progress_seconds)]
+    if args.progress_file is not None:
+        command += ["--progress_file", args.progress_file]
     if args.seed is not None:
         command += ["--seed", str(args.seed)]
+    if args.max_allele_combinations is not None:
+        command += ["--max_allele_combinations", str(args.max_allele_combinations)]
+    if args.regions is not None:
+        command += ["--regions", args.regions]
+    if args.read_cache_size is not None:
+        command += ["--read_cache_size", str(args.read_cache_size)]
+    if args.search_mode is not None:
+        command += ["--search_mode", args.search_mode]
+    if args.max_mismatches is not None:
+        command += ["--max_mismatches", str(args.max_mismatches)]
+    if args.max_search_states is not None:
+        command += ["--max_search_states", str(args.max_search_states)]
     if args.debug:
         command += ["--debug"]
 
@@ -149,10 +149,17 @@ class GenotypePaths(ProjectPaths):
         self.rebasing_map = self.results_path("rebasing_map.json")
 
     def setup(self, args):
-        super().initial_setup()
-        self.reads_dir.mkdir()
-        self._link_to_build(args.gram_dir)
-        self._link_to_reads(args.reads)
+        # Resuming keeps the checkpoint of the interrupted run, and its links
+        resuming = args.resume and self.geno_dir.exists()
+        if resuming:
+            log.info(f"Resuming genotyping in {self.geno_dir}")
+        else:
+            super().initial_setup()
+            self.reads_dir.mkdir()
+            self._link_to_build(args.gram_dir)
+        self._link_to_reads(
+            args.reads if args.reads is not None else [], make_links=not resuming
+        )
 
     def _link_to_build(self, existing_gram_dir):
         """
@@ -165,10 +172,12 @@ class GenotypePaths(ProjectPaths):
             os.unlink(self.gram_dir)
         self.gram_dir.symlink_to(target, target_is_directory=True)
 
-    def _link_to_reads(self, reads: List[List[str]]):
+    def _link_to_reads(self, reads: List[List[str]], make_links: bool = True):
         self.reads_files = [
             Path(read_file).resolve() for arglist in reads for read_file in arglist
         ]
+        if not make_links:
+            return
 
         #  Make symlinks to the read files
         for read_file in self.reads_files:
@@ -39,6 +39,13 @@ def setup_parser(common_parser, subparsers):
         required=False,
         default=".",
     )
+    parser.add_argument(
+        "--seed",
+        help="Fix the seed to simulate the same paths across different runs.\n"
+        "Default: None (seed gets randomly generated).",
+        type=int,
+        required=False,
+    )
     parser.add_argument(
         "-i",
         "--induce_genotypes",
@@ -84,6 +91,8 @@ def _execute_command_cpp_simulate(simu_paths, args):
         "--o",
         str(simu_paths.output_dir),
     ] + input_multifasta
+    if args.seed is not None:
+        command += ["--seed", str(args.seed)]
 
     if args.debug:
         command += ["--debug"]
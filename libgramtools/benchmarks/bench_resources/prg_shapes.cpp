@@ -0,0 +1,27 @@
+#include "prg_shapes.hpp"
+
+using namespace gram::bench;
+
+void gram::bench::prg_shapes(benchmark::internal::Benchmark *bench) {
+  bench->ArgNames({"sites", "spacing", "alleles", "depth"});
+  // Sparse and dense biallelic sites, multiallelic sites, nested sites, and a
+  // larger prg
+  bench->Args({1000, 50, 2, 0});
+  bench->Args({1000, 10, 2, 0});
+  bench->Args({1000, 50, 6, 0});
+  bench->Args({1000, 50, 3, 2});
+  bench->Args({10000, 50, 2, 0});
+}
+
+SyntheticPrgSpec gram::bench::prg_spec(benchmark::State const &state) {
+  SyntheticPrgSpec spec;
+  spec.num_sites = state.range(0);
+  spec.invariant_length = state.range(1);
+  spec.num_alleles = state.range(2);
+  spec.nesting_depth = state.range(3);
+  return spec;
+}
+
+SyntheticPrg const &gram::bench::get_prg(benchmark::State const &state) {
+  return get_synthetic_prg(prg_spec(state));
+}
@@ -0,0 +1,23 @@
+/** @file
+ * The synthetic prg shapes that benchmarks run on, passed to them as
+ * benchmark arguments.
+ */
+#ifndef GRAMTOOLS_PRG_SHAPES_HPP
+#define GRAMTOOLS_PRG_SHAPES_HPP
+
+#include <benchmark/benchmark.h>
+
+#include "synthetic_prg.hpp"
+
+namespace gram::bench {
+/** Registers each prg shape as arguments of `bench` */
+void prg_shapes(benchmark::internal::Benchmark *bench);
+
+/** The prg shape `state` runs on */
+SyntheticPrgSpec prg_spec(benchmark::State const &state);
+
+/** The prg shape `state` runs on, built */
+SyntheticPrg const &get_prg(benchmark::State const &state);
+}  // namespace gram::bench
+
+#endif  // GRAMTOOLS_PRG_SHAPES_HPP
@@ -0,0 +1,176 @@
+#include "synthetic_prg.hpp"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <tuple>
+
+#include "build/kmer_index/build.hpp"
+#include "build/kmer_index/kmers.hpp"
+#include "genotype/quasimap/quasimap.hpp"
+#include "prg/linearised_prg.hpp"
+#include "submod_resources.hpp"
+
+using namespace gram;
+using namespace gram::bench;
+
+namespace {
+struct Site;
+
+/** Bases, possibly around one nested site */
+struct Allele {
+  std::string left;
+  std::vector<Site> nested;
+  std::string right;
+};
+
+struct Site {
+  std::vector<Allele> alleles;
+};
+
+class PrgGenerator {
+ public:
+  explicit PrgGenerator(SyntheticPrgSpec const &spec)
+      : rng(spec.seed), spec(spec) {}
+
+  std::string random_bases(std::size_t num_bases) {
+    static char const bases[] = "ACGT";
+    std::uniform_int_distribution<int> base(0, 3);
+    std::string result;
+    for (std::size_t i = 0; i < num_bases; ++i) result += bases[base(rng)];
+    return result;
+  }
+
+  /** The first allele of sites shallower than the nesting depth nests one */
+  Site make_site(std::size_t const depth) {
+    Site site;
+    for (std::size_t i = 0; i < spec.num_alleles; ++i) {
+      Allele allele;
+      if (i == 0 && depth < spec.nesting_depth) {
+        allele.left = random_bases(spec.allele_length / 2);
+        allele.nested.push_back(make_site(depth + 1));
+        allele.right = random_bases(spec.allele_length - allele.left.size());
+      } else
+        allele.left = random_bases(spec.allele_length);
+      site.alleles.push_back(std::move(allele));
+    }
+    return site;
+  }
+
+  /** Picks one allele per site, nested ones included */
+  std::string random_path(Site const &site) {
+    std::uniform_int_distribution<std::size_t> pick(0,
+                                                    site.alleles.size() - 1);
+    auto const &allele = site.alleles[pick(rng)];
+    std::string result = allele.left;
+    for (auto const &nested : allele.nested) result += random_path(nested);
+    return result + allele.right;
+  }
+
+  std::mt19937 rng;
+
+ private:
+  SyntheticPrgSpec const &spec;
+};
+
+std::string to_string(Site const &site) {
+  std::string result{"["};
+  for (std::size_t i = 0; i < site.alleles.size(); ++i) {
+    auto const &allele = site.alleles[i];
+    if (i > 0) result += ",";
+    result += allele.left;
+    for (auto const &nested : allele.nested) result += to_string(nested);
+    result += allele.right;
+  }
+  return result + "]";
+}
+}  // namespace
+
+SyntheticPrg::SyntheticPrg(SyntheticPrgSpec const &spec) {
+  if (spec.num_sites == 0 || spec.invariant_length == 0 ||
+      spec.num_alleles < 2 || spec.allele_length < 2)
+    throw std::invalid_argument(
+        "Synthetic prgs need sites, flanked by bases, with at least two "
+        "alleles of at least two bases");
+  PrgGenerator generator{spec};
+  std::vector<std::string> invariants;
+  std::vector<Site> sites;
+  invariants.push_back(generator.random_bases(spec.invariant_length));
+  for (std::size_t i = 0; i < spec.num_sites; ++i) {
+    sites.push_back(generator.make_site(0));
+    invariants.push_back(generator.random_bases(spec.invariant_length));
+  }
+
+  prg_string = invariants[0];
+  for (std::size_t i = 0; i < spec.num_sites; ++i)
+    prg_string += to_string(sites[i]) + invariants[i + 1];
+  for (std::size_t h = 0; h < spec.num_haplotypes; ++h) {
+    std::string haplotype = invariants[0];
+    for (std::size_t i = 0; i < spec.num_sites; ++i)
+      haplotype += generator.random_path(sites[i]) + invariants[i + 1];
+    haplotypes.push_back(std::move(haplotype));
+  }
+
+  prg_info = submods::generate_prg_info(prg_string_to_ints(prg_string));
+  // As in the tests: rank and select supports need re-initialising once
+  // `prg_info` is out of `generate_prg_info`'s scope
+  sdsl::util::init_support(prg_info.rank_bwt_a, &prg_info.dna_bwt_masks.mask_a);
+  sdsl::util::init_support(prg_info.rank_bwt_c, &prg_info.dna_bwt_masks.mask_c);
+  sdsl::util::init_support(prg_info.rank_bwt_g, &prg_info.dna_bwt_masks.mask_g);
+  sdsl::util::init_support(prg_info.rank_bwt_t, &prg_info.dna_bwt_masks.mask_t);
+  sdsl::util::init_support(prg_info.prg_markers_rank,
+                           &prg_info.prg_markers_mask);
+  sdsl::util::init_support(prg_info.prg_markers_select,
+                           &prg_info.prg_markers_mask);
+  // Written by `generate_prg_info` to build the fm index
+  std::remove("encoded_prg_file_name");
+  std::remove("fm_index");
+
+  std::uniform_int_distribution<std::size_t> pick_haplotype(
+      0, haplotypes.size() - 1);
+  // Reversed kmers, as ordered by `kmer_index::build`: consecutive ones then
+  // share search states in `index_kmers`
+  ordered_vector_set<Sequence> reverse_kmers;
+  for (std::size_t i = 0; i < spec.num_reads; ++i) {
+    auto const &haplotype = haplotypes[pick_haplotype(generator.rng)];
+    if (haplotype.size() < spec.read_length)
+      throw std::invalid_argument("Reads longer than the synthetic prg");
+    std::uniform_int_distribution<std::size_t> pick_start(
+        0, haplotype.size() - spec.read_length);
+    auto read = encode_dna_bases(
+        haplotype.substr(pick_start(generator.rng), spec.read_length));
+    for (std::size_t j = 0; j + spec.kmer_size <= read.size(); ++j) {
+      auto const kmer = get_kmer_in_read(spec.kmer_size, j, read);
+      reverse_kmers.insert(Sequence(kmer.rbegin(), kmer.rend()));
+    }
+    reads.push_back(std::move(read));
+  }
+  parameters.kmers_size = spec.kmer_size;
+  kmer_index = index_kmers(get_prefix_diffs(gram::reverse(reverse_kmers)),
+                           spec.kmer_size, prg_info);
+}
+
+std::vector<SearchState> SyntheticPrg::indexed_search_states() const {
+  std::map<Sequence, SearchStates> ordered(kmer_index.begin(),
+                                           kmer_index.end());
+  std::vector<SearchState> result;
+  for (auto const &entry : ordered)
+    result.insert(result.end(), entry.second.begin(), entry.second.end());
+  return result;
+}
+
+SyntheticPrg const &gram::bench::get_synthetic_prg(
+    SyntheticPrgSpec const &spec) {
+  using Key = std::tuple<std::size_t, std::size_t, std::size_t, std::size_t,
+                         std::size_t, std::size_t, std::size_t, std::size_t,
+                         uint32_t, uint32_t>;
+  static std::map<Key, std::unique_ptr<SyntheticPrg>> built;
+  Key const key{spec.num_sites,     spec.invariant_length, spec.num_alleles,
+                spec.nesting_depth, spec.allele_length,    spec.num_haplotypes,
+                spec.num_reads,     spec.read_length,      spec.kmer_size,
+                spec.seed};
+  auto &prg = built[key];
+  if (prg == nullptr) prg = std::make_unique<SyntheticPrg>(spec);
+  return *prg;
+}
@@ -0,0 +1,55 @@
+/** @file
+ * Synthetic prgs for benchmarking, built from a few shape parameters along
+ * with haplotypes they contain and reads sampled from those.
+ * The same parameters always give the same prg, haplotypes and reads.
+ */
+#ifndef GRAMTOOLS_SYNTHETIC_PRG_HPP
+#define GRAMTOOLS_SYNTHETIC_PRG_HPP
+
+#include "build/kmer_index/kmer_index_types.hpp"
+#include "genotype/parameters.hpp"
+#include "genotype/quasimap/search/types.hpp"
+#include "prg/prg_info.hpp"
+
+namespace gram::bench {
+
+struct SyntheticPrgSpec {
+  std::size_t num_sites; /**< Top-level sites */
+  std::size_t invariant_length; /**< Bases between sites: sets site density */
+  std::size_t num_alleles; /**< Per site, nested ones included */
+  std::size_t nesting_depth; /**< 0 for no nested sites */
+  std::size_t allele_length = 8; /**< Bases per allele, besides nested sites */
+  std::size_t num_haplotypes = 4; /**< Paths through the prg reads come from */
+  std::size_t num_reads = 1000;
+  std::size_t read_length = 150;
+  uint32_t kmer_size = 10;
+  uint32_t seed = 42;
+};
+
+class SyntheticPrg {
+ public:
+  explicit SyntheticPrg(SyntheticPrgSpec const &spec);
+
+  /** The `SearchState`s of all indexed kmers, in a fixed order */
+  std::vector<SearchState> indexed_search_states() const;
+
+  std::string prg_string; /**< Bracketed format */
+  std::vector<std::string> haplotypes;
+  /**
+   * Error-free, from random positions of random haplotypes. All are on the
+   * prg's strand, so that they map without reverse complementing them.
+   */
+  Sequences reads;
+  PRG_Info prg_info;
+  KmerIndex kmer_index; /**< Of the kmers in `reads` */
+  GenotypeParams parameters;
+};
+
+/**
+ * Builds the prg for `spec` on first use, then hands out the same one: building
+ * prgs is much slower than what gets benchmarked on them.
+ */
+SyntheticPrg const &get_synthetic_prg(SyntheticPrgSpec const &spec);
+}  // namespace gram::bench
+
+#endif  // GRAMTOOLS_SYNTHETIC_PRG_HPP
@@ -0,0 +1,278 @@
+"""
+End to end benchmark of gramtools: build, then genotype (quasimap + infer) at
+several thread counts, on reads simulated from known paths through the prg.
+
+Truth haplotypes come from `gramtools simulate`, which picks one allele per
+site at random and produces the personalised reference of each pick. Reads
+get sampled from those, with a substitution and indel error model.
+Reports, per stage and thread count, wall time and peak resident memory,
+reads/s for genotyping, and the concordance of genotype calls with the truth,
+so that performance work can get checked for accuracy regressions too.
+Genotyping reads/s is given both for read mapping alone, as its last
+progress report times it, and end to end, over the whole genotype wall time.
+
+Usage example:
+    python3 bench_pipeline.py --prg prg.bin --ref ref.fa -o bench_out \
+        --threads 1 2 4 8 --coverage 30 --substitution_rate 0.01
+"""
+import argparse
+import gzip
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+COMPLEMENT = str.maketrans("ACGTN", "TGCAN")
+BASES = "ACGT"
+
+
+def parse_args(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--ref", required=True, help="Reference for build")
+    variation = parser.add_mutually_exclusive_group(required=True)
+    variation.add_argument("--prg", help="Prg to build from")
+    variation.add_argument("--vcf", nargs="+", help="Vcf(s) to build from")
+    parser.add_argument("-o", "--output_dir", required=True)
+    parser.add_argument("--kmer_size", type=int, default=10)
+    parser.add_argument(
+        "--threads",
+        type=int,
+        nargs="+",
+        default=[1, 2, 4],
+        help="Values of genotype --max_threads to run at",
+    )
+    parser.add_argument("--ploidy", choices=["haploid", "diploid"], default="haploid")
+    parser.add_argument("--read_length", type=int, default=150)
+    parser.add_argument(
+        "--coverage",
+        type=float,
+        default=30,
+        help="Mean read depth, over all haplotypes",
+    )
+    parser.add_argument(
+        "--substitution_rate",
+        type=float,
+        default=0.01,
+        help="Per base probability of a substituted base. Also sets base qualities",
+    )
+    parser.add_argument(
+        "--indel_rate",
+        type=float,
+        default=0.0,
+        help="Per base probability of an inserted or deleted base",
+    )
+    parser.add_argument("--seed", type=int, default=42)
+    parser.add_argument(
+        "--gramtools",
+        default="gramtools",
+        help="Command running gramtools. Default: gramtools",
+    )
+    return parser.parse_args(argv)
+
+
+def run_stage(command, log_fpath: Path):
+    """
+    Runs one gramtools command, logging its output to `log_fpath`.
+    Peak resident memory comes from wait4, which covers the command and the
+    subprocesses it waited for (the gramtools backend).
+    """
+    start = time.perf_counter()
+    with log_fpath.open("w") as log_file:
+        process = subprocess.Popen(command, stdout=log_file, stderr=subprocess.STDOUT)
+        _, status, rusage = os.wait4(process.pid, 0)
+    wall_seconds = time.perf_counter() - start
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        raise RuntimeError(f"Failed: {' '.join(command)}\nSee {log_fpath}")
+    return {
+        "wall_seconds": round(wall_seconds, 3),
+        "peak_rss_kib": rusage.ru_maxrss,  # In KiB on Linux
+    }
+
+
+def load_fasta(fpath: Path):
+    sequences, seq_id = {}, None
+    with fpath.open() as fhandle:
+        for line in fhandle:
+            line = line.strip()
+            if line.startswith(">"):
+                seq_id = line[1:].split()[0]
+                sequences[seq_id] = []
+            elif seq_id is not None:
+                sequences[seq_id].append(line.upper())
+    return {seq_id: "".join(parts) for seq_id, parts in sequences.items()}
+
+
+def add_errors(read: str, rng: random.Random, substitution_rate, indel_rate):
+    result = []
+    for base in read:
+        if rng.random() < indel_rate:
+            if rng.random() < 0.5:
+                continue  # Deletion
+            result.append(rng.choice(BASES))  # Insertion
+        if rng.random() < substitution_rate:
+            base = rng.choice([other for other in BASES if other != base])
+        result.append(base)
+    return "".join(result)
+
+
+def sample_reads(haplotypes, reads_fpath: Path, args):
+    """
+    Samples reads uniformly from each haplotype, which get an equal share of
+    the coverage, and from either strand.
+    @return the number of reads sampled
+    """
+    rng = random.Random(args.seed)
+    if args.substitution_rate > 0:
+        phred = min(40, round(-10 * math.log10(args.substitution_rate)))
+    else:
+        phred = 40
+    quality = chr(33 + phred)
+    num_reads = 0
+    with gzip.open(reads_fpath, "wt") as fhandle:
+        for haplotype in haplotypes:
+            if len(haplotype) < args.read_length:
+                raise ValueError("Reads are longer than a simulated haplotype")
+            haplotype_coverage = args.coverage / len(haplotypes)
+            num_haplotype_reads = round(
+                haplotype_coverage * len(haplotype) / args.read_length
+            )
+            for _ in range(num_haplotype_reads):
+                start = rng.randint(0, len(haplotype) - args.read_length)
+                read = haplotype[start : start + args.read_length]
+                if rng.random() < 0.5:
+                    read = read.translate(COMPLEMENT)[::-1]
+                read = add_errors(read, rng, args.substitution_rate, args.indel_rate)
+                fhandle.write(f"@read{num_reads}\n{read}\n+\n{quality * len(read)}\n")
+                num_reads += 1
+    return num_reads
+
+
+def called_alleles(site, sample_index):
+    """@return the sorted called alleles of a jvcf site, or None if not called"""
+    gt = site["GT"][sample_index]
+    if len(gt) == 0 or any(allele_index is None for allele_index in gt):
+        return None
+    return sorted(site["ALS"][allele_index] for allele_index in gt)
+
+
+def compute_concordance(truth_json, truth_samples, called_json):
+    """
+    Compares called alleles with true alleles, at each site the truth has
+    alleles at. Sites are matched by segment and position.
+    Sites inside of alleles the truth did not pick have no true alleles.
+    """
+    called_sites = {(site["SEG"], site["POS"]): site for site in called_json["Sites"]}
+    result = {"sites": 0, "concordant": 0, "discordant": 0, "uncalled": 0}
+    for truth_site in truth_json["Sites"]:
+        true_alleles = [called_alleles(truth_site, sample) for sample in truth_samples]
+        if any(alleles is None for alleles in true_alleles):
+            continue
+        true_alleles = sorted(sum(true_alleles, []))
+        result["sites"] += 1
+        called_site = called_sites.get((truth_site["SEG"], truth_site["POS"]))
+        called = None if called_site is None else called_alleles(called_site, 0)
+        if called is None:
+            result["uncalled"] += 1
+        elif called == true_alleles:
+            result["concordant"] += 1
+        else:
+            result["discordant"] += 1
+    called_count = result["concordant"] + result["discordant"]
+    result["concordance"] = (
+        round(result["concordant"] / called_count, 5) if called_count > 0 else None
+    )
+    return result
+
+
+def simulate_truth(gram_dir: Path, output_dir: Path, args, results):
+    """
+    Simulates as many paths through the prg as the ploidy. Paths are
+    deduplicated by simulate: if only one is made, diploid truth is homozygous.
+    @return the truth haplotypes, the truth jvcf and the sample index of each
+    haplotype in it
+    """
+    simu_dir = output_dir / "simulate"
+    num_paths = 1 if args.ploidy == "haploid" else 2
+    results["simulate"] = run_stage(
+        [args.gramtools, "simulate", "--prg", str(gram_dir / "prg"), "-n"]
+        + [str(num_paths), "--sample_id", "truth", "-o", str(simu_dir)]
+        + ["--seed", str(args.seed), "--force"],
+        output_dir / "simulate.log",
+    )
+    haplotypes = list(load_fasta(simu_dir / "truth.fasta").values())
+    with (simu_dir / "truth.json").open() as fhandle:
+        truth_json = json.load(fhandle)
+    truth_samples = list(range(len(haplotypes)))
+    if len(haplotypes) < num_paths:
+        haplotypes *= 2
+        truth_samples *= 2
+    return haplotypes, truth_json, truth_samples
+
+
+def main(argv=None):
+    args = parse_args(argv)
+    output_dir = Path(args.output_dir).resolve()
+    output_dir.mkdir(parents=True, exist_ok=True)
+    gram_dir = output_dir / "gram_dir"
+    results = {"parameters": vars(args)}
+
+    build_command = [args.gramtools, "build", "--gram_dir", str(gram_dir)]
+    build_command += ["--ref", args.ref, "--kmer_size", str(args.kmer_size)]
+    if args.prg is not None:
+        build_command += ["--prg", args.prg]
+    else:
+        build_command += ["--vcf"] + args.vcf
+    results["build"] = run_stage(build_command + ["--force"], output_dir / "build.log")
+
+    haplotypes, truth_json, truth_samples = simulate_truth(
+        gram_dir, output_dir, args, results
+    )
+    reads_fpath = output_dir / "reads.fq.gz"
+    num_reads = sample_reads(haplotypes, reads_fpath, args)
+    results["num_reads"] = num_reads
+
+    results["genotype"] = []
+    for num_threads in args.threads:
+        geno_dir = output_dir / f"genotype_{num_threads}_threads"
+        progress_fpath = output_dir / f"genotype_{num_threads}_threads_progress.json"
+        run = run_stage(
+            [args.gramtools, "genotype", "--gram_dir", str(gram_dir)]
+            + ["--genotype_dir", str(geno_dir), "--reads", str(reads_fpath)]
+            + ["--sample_id", "bench", "--ploidy", args.ploidy]
+            + ["--max_threads", str(num_threads), "--seed", str(args.seed)]
+            + ["--progress_file", str(progress_fpath), "--force"],
+            output_dir / f"genotype_{num_threads}_threads.log",
+        )
+        run["max_threads"] = num_threads
+        with progress_fpath.open() as fhandle:
+            mapping_progress = json.load(fhandle)
+        run["mapping_seconds"] = round(mapping_progress["seconds"], 3)
+        run["mapping_reads_per_second"] = round(
+            mapping_progress["reads_per_second"], 1
+        )
+        run["end_to_end_reads_per_second"] = round(num_reads / run["wall_seconds"], 1)
+        with (geno_dir / "genotype" / "genotyped.json").open() as fhandle:
+            run["concordance"] = compute_concordance(
+                truth_json, truth_samples, json.load(fhandle)
+            )
+        results["genotype"].append(run)
+        print(
+            f"max_threads={num_threads}\twall_seconds={run['wall_seconds']}\t"
+            f"peak_rss_kib={run['peak_rss_kib']}\t"
+            f"mapping_reads_per_second={run['mapping_reads_per_second']}\t"
+            f"end_to_end_reads_per_second={run['end_to_end_reads_per_second']}\t"
+            f"concordance={run['concordance']['concordance']}"
+        )
+
+    results_fpath = output_dir / "bench_pipeline.json"
+    with results_fpath.open("w") as fhandle:
+        json.dump(results, fhandle, indent=2)
+    print(f"Results in {results_fpath}")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,27 @@
+#include "genotype/quasimap/coverage/coverage_common.hpp"
+#include "genotype/quasimap/quasimap.hpp"
+#include "prg_shapes.hpp"
+
+using namespace gram;
+using namespace gram::bench;
+
+/** Maps reads end to end, recording their coverage: reports reads/s */
+static void BM_quasimap_read(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  auto const &reads = prg.reads;
+  auto coverage = coverage::generate::empty_structure(prg.prg_info);
+  QuasimapReadsStats stats;
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto const &read = reads[i % reads.size()];
+    quasimap_read(read, coverage, prg.kmer_index, prg.prg_info, prg.parameters,
+                  stats, i);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+  // Reads all come from the prg: anything below 1 is a mapping regression
+  state.counters["mapped"] =
+      double(stats.exact_mapped_reads_count) / state.iterations();
+}
+BENCHMARK(BM_quasimap_read)->Apply(prg_shapes);
@@ -0,0 +1,49 @@
+#include <random>
+
+#include "genotype/quasimap/search/BWT_search.hpp"
+#include "prg_shapes.hpp"
+
+using namespace gram;
+using namespace gram::bench;
+
+static void BM_dna_bwt_rank(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  auto const bwt_size = prg.prg_info.fm_index.bwt.size();
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint64_t> pick_index(0, bwt_size);
+  std::uniform_int_distribution<Marker> pick_base(1, 4);
+  std::vector<std::pair<uint64_t, Marker>> queries(4096);
+  for (auto &query : queries) query = {pick_index(rng), pick_base(rng)};
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto const &query = queries[i++ % queries.size()];
+    benchmark::DoNotOptimize(
+        dna_bwt_rank(query.first, query.second, prg.prg_info));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_dna_bwt_rank)->Apply(prg_shapes);
+
+/** Extends the SA intervals of indexed kmers by one base */
+static void BM_base_next_sa_interval(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  auto const &fm_index = prg.prg_info.fm_index;
+  auto const search_states = prg.indexed_search_states();
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<Marker> pick_base(1, 4);
+  std::vector<std::pair<SA_Interval, Marker>> queries;
+  for (auto const &search_state : search_states)
+    queries.push_back({search_state.sa_interval, pick_base(rng)});
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto const &query = queries[i++ % queries.size()];
+    SA_Index const first_sa_index =
+        fm_index.C[fm_index.char2comp[query.second]];
+    benchmark::DoNotOptimize(base_next_sa_interval(
+        query.second, first_sa_index, query.first, prg.prg_info));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_base_next_sa_interval)->Apply(prg_shapes);
@@ -0,0 +1,36 @@
+#include "genotype/quasimap/quasimap.hpp"
+#include "genotype/quasimap/search/encapsulated_search.hpp"
+#include "prg_shapes.hpp"
+
+using namespace gram;
+using namespace gram::bench;
+
+/**
+ * Runs on the `SearchStates` of whole reads, as `search_read_backwards` has
+ * them right before handing them to `handle_allele_encapsulated_states`.
+ */
+static void BM_handle_allele_encapsulated_states(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  auto const kmer_size = prg.parameters.kmers_size;
+  std::vector<SearchStates> reads_search_states;
+  for (auto const &read : prg.reads) {
+    auto search_states =
+        prg.kmer_index.at(get_last_kmer_in_read(kmer_size, read));
+    for (auto it = read.rbegin() + kmer_size;
+         it != read.rend() && !search_states.empty(); ++it)
+      search_states =
+          process_read_char_search_states(*it, search_states, prg.prg_info);
+    if (!search_states.empty())
+      reads_search_states.push_back(std::move(search_states));
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto const &search_states =
+        reads_search_states[i++ % reads_search_states.size()];
+    benchmark::DoNotOptimize(
+        handle_allele_encapsulated_states(search_states, prg.prg_info));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_handle_allele_encapsulated_states)->Apply(prg_shapes);
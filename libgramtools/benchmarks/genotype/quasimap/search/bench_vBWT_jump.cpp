@@ -0,0 +1,40 @@
+#include "genotype/quasimap/search/vBWT_jump.hpp"
+#include "prg_shapes.hpp"
+
+using namespace gram;
+using namespace gram::bench;
+
+/**
+ * Runs over the `SearchStates` of indexed kmers, which is where site and
+ * allele markers preceding a match get found during read mapping.
+ * The copy of each kmer's `SearchStates` is timed too, as
+ * `process_markers_search_states` modifies them in place.
+ */
+static void BM_process_markers_search_states(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  std::vector<SearchStates> kmers_search_states;
+  for (auto const &entry : prg.kmer_index)
+    kmers_search_states.push_back(entry.second);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto search_states = kmers_search_states[i++ % kmers_search_states.size()];
+    process_markers_search_states(search_states, prg.prg_info);
+    benchmark::DoNotOptimize(search_states);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_process_markers_search_states)->Apply(prg_shapes);
+
+static void BM_left_markers_search(benchmark::State &state) {
+  auto const &prg = get_prg(state);
+  auto const search_states = prg.indexed_search_states();
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto const &search_state = search_states[i++ % search_states.size()];
+    benchmark::DoNotOptimize(left_markers_search(search_state, prg.prg_info));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_left_markers_search)->Apply(prg_shapes);
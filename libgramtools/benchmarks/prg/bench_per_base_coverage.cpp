@@ -0,0 +1,62 @@
+/**
+ * @file Benchmarks recording per base coverage, as done during quasimapping:
+ * many threads incrementing counters of a `PbCovStore` at random positions.
+ * Reports increment throughput and the memory used by the counters, for the
+ * counter width gramtools was built with (`-DPB_COV_COUNTER_BITS`).
+ *
+ * Coverage depth is drawn per base from an exponential distribution, so that
+ * a few bases get much more coverage than the mean, as in repeats.
+ */
+#include <benchmark/benchmark.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <random>
+
+#include "prg/per_base_coverage.hpp"
+
+using namespace gram;
+
+static std::vector<std::size_t> increment_positions(std::size_t num_bases,
+                                                    double mean_depth) {
+  std::mt19937 rng(42);
+  std::exponential_distribution<double> depth_distrib(1 / mean_depth);
+  std::vector<std::size_t> positions;
+  for (std::size_t base{0}; base < num_bases; ++base) {
+    auto const depth = static_cast<std::size_t>(depth_distrib(rng));
+    positions.insert(positions.end(), depth, base);
+  }
+  std::shuffle(positions.begin(), positions.end(), rng);
+  return positions;
+}
+
+/** Args: number of bases, mean depth, threads */
+static void BM_PbCovStore_increment(benchmark::State &state) {
+  auto const num_bases = static_cast<std::size_t>(state.range(0));
+  auto const positions = increment_positions(num_bases, state.range(1));
+  int const num_threads = state.range(2);
+
+  std::size_t num_overflow_counters{0}, memory_usage{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    PbCovStore store;
+    store.allocate(num_bases);
+    state.ResumeTiming();
+#pragma omp parallel for num_threads(num_threads)
+    for (std::size_t i = 0; i < positions.size(); ++i)
+      store.increment(positions[i]);
+    num_overflow_counters = store.num_overflow_counters();
+    memory_usage = store.memory_usage();
+  }
+  state.SetItemsProcessed(state.iterations() * positions.size());
+  state.SetLabel("counter_bits:" + std::to_string(PB_COV_COUNTER_BITS));
+  state.counters["overflow_counters"] = num_overflow_counters;
+  state.counters["memory_bytes"] = memory_usage;
+}
+BENCHMARK(BM_PbCovStore_increment)
+    ->ArgNames({"bases", "depth", "threads"})
+    ->Args({1 << 16, 30, 1})
+    ->Args({1 << 16, 30, 4})
+    ->Args({1 << 16, 300, 1})
+    ->Args({1 << 16, 300, 4})
+    ->UseRealTime();
@@ -2,6 +2,7 @@
 #define GRAMTOOLS_DATA_TYPES_HPP
 
 #include <cstdint>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -29,6 +30,10 @@ using AlleleIdSet = std::set<AlleleId>;
 using VariantLocus =
     std::pair<Marker, AlleleId>; /**< A Variant site/`AlleleId` combination.*/
 
+// Random seeding
+using SeedSize = uint32_t;
+using Seed = std::optional<SeedSize>; /**< Random if not set */
+
 // BWT-related
 using WaveletTree = sdsl::wt_int<sdsl::bit_vector, sdsl::rank_support_v5<>>;
 using FM_Index =
@@ -49,7 +54,7 @@ struct DNA_BWT_Masks {
 };
 
 // coverage-related
-using CovCount = uint16_t;
+using CovCount = uint32_t;
 using PerBaseCoverage = std::vector<CovCount>;   /**< Number of reads mapped to
                                                     each base of an allele */
 using PerAlleleCoverage = std::vector<CovCount>; /**< Number of reads mapped to
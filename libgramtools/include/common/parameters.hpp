@@ -41,6 +41,7 @@ class CommonParameters {
   std::string prg_coords_fpath;
   std::string fm_index_fpath;
   std::string cov_graph_fpath;
+  std::string site_ends_fpath;
   std::string sites_mask_fpath;
   std::string allele_mask_fpath;
 
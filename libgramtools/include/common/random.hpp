@@ -16,12 +16,6 @@ class RandomGenerator {
   virtual ~RandomGenerator(){};
 
   virtual uint32_t generate(uint32_t min, uint32_t max) = 0;
-
-  SeedSize operator()() { return random_number_generator(); }
-
- protected:
-  std::mt19937
-      random_number_generator;  // 32-bit unsigned random number generator
 };
 
 class RandomInclusiveInt : public RandomGenerator {
@@ -33,9 +27,36 @@ class RandomInclusiveInt : public RandomGenerator {
   uint32_t generate(uint32_t min, uint32_t max) override;
   Seed const& get_seed() const { return seed; }
 
+  SeedSize operator()() { return random_number_generator(); }
+
  private:
   Seed seed = std::nullopt;
+  std::mt19937
+      random_number_generator;  // 32-bit unsigned random number generator
 };
+
+/**
+ * Counter-based generator: the `i`-th number drawn is a function of `key` and
+ * `i` only, rather than of a state updated at each draw. Constructing one is
+ * just storing its key, and the numbers drawn for a key do not depend on which
+ * thread draws them, nor on the order keys get used in.
+ */
+class CounterRandomInt : public RandomGenerator {
+ public:
+  explicit CounterRandomInt(SelectionKey const key) : key(key) {}
+
+  uint32_t generate(uint32_t min, uint32_t max) override;
+
+ private:
+  SelectionKey key;
+  uint64_t num_draws = 0;
+};
+
+/**
+ * The key of the `counter`-th item of stream `stream`, off `seed`: eg, of the
+ * `counter`-th read of the `stream`-th reads file.
+ */
+SelectionKey derive_key(SeedSize seed, uint64_t stream, uint64_t counter);
 }  // namespace gram
 
 #endif  // GRAMTOOLS_RANDOM_HPP
@@ -6,6 +6,10 @@
 
 using namespace gram;
 
+namespace gram {
+constexpr std::size_t DEFAULT_MAX_ALLELE_COMBINATIONS{10000};
+}
+
 namespace gram::genotype::infer {
 
 /**
@@ -14,6 +18,40 @@ namespace gram::genotype::infer {
  */
 Allele extract_ref_allele(covG_ptr start_node, covG_ptr end_node);
 
+/**
+ * Cartesian product of the alleles of a haplogroup, built up segment by
+ * segment. Each segment holds the choices for one stretch of the haplogroup:
+ * a single allele for sequence common to the haplogroup, or the relevant
+ * alleles of a nested site. Combined alleles are only materialised once the
+ * haplogroup is fully scanned, rather than after each nested site, in the
+ * order in which successive eager combinations would have produced them (last
+ * segment varying fastest).
+ */
+class AlleleProduct {
+ private:
+  std::vector<allele_vector> segments;
+  std::size_t num_combinations;
+
+  /** Decomposes `index` into one choice per segment */
+  std::vector<std::size_t> get_choices(std::size_t index) const;
+
+ public:
+  explicit AlleleProduct(allele_vector const& initial_alleles)
+      : segments{initial_alleles}, num_combinations(initial_alleles.size()) {}
+
+  std::size_t size() const { return num_combinations; }
+
+  /** Appends `allele` to every combination */
+  void paste(Allele const& allele);
+
+  /** Multiplies the combinations by `alleles` */
+  void combine(allele_vector const& alleles);
+
+  Allele at(std::size_t index) const;
+
+  allele_vector materialise() const;
+};
+
 /**
  * Class in charge of producing the set of `Allele`s that get genotyped.
  * The procedure scans through each haplogroup of a site, pasting sequence &
@@ -23,16 +61,29 @@ class AlleleExtracter {
  private:
   allele_vector alleles;
   gt_sites const* genotyped_sites;
+  std::size_t max_combinations = DEFAULT_MAX_ALLELE_COMBINATIONS;
+  std::size_t num_dropped_alleles{0};
 
  public:
   AlleleExtracter() : genotyped_sites(nullptr){};
 
-  AlleleExtracter(covG_ptr site_start, covG_ptr site_end, gt_sites& sites);
+  AlleleExtracter(
+      covG_ptr site_start, covG_ptr site_end, gt_sites& sites,
+      std::size_t max_combinations = DEFAULT_MAX_ALLELE_COMBINATIONS);
 
-  AlleleExtracter(gt_sites& sites) : genotyped_sites(&sites) {}
+  AlleleExtracter(
+      gt_sites& sites,
+      std::size_t max_combinations = DEFAULT_MAX_ALLELE_COMBINATIONS)
+      : genotyped_sites(&sites), max_combinations(max_combinations) {}
 
   allele_vector const get_alleles() const { return alleles; }
 
+  /**
+   * Number of nested site alleles left out of combinations to stay within
+   * the maximum number of combinations per haplogroup.
+   */
+  std::size_t get_num_dropped_alleles() const { return num_dropped_alleles; }
+
   void place_ref_as_first_allele(allele_vector& alleles, Allele ref_allele);
 
   /**
@@ -45,21 +96,21 @@ class AlleleExtracter {
 
   /**
    * From the set of genotypes of a site, combines them with existing alleles.
-   * @param existing the starting alleles
+   * If the number of combinations would exceed the maximum, the site's extra
+   * alleles then its genotyped alleles get dropped, from the last one, and
+   * counted in `num_dropped_alleles`.
+   * @param existing the starting alleles, combined in place
    * @param site_index the previously genotyped site
-   * @return Cartesian product of `existing` and distinct genotyped alleles
    */
-  allele_vector allele_combine(allele_vector const& existing,
-                               std::size_t site_index);
+  void allele_combine(AlleleProduct& existing, std::size_t site_index);
 
   /**
    * From a set of existing alleles, paste sequence and pb coverage to the end
    * of each of them. This deals with a node common to a haplogroup.
-   * @param existing the starting alleles
+   * @param existing the starting alleles, modified in place
    * @param sequence_node  the haplogroup common node
-   * @return void because `existing` is modified in place
    */
-  void allele_paste(allele_vector& existing, covG_ptr sequence_node);
+  void allele_paste(AlleleProduct& existing, covG_ptr sequence_node);
 };
 }  // namespace gram::genotype::infer
 
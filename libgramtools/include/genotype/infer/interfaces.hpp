@@ -63,7 +63,9 @@ class GenotypedSite {
   GenotypedSite() = default;
   virtual ~GenotypedSite(){};
 
-  gtype_information get_all_gtype_info() const { return this->gtype_info; }
+  gtype_information const& get_all_gtype_info() const {
+    return this->gtype_info;
+  }
   void populate_site(gtype_information const& gtype_info);
   GtypedIndices const get_genotype() const { return gtype_info.genotype; }
   allele_vector const get_alleles() const { return gtype_info.alleles; }
@@ -137,6 +139,7 @@ class Genotyper {
   coverage_Graph const* cov_graph;
   SitesGroupedAlleleCounts const* gped_covs;
   child_map child_m;
+  SiteSelection site_selection;
 
   Genotyper() : cov_graph(nullptr), gped_covs(nullptr) {}
   Genotyper(gt_sites const& sites, child_map const& ch)
@@ -151,6 +154,9 @@ class Genotyper {
   gt_sites const& get_genotyped_records() const { return genotyped_records; }
   auto const& get_cov_g() const { return cov_graph; }
   auto const& get_child_m() const { return child_m; }
+  bool is_selected(std::size_t site_index) const {
+    return site_selection.empty() || site_selection.at(site_index);
+  }
 
   virtual header_vec get_model_specific_headers() = 0;
 };
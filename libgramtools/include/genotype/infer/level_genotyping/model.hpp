@@ -21,6 +21,22 @@ using likelihood_map = std::multimap<double, GtypedIndices, std::greater<>>;
 using memoised_coverages = std::map<AlleleIds, allele_coverages>;
 using CovPair = std::pair<double, double>;
 
+/**
+ * Log-likelihood contributions of an allele's own per-base coverage, which do
+ * not depend on the genotype the allele is part of.
+ */
+struct AlleleLikelihoodTerms {
+  double coverage_term; /**< log-pmf of the allele's average coverage */
+  double gap_term;      /**< penalty for non-credible coverage positions */
+};
+
+/** A scored heterozygous genotype awaiting insertion into the likelihoods */
+struct GenotypeCandidate {
+  double log_likelihood;
+  std::size_t order;  // Scoring order, used to reproduce likelihood map ties
+  GtypedIndices gtype;
+};
+
 using namespace probabilities;
 
 struct ModelData {
@@ -59,7 +75,11 @@ class LevelGenotyperModel : GenotypingModel {
   PerAlleleCoverage singleton_allele_coverages; /**< Coverage counts unique to
                                                    single alleles */
   memoised_coverages computed_coverages;
+  /** Of each allele, so that the pmfs get looked up once per allele */
+  std::vector<AlleleLikelihoodTerms> allele_terms;
   std::size_t total_coverage;
+  std::size_t num_pruned_genotypes{0}; /**< Heterozygous genotypes not stored
+                                          as they cannot be called */
 
   // Computed at run time
   likelihood_map likelihoods;  // Stores highest likelihoods first
@@ -101,12 +121,24 @@ class LevelGenotyperModel : GenotypingModel {
    */
   double fraction_noncredible_positions(Allele const &allele);
 
+  AlleleLikelihoodTerms get_likelihood_terms(Allele const &allele);
+
+  /** Fills `allele_terms`, before any likelihood gets computed */
+  void set_likelihood_terms(allele_vector const &input_alleles);
+
+  /**
+   * Log-likelihood of a genotype, from its incompatible coverage and the
+   * terms of each of its alleles.
+   */
+  double compute_log_likelihood(
+      double const &incompatible_coverage,
+      std::vector<AlleleLikelihoodTerms> const &allele_terms) const;
+
   /**
    * Computes log-likelihood of allelic coverage and stores it.
    * Handles haploid and diploid flexibly.
    */
-  void add_likelihood(allele_vector const &alleles,
-                      double const &incompatible_coverage,
+  void add_likelihood(double const &incompatible_coverage,
                       GtypedIndices const &allele_indices);
 
   /**
@@ -125,6 +157,13 @@ class LevelGenotyperModel : GenotypingModel {
    * Diploid. Because of the large possible number of diploid combinations,
    * (eg for 10 alleles, 45), we only consider for combination those alleles
    * that have at least one unit of coverage unique to them.
+   *
+   * Only genotypes that can still be called, or be the next best genotype to
+   * the called one, are stored: those ranking above the second best
+   * nesting-consistent genotype found so far. Scored candidates are kept in a
+   * heap that is trimmed each time that genotype improves, and allele
+   * pairs whose likelihood upper bound (obtained from their haploid coverages)
+   * does not beat it are not scored at all.
    */
   void compute_heterozygous_log_likelihoods(
       allele_vector const &input_alleles,
@@ -200,6 +239,7 @@ class LevelGenotyperModel : GenotypingModel {
     return singleton_allele_coverages;
   }
   likelihood_map const &get_likelihoods() const { return likelihoods; }
+  std::size_t get_num_pruned_genotypes() const { return num_pruned_genotypes; }
 
   gt_site_ptr get_site() override {
     return std::static_pointer_cast<gt_site>(genotyped_site);
@@ -1,7 +1,6 @@
 #ifndef GRAMTOOLS_PROBS_HPP
 #define GRAMTOOLS_PROBS_HPP
 
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -9,23 +8,40 @@
 
 namespace gram::genotype::infer::probabilities {
 using params = std::vector<double>;
-using memoised_params = std::map<params, double>;
+using tabulated_probs = std::vector<double>;
 
+/** Bounds on the number of integer coverages for which log-probabilities are
+ * precomputed */
+constexpr std::size_t min_tabulated_covs{1024};
+constexpr std::size_t max_tabulated_covs{1 << 20};
+
+/**
+ * Log-probability mass function over coverage.
+ * Probabilities for integer coverages in [0, `probs.size()`) are precomputed
+ * into a dense table at construction, so that lookups on the hot genotyping
+ * path neither allocate nor lock, and a single pmf can be shared read-only
+ * across threads. Other coverages, notably the fractional average coverages
+ * of alleles, are computed in closed form: the genotyping model looks those
+ * up once per allele of a site, before its likelihood loops.
+ */
 class AbstractPmf {
  protected:
   AbstractPmf() = default;
-  memoised_params probs;  // Memoised probabilities
-  virtual double compute_prob(params const& query) const = 0;
+  tabulated_probs probs;  // Precomputed probabilities
+  virtual double compute_prob(double const cov) const = 0;
 
  public:
   virtual ~AbstractPmf() = default;
-  double operator()(params const& query);
-  memoised_params const& get_probs() const { return probs; }
+  /** Precompute probabilities for integer coverages 0 to `max_cov`
+   * (inclusive) */
+  void tabulate(std::size_t const max_cov);
+  double operator()(double const cov) const;
+  tabulated_probs const& get_probs() const { return probs; }
 };
 
 class PoissonLogPmf : public AbstractPmf {
   double lambda;
-  double compute_prob(params const& query) const override;
+  double compute_prob(double const cov) const override;
 
  public:
   PoissonLogPmf() : lambda(0) {}
@@ -35,7 +51,7 @@ class PoissonLogPmf : public AbstractPmf {
 class NegBinomLogPmf : public AbstractPmf {
   // k: number of successes; p: probability of success
   double k, p;
-  double compute_prob(params const& query) const override;
+  double compute_prob(double const cov) const override;
 
  public:
   explicit NegBinomLogPmf(params const& parameterisation);
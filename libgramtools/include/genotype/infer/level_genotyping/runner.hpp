@@ -13,6 +13,7 @@
 
 #define CONF_DISTRIB_SIZE 10000
 
+#include "genotype/infer/allele_extracter.hpp"
 #include "genotype/parameters.hpp"
 #include "probabilities.hpp"
 #include "site.hpp"
@@ -31,19 +32,31 @@ using lvlgt_site_ptr = std::shared_ptr<LevelGenotypedSite>;
 class LevelGenotyper : public Genotyper {
   likelihood_related_stats l_stats;
   Ploidy ploidy;
+  std::size_t num_dropped_alleles{0}; /**< Nested site alleles left out of
+                                         allele extraction */
 
  public:
   LevelGenotyper() = default;
   LevelGenotyper(child_map const& ch, gt_sites const& sites)
       : Genotyper(sites, ch) {}
 
+  /**
+   * Genotypes each site of `cov_graph`, in most nested to least nested order.
+   * @param selection if not empty, only the sites flagged in it get genotyped
+   * and output. It must contain all the sites nested in selected sites.
+   */
   LevelGenotyper(coverage_Graph const& cov_graph,
                  SitesGroupedAlleleCounts const& gped_covs,
                  ReadStats const& read_stats, Ploidy ploidy,
-                 bool get_gcp = false, std::string debug_fpath = "");
+                 bool get_gcp = false, std::string debug_fpath = "",
+                 std::size_t max_allele_combinations =
+                     DEFAULT_MAX_ALLELE_COMBINATIONS,
+                 SiteSelection const& selection = {});
 
   header_vec get_model_specific_headers() override;
 
+  std::size_t get_num_dropped_alleles() const { return num_dropped_alleles; }
+
   void uppropagate_filter(std::string const& name,
                           Marker const& parent_site_ID);
   void downpropagate_filter(std::string const& name,
@@ -0,0 +1,63 @@
+/** @file
+ * Combining JSON genotyped PRGs of several samples into one.
+ * All inputs must come from the same PRG, so they share the same sites in the
+ * same order: sites are streamed from all inputs together and combined in
+ * chunks across threads, and the combined JSON gets written as it goes.
+ */
+#ifndef PRG_JSON_COMBINE
+#define PRG_JSON_COMBINE
+
+#include <istream>
+#include <ostream>
+
+#include "fields.hpp"
+
+namespace gram::json {
+
+struct combine_params {
+  std::size_t chunk_size = 256; /**< Number of sites read from each input at a
+                                   time */
+  std::size_t max_inputs_per_merge = 0; /**< Above this many inputs, combine
+                                           hierarchically. 0 means no limit */
+  bool force = false; /**< Rename duplicate sample names instead of failing */
+};
+
+/**
+ * Combines the entries other than "Sites" of several JSON PRGs.
+ */
+JSON combine_headers(std::vector<JSON> const& headers, bool force = false);
+
+/**
+ * Combines the same site across several JSON PRGs, in input order.
+ * The combined site's alleles are the 'reference' allele followed by all
+ * called alleles, in order of first call.
+ * Each called sample keeps its coverage on all of those it had itself.
+ * @param sites consumed by the combination.
+ * @param keep_uncalled_alleles if set, alleles called in no sample are kept
+ * after the called ones. Intermediate results of a hierarchical merge need
+ * this so that the final merge is the same as a flat one.
+ */
+JSON combine_sites(std::vector<JSON>& sites, std::string const& gtyping_model,
+                   bool keep_uncalled_alleles = false);
+
+/**
+ * Combines JSON PRGs streamed from `inputs` into one written to `out`.
+ * Memory use grows with the number of inputs and `params.chunk_size`, not with
+ * the number of sites.
+ */
+void combine_jsons(std::vector<std::istream*> const& inputs, std::ostream& out,
+                   combine_params const& params,
+                   bool keep_uncalled_alleles = false);
+
+/**
+ * Combines JSON PRG files into `out_fpath`.
+ * If there are more inputs than `params.max_inputs_per_merge`, they are
+ * combined in groups of that size into temporary files next to `out_fpath`,
+ * repeatedly, until few enough remain; the result is the same as combining all
+ * inputs at once.
+ */
+void combine_json_files(strings const& fpaths, std::string const& out_fpath,
+                        combine_params const& params);
+}  // namespace gram::json
+
+#endif  // PRG_JSON_COMBINE
@@ -17,6 +17,18 @@ class Json_Prg {
   explicit Json_Prg(JSON input_json);
   void add_samples(Json_Prg& other, bool force = false);
   void combine_with(Json_Prg& other, bool force = false);
+
+  /**
+   * Throws if two JSONs cannot be combined: they must come from the same PRG
+   * and genotyping model. Only checks the entries other than "Sites".
+   */
+  static void check_combinable(JSON const& first, JSON const& second);
+  /**
+   * Appends `other_samples` to `samples`. Duplicate sample names throw, unless
+   * `force` is set, in which case they get renamed.
+   */
+  static void append_samples(JSON& samples, JSON other_samples,
+                             bool force = false);
   void set_sample_info(std::string const& name, std::string const& desc);
 
   void add_site(json_site_ptr const& json_site);
@@ -0,0 +1,76 @@
+/** @file
+ * Reading and writing JSON genotyped PRGs one site at a time, so that memory
+ * use does not grow with the number of sites.
+ */
+#ifndef PRG_JSON_STREAM
+#define PRG_JSON_STREAM
+
+#include <istream>
+#include <ostream>
+
+#include "fields.hpp"
+
+namespace gram::json {
+
+class JSONParseException : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * Reads a JSON PRG one site at a time.
+ * All top-level entries other than "Sites" are loaded on construction, and
+ * make up the header. Sites are then parsed on request.
+ */
+class Json_Prg_Reader {
+ private:
+  std::istream& in;
+  JSON header;
+  bool first_site;
+  bool sites_exhausted;
+
+  /**
+   * True if all the entries the JSON PRG spec expects before "Sites" have been
+   * read; if not, the rest of the document must be scanned for them.
+   */
+  bool header_is_complete() const;
+
+ public:
+  /**
+   * @param in must support seeking if "Sites" is not the last entry of the
+   * document, as for eg `std::ifstream` or `std::stringstream`.
+   */
+  explicit Json_Prg_Reader(std::istream& in);
+
+  JSON const& get_header() const { return header; }
+
+  /**
+   * Parses the next site into `site`.
+   * @return false if there are no more sites to read.
+   */
+  bool next_site(JSON& site);
+};
+
+/**
+ * Writes a JSON PRG one site at a time.
+ * The header is written on construction, and "Sites" is written as the last
+ * entry of the document, as nlohmann::json does with its sorted keys.
+ */
+class Json_Prg_Writer {
+ private:
+  std::ostream& out;
+  bool first_site;
+
+ public:
+  /**
+   * @param header JSON PRG whose entries other than "Sites" get written.
+   */
+  Json_Prg_Writer(std::ostream& out, JSON header);
+
+  void add_site(JSON const& site);
+
+  /** Ends the document; call once all sites have been added. */
+  void close() { out << "]}"; }
+};
+}  // namespace gram::json
+
+#endif  // PRG_JSON_STREAM
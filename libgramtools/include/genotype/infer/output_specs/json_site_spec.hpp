@@ -25,11 +25,17 @@ class Json_Site {
     json_site.emplace("SEG", "");
   }
 
-  Json_Site(JSON const input_json) : json_site(input_json) {}
+  Json_Site(JSON input_json) : json_site(std::move(input_json)) {}
 
   // ____Functions implementing site combining____
-  void build_allele_combi_map(JSON const &json_site, allele_combi_map &m);
-  allele_vec get_all_alleles(allele_combi_map &m);
+  /**
+   * Throws if the two sites cannot be combined, ie if they are not at the same
+   * position or do not share the same 'reference' allele.
+   */
+  static void check_combinable(JSON const &first, JSON const &second);
+  static void build_allele_combi_map(JSON const &json_site,
+                                     allele_combi_map &m);
+  static allele_vec get_all_alleles(allele_combi_map const &m);
   void rescale_entries(allele_combi_map const &m);
   void append_trivial_entries_from(JSON const &input_site);
   void add_model_specific_entries_from(JSON const &input_site,
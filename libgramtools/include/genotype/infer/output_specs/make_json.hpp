@@ -16,6 +16,15 @@ class SegmentTracker;
 
 json_prg_ptr make_json_prg(gtyper_ptr const& gtyper, SegmentTracker& tracker);
 
+/**
+ * Writes the genotyped PRG as JSON to `out`, one site at a time, without
+ * building the whole document in memory. The output is the same as
+ * serialising the `Json_Prg` from `make_json_prg` with the sample info set.
+ */
+void write_json_prg(std::ostream& out, gtyper_ptr const& gtyper,
+                    SegmentTracker& tracker, std::string const& sample_name,
+                    std::string const& sample_desc);
+
 /**
  * Populates the PRG-related entries (Lvl1_sites, child map) of a Json_Prg
  * class.
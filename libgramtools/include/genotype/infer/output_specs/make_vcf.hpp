@@ -10,6 +10,15 @@
 using namespace gram::genotype;
 using namespace gram::genotype::infer;
 
+/** Number of vcf records formatted in parallel before being written out */
+#define VCF_RECORDS_CHUNK_SIZE 4096
+
+/**
+ * Minimum interval size of the CSI index built alongside the vcf (as in
+ * `bcftools index`)
+ */
+#define VCF_CSI_MIN_SHIFT 14
+
 namespace gram::genotype {
 class SegmentTracker;
 }
@@ -23,6 +32,11 @@ class VcfWriteException : public std::exception {
   virtual char const *what() const throw() { return msg.c_str(); }
 };
 
+/**
+ * Writes the bgzipped vcf and its CSI index, in one pass.
+ * Records are formatted in parallel in chunks and compressed using
+ * `params.maximum_threads` threads.
+ */
 void write_vcf(gram::GenotypeParams const &params, gtyper_ptr const &gtyper,
                SegmentTracker &tracker);
 void populate_vcf_hdr(bcf_hdr_t *hdr, gtyper_ptr gtyper,
@@ -31,7 +45,12 @@ void populate_vcf_hdr(bcf_hdr_t *hdr, gtyper_ptr gtyper,
 
 void write_sites(htsFile *fout, bcf_hdr_t *header, gtyper_ptr const &gtyper,
                  SegmentTracker &tracker);
-void populate_vcf_site(bcf_hdr_t *header, bcf1_t *record, gt_site_ptr site,
-                       SegmentTracker &tracker);
+/**
+ * @param contig_id numeric ID of the site's segment in the vcf header
+ * @param pos 0-based position of the site in its segment
+ */
+void populate_vcf_site(bcf_hdr_t *header, bcf1_t *record,
+                       gt_site_ptr const &site, int32_t contig_id,
+                       std::size_t pos);
 
 #endif  // MAKE_VCF_HPP
@@ -80,6 +80,12 @@ using GtypedIndex =
 using GtypedIndices = std::vector<GtypedIndex>;
 using allele_coverages = std::vector<double>;
 
+/**
+ * One flag per site index, set for the sites to genotype and output. Empty
+ * means all sites.
+ */
+using SiteSelection = std::vector<bool>;
+
 }  // namespace gram::genotype::infer
 
 #endif  // GT_INFER_TYPES
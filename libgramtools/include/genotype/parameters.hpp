@@ -6,13 +6,21 @@
 #ifndef GRAMTOOLS_QUASIMAP_PARAMETERS_HPP
 #define GRAMTOOLS_QUASIMAP_PARAMETERS_HPP
 
+#include "common/data_types.hpp"
 #include "common/parameters.hpp"
+#include "genotype/infer/allele_extracter.hpp"
+#include "genotype/quasimap/progress.hpp"
+#include "genotype/quasimap/read_cache.hpp"
+#include "genotype/quasimap/search/approximate_search.hpp"
 
 namespace gram {
 enum class Ploidy { Haploid, Diploid };
-using SeedSize = uint32_t;
-using Seed = std::optional<SeedSize>;
-using Seeds = std::vector<SeedSize>;
+/** Where in a read vBWT search starts from */
+enum class SearchMode { Backward, SeedExtend };
+/** Keys the random selection among the mappings of one read */
+using SelectionKey = uint64_t;
+/** Checkpoints cost a write of all coverage, so are only written if asked */
+constexpr uint32_t DEFAULT_CHECKPOINT_SECONDS{0};
 
 class GenotypeParams : public CommonParameters {
  public:
@@ -21,6 +29,10 @@ class GenotypeParams : public CommonParameters {
   std::string allele_sum_coverage_fpath;
   std::string allele_base_coverage_fpath;
   std::string grouped_allele_counts_fpath;
+  std::string coverage_fpath;
+  std::string partial_coverage_fpath;
+  std::string checkpoint_fpath;
+  std::string progress_fpath; /**< If not empty, gets mapping progress */
   std::string read_stats_fpath;
 
   Ploidy ploidy;
@@ -32,6 +44,29 @@ class GenotypeParams : public CommonParameters {
   std::string debug_fpath;
 
   Seed seed = std::nullopt;
+  std::size_t max_allele_combinations = DEFAULT_MAX_ALLELE_COMBINATIONS;
+  std::string regions_fpath; /**< BED file; if empty, genotype all sites */
+  std::size_t read_cache_size =
+      DEFAULT_READ_CACHE_SIZE; /**< Max reads with cached mappings; 0
+                                  disables the cache */
+  SearchMode search_mode = SearchMode::Backward;
+  uint32_t max_mismatches = 0; /**< 0 only maps reads exactly */
+  std::size_t max_search_states =
+      DEFAULT_MAX_SEARCH_STATES; /**< Per read, in inexact search */
+  bool quasimap_only = false; /**< Write partial coverage; do not genotype */
+  std::vector<std::string> merge_coverage_fpaths; /**< Partial coverage files
+                                                     genotyped instead of
+                                                     reads */
+  bool compress_coverage = false; /**< gzip the coverage file */
+  bool no_coverage_json = false; /**< Skip the legacy JSON coverage files */
+  uint32_t checkpoint_seconds =
+      DEFAULT_CHECKPOINT_SECONDS; /**< Between quasimap checkpoints; 0 writes
+                                     none */
+  bool resume = false; /**< Restart mapping from the last checkpoint */
+  uint32_t progress_seconds =
+      DEFAULT_PROGRESS_SECONDS; /**< Between progress reports; 0 only
+                                   reports to `progress_fpath`, when mapping
+                                   ends */
 };
 
 namespace commands::genotype {
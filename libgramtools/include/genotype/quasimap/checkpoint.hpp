@@ -0,0 +1,68 @@
+/** @file
+ * Checkpoints of read mapping, so that a long quasimap run that gets killed
+ * can resume from where it got to rather than from scratch.
+ *
+ * A checkpoint holds everything that mapping the rest of the reads depends
+ * on: coverage (including per base coverage), read counts, the master seed of
+ * read selection, and how many reads of each reads file got mapped along with
+ * their recorded statistics. It also records the options that change how
+ * reads map, which resuming must not change. Resuming from it thus gives
+ * the same coverage as an uninterrupted run; only statistics about the run
+ * itself (read cache hits, batches, timings) can differ.
+ */
+#ifndef GRAMTOOLS_CHECKPOINT_HPP
+#define GRAMTOOLS_CHECKPOINT_HPP
+
+#include "common/random.hpp"
+#include "genotype/quasimap/quasimap.hpp"
+
+namespace gram {
+/** Bumped whenever the checkpoint file contents change */
+constexpr uint32_t CHECKPOINT_VERSION{3};
+
+/**
+ * Writes checkpoints of a quasimap run, at most every
+ * `parameters.checkpoint_seconds` (never if 0).
+ * Checkpoints are written to a temporary file, then renamed over the previous
+ * one, so that being killed while writing one leaves the previous one usable.
+ */
+class Checkpointer {
+ public:
+  Checkpointer(GenotypeParams const &parameters, PRG_Info const &prg_info,
+               SeedSize const &master_seed);
+
+  /** Whether enough time has passed since the last checkpoint for another */
+  bool due() const;
+
+  /**
+   * Writes a checkpoint of mapping the reads `progress` got through. No
+   * mapping must be in progress, and no reads past those must have been
+   * loaded.
+   */
+  void write(QuasimapReadsStats const &quasimap_stats,
+             ReadsProgress const &progress);
+
+ private:
+  GenotypeParams const &parameters;
+  PRG_Info const &prg_info;
+  SeedSize const master_seed;
+  double last_write_time;
+};
+
+/**
+ * Restores the state of a quasimap run from the checkpoint at
+ * `parameters.checkpoint_fpath` into `quasimap_stats` (whose coverage must be
+ * empty), the per base coverage of `prg_info`'s coverage graph and
+ * `seed_generator`, which gets the checkpoint's master seed.
+ * Throws if the checkpoint was written for other reads files, another prg,
+ * another seed than `parameters.seed` (if given), or other mapping options:
+ * kmer size, search mode, maximum mismatches or search states, or regions.
+ * @return where mapping got to.
+ */
+ReadsProgress load_checkpoint(GenotypeParams const &parameters,
+                              PRG_Info const &prg_info,
+                              QuasimapReadsStats &quasimap_stats,
+                              RandomInclusiveInt &seed_generator);
+}  // namespace gram
+
+#endif  // GRAMTOOLS_CHECKPOINT_HPP
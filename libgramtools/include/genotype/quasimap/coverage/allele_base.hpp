@@ -15,6 +15,10 @@
 namespace gram {
 
 namespace coverage {
+namespace per_base {
+class DummyCovNodes;
+}
+
 namespace generate {
 /**
  * Produces base-level coverage recording structure and populates it with
@@ -30,15 +34,17 @@ namespace record {
  * Record base-level coverage for selected `SearchStates`.
  * `SearchStates`, can have different mapping instances going through the same
  * `VariantLocus`.
+ * @param dummy_cov_nodes if given, scratch space reused across calls.
  */
 void allele_base(PRG_Info const& prg_info, SearchStates const& search_states,
-                 uint64_t const& read_length);
+                 uint64_t const& read_length,
+                 per_base::DummyCovNodes* const dummy_cov_nodes = nullptr);
 }  // namespace record
 
 namespace dump {
 /**
- * String serialise the coverage information in JSON format and write it to
- * disk.
+ * String serialise the coverage information in the legacy JSON format and
+ * write it to disk.
  */
 void allele_base(const Coverage& coverage, const GenotypeParams& parameters);
 }  // namespace dump
@@ -121,6 +127,30 @@ class DummyCovNode {
  */
 using realCov_to_dummyCov = std::map<covG_ptr, DummyCovNode>;
 
+/**
+ * Set of `DummyCovNode`s keyed by the cov ID of their `coverage_Node`,
+ * reused across reads. Lookups index flat arrays, and clearing is constant
+ * time: slots from previous reads are told apart by their generation.
+ * Attached nodes must be attached to the same `PbCovStore`, so that cov IDs are
+ * unique; nodes not attached to any are keyed by address instead.
+ */
+class DummyCovNodes {
+ public:
+  using entry = std::pair<covG_ptr, DummyCovNode>;
+
+  void clear();
+  /** @return nullptr if `node` has no `DummyCovNode` since the last clear */
+  DummyCovNode* find(covG_ptr const& node);
+  void insert(covG_ptr const& node, DummyCovNode const& dummy_node);
+  std::vector<entry> const& get_entries() const { return entries; }
+
+ private:
+  std::vector<uint32_t> generations;
+  std::vector<uint32_t> entry_indices;
+  uint32_t generation{1};
+  std::vector<entry> entries;
+};
+
 /**
  * Class which produces all coverage node from the coverage graph that are in
  * variant sites. The choice of nodes at fork points is made using the set of
@@ -134,8 +164,9 @@ class Traverser {
  public:
   Traverser() {}
 
-  Traverser(node_access start_point, VariantSitePath traversed_loci,
-            std::size_t read_size);
+  /** `traversed_loci` is not copied, so must outlive the `Traverser` */
+  Traverser(node_access const& start_point,
+            VariantSitePath const& traversed_loci, std::size_t read_size);
 
   std::optional<covG_ptr> next_Node();
 
@@ -176,7 +207,7 @@ class Traverser {
  private:
   covG_ptr cur_Node;
   std::size_t bases_remaining;
-  VariantSitePath traversed_loci;
+  VariantSitePath const* traversed_loci;
   uint32_t traversed_index;
   bool first_node;
   node_coordinate start_pos;
@@ -186,19 +217,29 @@ class Traverser {
 /**
  * Uses `Traverser` to collect per-base coverage implied by search_states and
  * add the coverage to the `coverage_Graph`.
+ * The `DummyCovNode`s are collected in the recorder's own scratch space, or in
+ * `dummy_cov_nodes` if given: a mapping thread passing the same one for each
+ * read allocates nothing once it has grown.
  */
 class PbCovRecorder {
  public:
+  /** `dummy_cov_nodes` gets cleared, and must not be used by another
+   * recorder while this one is */
   PbCovRecorder(PRG_Info const& prg_info, SearchStates const& search_states,
-                std::size_t read_size);
+                std::size_t read_size,
+                DummyCovNodes* const dummy_cov_nodes = nullptr);
 
   // Testing-related constructors
   PbCovRecorder() = default;
-  PbCovRecorder(realCov_to_dummyCov existing_cov_mapping)
-      : cov_mapping(existing_cov_mapping) {}
+  PbCovRecorder(realCov_to_dummyCov const& existing_cov_mapping);
   PbCovRecorder(PRG_Info& prg_info, std::size_t read_size)
       : prg_info(&prg_info), read_size(read_size) {}
 
+  // `cov_mapping` may refer to `own_cov_mapping`, which a copy or move would
+  // leave pointing into the source recorder
+  PbCovRecorder(PbCovRecorder const&) = delete;
+  PbCovRecorder& operator=(PbCovRecorder const&) = delete;
+
   void process_SearchState(SearchState const& ss);
   void record_full_traversal(
       Traverser& t); /**< Processes all traversed_loci of a `SearchState`.*/
@@ -210,10 +251,11 @@ class PbCovRecorder {
                     node_coordinate end_pos);
   void write_coverage_from_dummy_nodes();
 
-  realCov_to_dummyCov get_cov_mapping() const { return cov_mapping; }
+  realCov_to_dummyCov get_cov_mapping() const;
 
  private:
-  realCov_to_dummyCov cov_mapping;
+  DummyCovNodes own_cov_mapping;
+  DummyCovNodes& cov_mapping{own_cov_mapping};
   PRG_Info const* prg_info;
   std::size_t read_size;
 };
@@ -9,11 +9,13 @@
 #define GRAMTOOLS_TEST_RESOURCES_HPP
 
 #include "genotype/parameters.hpp"
+#include "genotype/quasimap/coverage/allele_base.hpp"
 #include "genotype/quasimap/coverage/types.hpp"
 #include "genotype/quasimap/search/types.hpp"
 #include "prg/prg_info.hpp"
 
 namespace gram {
+struct RecordingBuffers;
 
 /**
  * Each type of coverage operation (record, generate, dump) operates on each
@@ -22,11 +24,13 @@ namespace gram {
 namespace coverage::record {
 /**
  * Selects read mappings and records all coverage information.
+ * @param buffers if given, scratch space reused across calls.
  * @see selection()
  */
 void search_states(Coverage &coverage, const SearchStates &search_states,
                    const uint64_t &read_length, const PRG_Info &prg_info,
-                   SeedSize const &selection_seed = 0);
+                   SelectionKey const &selection_key = 0,
+                   RecordingBuffers *const buffers = nullptr);
 }  // namespace coverage::record
 
 namespace coverage::generate {
@@ -39,12 +43,19 @@ Coverage empty_structure(const PRG_Info &prg_info);
 
 namespace coverage::dump {
 /**
- * Write coverage information to disk.
+ * Write coverage information to disk: allele sums as text, and all coverage
+ * in the binary coverage file. The legacy JSON files also get written, unless
+ * asked not to.
+ * @see coverage_file.hpp
  */
 void all(const Coverage &coverage, const GenotypeParams &parameters);
 }  // namespace coverage::dump
 
-using SitePath = std::set<Marker>;
+/**
+ * Site markers, held sorted and without duplicates. Reads cross few sites, so
+ * sorted vectors beat node-based sets here.
+ */
+using SitePath = std::vector<Marker>;
 
 class RandomGenerator;
 
@@ -54,8 +65,9 @@ using rand_ptr = RandomGenerator *const;
  * A set of site marker IDs signalling non-nested bubbles. One set defines an
  * equivalence class.
  */
-using level0_Sites = std::set<Marker>;
-using uniqueLoci = std::set<VariantLocus>;
+using level0_Sites = SitePath;
+/** `VariantLocus`es, held sorted and without duplicates */
+using uniqueLoci = std::vector<VariantLocus>;
 
 using info_ptr = PRG_Info const *const;
 
@@ -67,19 +79,22 @@ using info_ptr = PRG_Info const *const;
  * equivalence class.
  *  - unique_loci: this is a set of `VariantLocus` that the processed
  * `SearchState` is compatible with (data struct: `uniqueLoci`).
+ *
+ * A `LocusFinder` can be reused across `SearchState`s, keeping its buffers.
  */
 class LocusFinder {
  public:
-  LocusFinder() : search_state(), prg_info(nullptr){};
+  LocusFinder() = default;
 
-  LocusFinder(SearchState search_state, info_ptr prg_info);
+  LocusFinder(SearchState const &search_state, info_ptr prg_info);
+
+  /** Clears the loci found so far, and finds those of `search_state` */
+  void assign(SearchState const &search_state, info_ptr prg_info);
 
   /** Sanity check: are all variant site markers in the `SearchState` different?
    */
   void check_site_uniqueness(SearchState const &search_state);
 
-  void check_site_uniqueness() { check_site_uniqueness(this->search_state); }
-
   /**
    * Takes a `VariantLocus` and registers it as well as all sites it is nested
    * within, up to a level 0 site.
@@ -93,24 +108,15 @@ class LocusFinder {
   void assign_traversing_loci(SearchState const &search_state,
                               info_ptr prg_info);
 
-  void assign_traversing_loci() {
-    assign_traversing_loci(this->search_state, this->prg_info);
-  }
-
   void assign_traversed_loci(SearchState const &search_state,
                              info_ptr prg_info);
 
-  void assign_traversed_loci() {
-    assign_traversed_loci(this->search_state, this->prg_info);
-  }
-
   level0_Sites base_sites; /**< Form the basis for `SearchState` selection */
   SitePath used_sites;     /**< For remembering which sites have already been
                               processed */
   uniqueLoci unique_loci;  /**< For grouped allele counts coverage recording */
  private:
-  SearchState const search_state;
-  info_ptr prg_info;
+  SitePath markers_buffer; /**< For checking site uniqueness */
 };
 
 /**
@@ -120,13 +126,44 @@ class LocusFinder {
  */
 using traversal_info = std::pair<SearchStates, uniqueLoci>;
 /**
- * Models a set of equivalence classes: each `level0_Sites` is a set of site
- * markers at level 0, ie non-nested bubbles. This data structure is the basis
- * for: -Dispatching `SearchState`s into their equivalence class -Random
- * selection of one equivalence class.
+ * Models a set of equivalence classes, ordered by their `level0_Sites`.
+ * Equivalence classes are selected by their index in this order.
  */
 using uniqueSitePaths = std::map<level0_Sites, traversal_info>;
 
+/**
+ * An equivalence class, as dispatched to by `MappingInstanceSelector`.
+ * `SearchState`s are referred to, not copied.
+ */
+struct EquivalenceClass {
+  level0_Sites base_sites;
+  std::vector<SearchState const *> search_states;
+  uniqueLoci loci;
+};
+
+/**
+ * Buffers for `MappingInstanceSelector`, which can be reused across the reads
+ * a thread maps so that their capacity is only grown once.
+ */
+struct SelectorBuffers {
+  std::vector<EquivalenceClass> classes; /**< Only the first `num_classes`
+                                            are in use */
+  std::size_t num_classes = 0;
+  /** Index in `classes` of the class in use for each `level0_Sites` */
+  SequenceHashMap<level0_Sites, std::size_t> class_indices;
+  LocusFinder locus_finder;
+  std::vector<EquivalenceClass const *> ordered_classes;
+};
+
+/**
+ * Scratch space for recording the coverage of reads. Each thread mapping reads
+ * reuses its own across them, so that its capacity is only grown once.
+ */
+struct RecordingBuffers {
+  SelectorBuffers selector;
+  coverage::per_base::DummyCovNodes dummy_cov_nodes;
+};
+
 struct SelectedMapping {
   SearchStates
       navigational_search_states;    /**< Use: recording per base coverage*/
@@ -138,31 +175,42 @@ struct SelectedMapping {
  * Takes a set of `SearchState`s, dispatches them into equivalence classes, and
  * randomly selects equivalent mapping instances of the read.
  *
- * The basis for selection is the set of `level1_Sites` in `usps`.
+ * The basis for selection is the set of `level0_Sites` of each class. A class
+ * is selected by its index in the order of `level0_Sites`, which makes
+ * selections independent of the order in which `SearchState`s are dispatched.
+ *
+ * Equivalence classes get built in the selector's own buffers, or in `buffers`
+ * if given. Those must not be used by another selector while this one is.
  */
 class MappingInstanceSelector {
  public:
-  uniqueSitePaths usps; /**< Key dispatching and selection object.*/
-
   // Constructor
-  MappingInstanceSelector(SearchStates const search_states, info_ptr prg_info,
-                          rand_ptr rand_generator);
+  MappingInstanceSelector(SearchStates const &search_states, info_ptr prg_info,
+                          rand_ptr rand_generator,
+                          SelectorBuffers *const buffers = nullptr);
 
   // Constructors for testing
-  MappingInstanceSelector() : prg_info(nullptr), rand_generator(nullptr) {}
+  MappingInstanceSelector() : MappingInstanceSelector(nullptr, nullptr) {}
 
   MappingInstanceSelector(info_ptr prg_info)
-      : prg_info(prg_info), rand_generator(nullptr) {}
+      : MappingInstanceSelector(prg_info, nullptr) {}
+
+  MappingInstanceSelector(info_ptr prg_info, rand_ptr rand_g,
+                          SelectorBuffers *const buffers = nullptr);
 
-  MappingInstanceSelector(info_ptr prg_info, rand_ptr rand_g)
-      : prg_info(prg_info), rand_generator(rand_g) {}
+  // `buffers` may refer to `own_buffers`, which a copy or move would leave
+  // pointing into the source selector
+  MappingInstanceSelector(MappingInstanceSelector const &) = delete;
+  MappingInstanceSelector &operator=(MappingInstanceSelector const &) = delete;
 
   void process_searchstates(SearchStates const &all_ss);
 
-  void set_searchstates(SearchStates const &ss) { input_search_states = ss; }
+  /** `ss` is not copied, so must outlive the selector */
+  void set_searchstates(SearchStates const &ss) { input_search_states = &ss; }
 
   /**
-   * Dispatches a `SearchState` into `usps` using `LocusFinder`.
+   * Dispatches a `SearchState` into its equivalence class using `LocusFinder`.
+   * `ss` is not copied, so must outlive the selector.
    */
   void add_searchstate(SearchState const &ss);
 
@@ -181,8 +229,14 @@ class MappingInstanceSelector {
 
   SelectedMapping get_selection() { return selected; }
 
+  std::size_t num_classes() const { return buffers.num_classes; }
+  /** The equivalence classes as an ordered map, for testing */
+  uniqueSitePaths get_usps() const;
+
  private:
-  SearchStates input_search_states;
+  SearchStates const *input_search_states;
+  SelectorBuffers own_buffers;
+  SelectorBuffers &buffers;
   SelectedMapping selected; /**< stores the choice made*/
   info_ptr prg_info;
   rand_ptr rand_generator;
@@ -0,0 +1,83 @@
+/** @file
+ * Coverage file: all coverage recorded by quasimap, in a compact binary
+ * format, optionally gzip-compressed. It is written straight from the
+ * coverage arrays, and the `coverage_to_json` submod converts it to the
+ * legacy JSON coverage files.
+ *
+ * Schema (version 2). All integers are unsigned and little-endian; `uN` is N
+ * bits wide.
+ *
+ *     header:
+ *       u8[8]  magic: "GRAMCOV" then a null byte
+ *       u32    version
+ *       u32    flags: bit 0 set if per base coverage is present,
+ *                     bit 1 set if graph per base coverage is present
+ *       u64    number of variant sites
+ *     then, for each variant site in order of site ID:
+ *       u32    number of alleles A
+ *       u32[A] allele sum coverage
+ *       u32    number of allele groups G
+ *       G x    { u32 group size S; u32[S] allele IDs; u32 read count }
+ *       if per base coverage is present:
+ *         u32  number of alleles B
+ *         B x  { u32 allele length L; u32[L] coverage of each base }
+ *     then, if graph per base coverage is present:
+ *       u64    number of bases N
+ *       u32[N] coverage of each base of the coverage graph
+ *
+ * Per base coverage of nested prgs cannot be split by site and allele, so it
+ * is written as graph per base coverage instead: the coverage graph's
+ * per base store, as is. It only makes sense alongside the prg it was mapped
+ * to. Version 1 files, which have no graph per base coverage, are still read.
+ *
+ * Groups are written sorted, so that the same coverage always gives the same
+ * file. When compressed, the whole file is a single gzip member.
+ */
+#ifndef GRAMTOOLS_COVERAGE_FILE_HPP
+#define GRAMTOOLS_COVERAGE_FILE_HPP
+
+#include <iostream>
+
+#include "genotype/quasimap/coverage/types.hpp"
+#include "prg/prg_info.hpp"
+
+namespace gram::coverage::file {
+/** Bumped whenever the coverage file schema changes */
+constexpr uint32_t COVERAGE_FILE_VERSION{2};
+constexpr uint32_t COVERAGE_FILE_HAS_PER_BASE{1};
+constexpr uint32_t COVERAGE_FILE_HAS_GRAPH_PER_BASE{2};
+
+/**
+ * Writes `coverage` to `stream` following the schema above. Per base coverage
+ * is only flagged present if `coverage.allele_base_coverage` is not empty, as
+ * it is left empty for nested prgs; likewise graph per base coverage.
+ */
+void write(std::ostream &stream, Coverage const &coverage);
+
+/**
+ * Reads coverage written by `write()`; throws on a malformed stream. Counts
+ * are checked against what is left of the stream before anything gets
+ * allocated for them, so a corrupt count cannot exhaust memory.
+ */
+Coverage read(std::istream &stream);
+
+/** Writes `coverage` to `fpath`, gzip-compressed if `compress`. */
+void dump(std::string const &fpath, Coverage const &coverage,
+          bool const compress);
+
+/** Loads a coverage file, whether or not it is gzip-compressed. */
+Coverage load(std::string const &fpath);
+
+/** The per base coverage of `prg_info`'s coverage graph, as files hold it */
+PerBaseCoverage graph_base_coverage(PRG_Info const &prg_info);
+
+/**
+ * Sets the per base coverage of `prg_info`'s coverage graph to
+ * `graph_base_coverage`, as loaded from a file. Throws if it was recorded on
+ * a different prg.
+ */
+void restore_graph_base_coverage(PerBaseCoverage const &graph_base_coverage,
+                                 PRG_Info const &prg_info);
+}  // namespace gram::coverage::file
+
+#endif  // GRAMTOOLS_COVERAGE_FILE_HPP
@@ -36,7 +36,7 @@ void grouped_allele_counts(Coverage &coverage,
 
 namespace dump {
 /**
- * Write grouped allele coverage to disk in JSON format.
+ * Write grouped allele coverage to disk in the legacy JSON format.
  */
 void grouped_allele_counts(const Coverage &coverage,
                            const GenotypeParams &parameters);
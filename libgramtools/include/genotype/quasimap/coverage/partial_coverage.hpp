@@ -0,0 +1,41 @@
+/** @file
+ * Partial coverage: the coverage and read statistics of mapping part of a
+ * sample's reads, in a compact binary file. Partial coverage files from
+ * different processes or machines mapping to the same prg can be summed, so
+ * that mapping scales horizontally.
+ */
+#ifndef GRAMTOOLS_PARTIAL_COVERAGE_HPP
+#define GRAMTOOLS_PARTIAL_COVERAGE_HPP
+
+#include "genotype/quasimap/quasimap.hpp"
+
+namespace gram::coverage::partial {
+/** Bumped whenever the partial coverage file contents change */
+constexpr uint32_t PARTIAL_COVERAGE_VERSION{2};
+
+/**
+ * Writes read counts, allele sum coverage, grouped allele counts, per base
+ * coverage (from `prg_info`'s coverage graph) and `readstats`' recorded reads.
+ */
+void dump(std::string const &fpath, QuasimapReadsStats const &quasimap_stats,
+          ReadStats const &readstats, PRG_Info const &prg_info);
+
+/**
+ * Adds the contents of a file written by `dump()` to `quasimap_stats`,
+ * `readstats` and the per base coverage of `prg_info`'s coverage graph.
+ * Throws if the file was written for a different prg, as told by the prg's
+ * size, number of sites and per base coverage, and where its sites end.
+ */
+void merge(std::string const &fpath, QuasimapReadsStats &quasimap_stats,
+           ReadStats &readstats, PRG_Info const &prg_info);
+
+/**
+ * Sums partial coverage files into empty coverage structures.
+ * @return the summed coverage and read counts; `readstats` gets the merged
+ * reads' base error rate.
+ */
+QuasimapReadsStats merge_all(std::vector<std::string> const &fpaths,
+                             ReadStats &readstats, PRG_Info const &prg_info);
+}  // namespace gram::coverage::partial
+
+#endif  // GRAMTOOLS_PARTIAL_COVERAGE_HPP
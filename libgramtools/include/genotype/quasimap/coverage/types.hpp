@@ -40,6 +40,10 @@ struct Coverage {
   AlleleSumCoverage allele_sum_coverage;
   SitesGroupedAlleleCounts grouped_allele_counts;
   SitesAlleleBaseCoverage allele_base_coverage;
+  /** Per base coverage of the whole coverage graph, in the order its store
+   * holds it. Only kept for nested prgs, which `allele_base_coverage` cannot
+   * describe. */
+  PerBaseCoverage graph_base_coverage;
 };
 }  // namespace gram
 
@@ -0,0 +1,107 @@
+/** @file
+ * Reports the progress of read mapping while it runs, for people and for job
+ * schedulers to follow.
+ *
+ * Mapping threads each count their progress on their own cache line, and a
+ * background thread sums those counts up and reports them: counting costs
+ * mapping threads no atomic read-modify-write, nor any contention.
+ */
+#ifndef GRAMTOOLS_PROGRESS_HPP
+#define GRAMTOOLS_PROGRESS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CACHE_LINE_BYTES 64
+
+namespace gram {
+
+constexpr uint32_t DEFAULT_PROGRESS_SECONDS{30};
+
+/** The progress of one mapping thread. Only that thread adds to it. */
+struct alignas(CACHE_LINE_BYTES) ThreadProgress {
+  std::atomic<uint64_t> num_reads{0};        /**< Processed */
+  std::atomic<uint64_t> num_mapped_reads{0}; /**< On either strand */
+  std::atomic<uint64_t> num_bytes{0};        /**< Of reads files, loaded */
+
+  /**
+   * A relaxed load and store rather than an atomic increment: the counter
+   * has a single writer, and the reporter can read it at any time.
+   */
+  static void add(std::atomic<uint64_t> &counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+  }
+};
+
+struct ProgressSnapshot {
+  double seconds = 0; /**< Since mapping started */
+  uint64_t num_reads = 0;
+  uint64_t num_mapped_reads = 0;
+  uint64_t num_bytes = 0;
+  uint64_t total_bytes = 0; /**< Of all reads files */
+
+  double reads_per_second() const;
+  double mapped_fraction() const;
+  /** From the fraction of reads file bytes loaded; negative if unknown */
+  double eta_seconds() const;
+
+  /** A line of JSON */
+  std::string to_json() const;
+  /** A line for people to read */
+  std::string to_string() const;
+};
+
+/**
+ * Sums up the progress of mapping threads every `report_seconds`, and reports
+ * it to stderr and, if given, to `progress_fpath`. That file gets replaced
+ * with each report, so that it always holds the latest one, in JSON.
+ */
+class ProgressReporter {
+ public:
+  /**
+   * @param num_threads the most threads that will count progress
+   * @param total_bytes the size of the reads files, for estimating how long
+   * mapping has left.
+   * @param report_seconds 0 for no reports, but for a last one if there is
+   * a `progress_fpath`.
+   */
+  ProgressReporter(std::size_t num_threads, uint64_t total_bytes,
+                   std::string progress_fpath, double report_seconds);
+
+  /** Stops reporting, after a last report if reporting was asked for */
+  ~ProgressReporter();
+
+  ThreadProgress &thread_progress(std::size_t thread_num) {
+    return threads.at(thread_num);
+  }
+
+  ProgressSnapshot snapshot() const;
+
+  void report(ProgressSnapshot const &snapshot);
+
+ private:
+  void run();
+
+  std::vector<ThreadProgress> threads;
+  uint64_t const total_bytes;
+  std::string const progress_fpath;
+  double const report_seconds;
+  double const start_time;
+
+  std::mutex mutex;
+  std::condition_variable stop_condition;
+  bool stopping = false;
+  std::thread reporter;
+};
+
+/** The total size of `fpaths`, leaving out those whose size is unknown */
+uint64_t files_size(std::vector<std::string> const &fpaths);
+}  // namespace gram
+
+#endif  // GRAMTOOLS_PROGRESS_HPP
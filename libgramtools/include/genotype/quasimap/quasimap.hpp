@@ -8,49 +8,171 @@
 #include "build/kmer_index/kmer_index_types.hpp"
 #include "genotype/parameters.hpp"
 #include "genotype/quasimap/coverage/coverage_common.hpp"
+#include "genotype/quasimap/read_cache.hpp"
 #include "genotype/read_stats.hpp"
+#include "genotype/regions.hpp"
 #include "search/encapsulated_search.hpp"
 #include "sequence_read/seqread.hpp"
 
 namespace gram {
+/** Reads handed out at a time to each thread mapping a batch of reads */
+constexpr std::size_t READS_CHUNK_SIZE{16};
+constexpr std::size_t INITIAL_READS_BATCH_SIZE{5000};
+constexpr std::size_t MIN_READS_BATCH_SIZE{1000};
+constexpr std::size_t MAX_READS_BATCH_SIZE{200000};
+/** Time a batch of reads should take to map, once throughput is known */
+constexpr double TARGET_READS_BATCH_SECONDS{1.0};
 
-struct QuasimapReadsStats {
+/**
+ * Counts of reads by how mapping them went. Threads mapping reads each keep
+ * their own, which get summed between batches of reads: counting is then
+ * free of contention between threads.
+ */
+struct ReadCounts {
   uint64_t all_reads_count = 0;
   uint64_t skipped_reads_count = 0;
   uint64_t missing_kmer_reads_count = 0;
   uint64_t no_extension_reads_count = 0;
   uint64_t exact_mapped_reads_count = 0;
+  uint64_t inexact_mapped_reads_count = 0; /**< Mapped with substitutions */
+  uint64_t off_region_reads_count = 0;
+  uint64_t cached_reads_count = 0; /**< Mappings taken from the read cache */
+
+  ReadCounts &operator+=(ReadCounts const &other);
+};
+
+struct QuasimapReadsStats : ReadCounts {
+  std::size_t read_cache_bytes = 0;
+  uint64_t read_batches_count = 0;
+  double mapping_seconds = 0; /**< Wall time spent mapping read batches */
+  /** Wall time spent mapping read batches, times the threads doing so */
+  double mapping_thread_seconds = 0;
+  /** Summed over threads, loading the next batch while mapping */
+  double loading_thread_seconds = 0;
+  double idle_thread_seconds = 0; /**< Summed over threads, while mapping */
   Coverage coverage = {};
 };
 
 /**
- * For each read file, quasimap reads.
+ * How far mapping got through `GenotypeParams::reads_fpaths`, and statistics of
+ * the reads it got through. Both are kept per reads file, as several reads
+ * files get mapped at once.
+ */
+struct ReadsProgress {
+  std::vector<uint64_t> num_reads;  /**< Mapped, per reads file */
+  std::vector<ReadStats> readstats; /**< Of the mapped reads, per reads file */
+};
+
+class Checkpointer;
+class ProgressReporter;
+
+/**
+ * The read counts of `quasimap_stats` that files of coverage (partial
+ * coverage, checkpoints) hold, in the order they get serialised. Those about
+ * the mapping run itself (read cache size, batches, timings) are left out.
  */
-QuasimapReadsStats quasimap_reads(const GenotypeParams &parameters,
-                                  const KmerIndex &kmer_index,
-                                  const PRG_Info &prg_info,
-                                  ReadStats &readstats);
+template <typename Stats>
+auto read_counts(Stats &quasimap_stats) {
+  return std::vector<decltype(&quasimap_stats.all_reads_count)>{
+      &quasimap_stats.all_reads_count,
+      &quasimap_stats.skipped_reads_count,
+      &quasimap_stats.missing_kmer_reads_count,
+      &quasimap_stats.no_extension_reads_count,
+      &quasimap_stats.exact_mapped_reads_count,
+      &quasimap_stats.inexact_mapped_reads_count,
+      &quasimap_stats.off_region_reads_count,
+      &quasimap_stats.cached_reads_count};
+}
 
 /**
- * Load and process (ie map) reads from a given read file using a buffer to
- * reduce disk I/O calls
+ * Picks how many reads to load and map at once from the observed mapping
+ * throughput, so that each batch takes about `TARGET_READS_BATCH_SECONDS`.
+ * Larger batches leave threads idle less often, waiting on the slowest read
+ * of a batch; smaller ones hold fewer reads in memory.
  */
-void handle_read_file(QuasimapReadsStats &quasimap_stats,
-                      const std::string &reads_fpath,
-                      const GenotypeParams &parameters,
-                      const KmerIndex &kmer_index, const PRG_Info &prg_info,
-                      RandomGenerator *const seed_generator);
+class ReadBatchSizer {
+ public:
+  std::size_t size() const { return batch_size; }
+  /** Records that `num_reads` got mapped in `seconds` */
+  void update(std::size_t num_reads, double seconds);
+
+ private:
+  std::size_t batch_size = INITIAL_READS_BATCH_SIZE;
+};
+
+/**
+ * Quasimaps the reads of all read files.
+ * Read length and quality statistics get recorded into `readstats` as reads
+ * are loaded, so that read files are only parsed once.
+ * Unless `parameters.read_cache_size` is 0, the mappings of reads are cached,
+ * so that duplicate reads are only searched for once.
+ * With `parameters.resume`, mapping restarts from the checkpoint left by a
+ * previous run, if there is one.
+ * Progress gets reported every `parameters.progress_seconds` while mapping.
+ * @param regions if given, reads are only mapped if they can reach its sites.
+ */
+QuasimapReadsStats quasimap_reads(
+    const GenotypeParams &parameters, const KmerIndex &kmer_index,
+    const PRG_Info &prg_info, ReadStats &readstats,
+    genotype::RegionSelection const *const regions = nullptr);
+
+/**
+ * Once all reads are mapped, computes read coverage depth and per base
+ * coverage, and writes coverage to disk.
+ * @param regions if given, read coverage depth is computed from its sites only.
+ */
+void finalise_coverage(
+    QuasimapReadsStats &quasimap_stats, ReadStats &readstats,
+    const GenotypeParams &parameters, const PRG_Info &prg_info,
+    genotype::RegionSelection const *const regions = nullptr);
+
+/**
+ * Loads and processes (ie maps) the reads of `parameters.reads_fpaths`, in
+ * batches to reduce disk I/O calls.
+ * Up to one reads file per two threads is open at once, and each batch takes
+ * reads from all open files, so that many small (eg lane-split) reads files
+ * get mapped as fast as one large one. The next batch gets loaded, by as many
+ * threads as there are open files, while the others map the current one.
+ * Reads are handed out to threads in small chunks, so that threads that got
+ * cheap reads take on more.
+ * The key selecting among the mappings of a read derives from `master_seed`,
+ * the index of its reads file and its index in that file: neither batching nor
+ * the thread count changes mapping results.
+ * @param progress how many reads of each file already got mapped (by a
+ * previous run being resumed): those are skipped. Gets updated as reads get
+ * mapped, along with the statistics of each file's loaded reads.
+ * @param region_kmers if given, reads (and their reverse complements) with no
+ * kmer in it are skipped without being searched for.
+ * @param read_cache if given, read mappings are looked up in and added to it.
+ * @param checkpointer if given, checkpoints of mapping get written with it
+ * between batches of reads.
+ * @param progress_reporter if given, mapping progress gets counted in it.
+ */
+void handle_read_files(QuasimapReadsStats &quasimap_stats,
+                       const GenotypeParams &parameters,
+                       const KmerIndex &kmer_index, const PRG_Info &prg_info,
+                       SeedSize const &master_seed, ReadsProgress &progress,
+                       genotype::KmerSet const *const region_kmers = nullptr,
+                       MappedReadCache *const read_cache = nullptr,
+                       Checkpointer *const checkpointer = nullptr,
+                       ProgressReporter *const progress_reporter = nullptr);
 
 /**
  * Calls quasimapping routine on a given read (forward mapping), and its reverse
  * complement (reverse mapping)
+ * @param read_counts records how mapping went.
+ * @param read_cache if given and holding `read`, its mappings are taken from
+ * there; else they are added to it.
+ * @param buffers if given, scratch space for recording coverage.
  */
-void quasimap_forward_reverse(QuasimapReadsStats &quasimap_stats,
+void quasimap_forward_reverse(ReadCounts &read_counts, Coverage &coverage,
                               const Sequence &read,
                               const GenotypeParams &parameters,
                               const KmerIndex &kmer_index,
                               const PRG_Info &prg_info,
-                              SeedSize const &selection_seed);
+                              SelectionKey const &selection_key,
+                              MappedReadCache *const read_cache = nullptr,
+                              RecordingBuffers *const buffers = nullptr);
 
 /**
  * Map a read to the prg, starting from the precomputed set of search states
@@ -64,8 +186,28 @@ void quasimap_forward_reverse(QuasimapReadsStats &quasimap_stats,
  */
 void quasimap_read(const Sequence &read, Coverage &coverage,
                    const KmerIndex &kmer_index, const PRG_Info &prg_info,
-                   const GenotypeParams &parameters, QuasimapReadsStats &stats,
-                   SeedSize const &selection_seed = 42);
+                   const GenotypeParams &parameters, ReadCounts &stats,
+                   SelectionKey const &selection_key = 42);
+
+/**
+ * Searches for `read` in the prg: the part of `quasimap_read` that does not
+ * depend on the selection key.
+ * If `parameters.max_mismatches` is not 0, reads with no exact mapping are
+ * searched for again allowing that many substitutions.
+ */
+ReadMapping map_read(const Sequence &read, const KmerIndex &kmer_index,
+                     const PRG_Info &prg_info,
+                     const GenotypeParams &parameters);
+
+/**
+ * Counts the outcome of `mapping` in `stats`, and records the coverage of a
+ * randomly selected mapping instance in `coverage`.
+ * @param buffers if given, scratch space for recording coverage.
+ */
+void record_read_mapping(ReadMapping const &mapping, std::size_t read_length,
+                         Coverage &coverage, const PRG_Info &prg_info,
+                         ReadCounts &stats, SelectionKey const &selection_key,
+                         RecordingBuffers *const buffers = nullptr);
 
 /**
  * Fetches a kmer of size `kmer_size`, starting from `offset` (0-based)
@@ -0,0 +1,100 @@
+/** @file
+ * Caches the mappings of reads, so that exact duplicate reads (common in
+ * amplicon and PCR-heavy libraries) do not get searched for again.
+ * Only the random selection of a mapping instance, which depends on the read's
+ * own selection key, is then redone.
+ */
+
+#ifndef GRAMTOOLS_READ_CACHE_HPP
+#define GRAMTOOLS_READ_CACHE_HPP
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "genotype/quasimap/search/types.hpp"
+
+namespace gram {
+constexpr std::size_t READ_CACHE_SHARDS{64};
+/** Maximum number of reads whose mappings are cached, by default */
+constexpr std::size_t DEFAULT_READ_CACHE_SIZE{100000};
+/** Maximum bytes held by cached reads and their mappings, by default */
+constexpr std::size_t DEFAULT_READ_CACHE_BYTES{std::size_t{1} << 30};
+
+enum class ReadMappingOutcome {
+  missing_kmer,
+  no_extension,
+  mapped,
+  mapped_inexact /**< Mapped with base substitutions */
+};
+
+/** The result of searching for one strand of a read */
+struct ReadMapping {
+  ReadMappingOutcome outcome;
+  SearchStates search_states; /**< Empty unless the read got mapped */
+};
+
+struct ReadMappings {
+  ReadMapping forward;
+  ReadMapping reverse;
+};
+
+using ReadMappingsPtr = std::shared_ptr<ReadMappings const>;
+
+/**
+ * Bounded cache of `ReadMappings`, safe to use from several threads.
+ * Reads are spread across shards by hash, each with its own lock, and each
+ * evicting its oldest reads first once full: of reads, or of bytes.
+ */
+class MappedReadCache {
+ public:
+  /**
+   * @param max_reads the maximum number of reads held
+   * @param max_bytes the maximum bytes held, as counted by `memory_usage`
+   */
+  explicit MappedReadCache(std::size_t max_reads,
+                           std::size_t max_bytes = DEFAULT_READ_CACHE_BYTES);
+
+  /** @return nullptr if `read` is not cached */
+  ReadMappingsPtr find(Sequence const &read);
+  void insert(Sequence const &read, ReadMappingsPtr const &mappings);
+
+  std::size_t size() const;
+  /** Approximate bytes held by the cached reads and their mappings */
+  std::size_t memory_usage() const;
+  uint64_t num_lookups() const;
+  uint64_t num_hits() const;
+
+ private:
+  struct Entry {
+    Sequence read;
+    ReadMappingsPtr mappings;
+    std::size_t bytes;
+  };
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::size_t, Entry> entries; /**< Keyed by read hash */
+    std::deque<std::size_t> insertion_order;
+    std::size_t bytes = 0;
+    // Counted per shard, under its lock, rather than in shared atomics that
+    // every lookup would contend over
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+  };
+
+  Shard &get_shard(std::size_t read_hash) {
+    return shards[read_hash % READ_CACHE_SHARDS];
+  }
+
+  std::size_t max_reads_per_shard;
+  std::size_t max_bytes_per_shard;
+  std::vector<Shard> shards;
+};
+
+/** Approximate bytes used by `mappings` of `read` */
+std::size_t read_mappings_bytes(Sequence const &read,
+                                ReadMappings const &mappings);
+}  // namespace gram
+
+#endif  // GRAMTOOLS_READ_CACHE_HPP
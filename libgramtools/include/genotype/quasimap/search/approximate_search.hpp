@@ -0,0 +1,45 @@
+/** @file
+ * Inexact vBWT search, allowing a few base substitutions between a read and the
+ * prg, so that reads with sequencing errors can still be mapped.
+ */
+#ifndef GRAMTOOLS_APPROXIMATE_SEARCH_HPP
+#define GRAMTOOLS_APPROXIMATE_SEARCH_HPP
+
+#include "build/kmer_index/kmer_index_types.hpp"
+#include "genotype/quasimap/search/types.hpp"
+#include "prg/prg_info.hpp"
+
+namespace gram {
+
+constexpr std::size_t DEFAULT_MAX_SEARCH_STATES{1000};
+
+/**
+ * Read positions where a sequencing error likely is, based on which kmers of
+ * `read` are missing from `kmer_index`: those lying in all the missing kmers,
+ * or if there are none, in any of them. If no kmer is missing, all positions.
+ */
+std::vector<bool> likely_error_positions(uint32_t const &kmer_size,
+                                         Sequence const &read,
+                                         KmerIndex const &kmer_index);
+
+/** `SearchStates`, indexed by how many substitutions they carry */
+using MismatchSearchStates = std::vector<SearchStates>;
+
+/**
+ * Maps `read`, which must be at least `kmer_size` long, allowing up to
+ * `max_mismatches` substitutions at its `likely_error_positions()`.
+ *
+ * When more than `max_search_states` search states are live, those carrying
+ * the most substitutions get dropped; exact ones never are.
+ *
+ * @return the mappings with the fewest substitutions, if any
+ */
+SearchStates search_read_approximate(Sequence const &read,
+                                     uint32_t const &kmer_size,
+                                     KmerIndex const &kmer_index,
+                                     PRG_Info const &prg_info,
+                                     uint32_t const &max_mismatches,
+                                     std::size_t const &max_search_states);
+}  // namespace gram
+
+#endif  // GRAMTOOLS_APPROXIMATE_SEARCH_HPP
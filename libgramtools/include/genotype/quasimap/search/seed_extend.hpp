@@ -0,0 +1,60 @@
+/** @file
+ * Seed-and-extend search: the vBWT search of a read starts from its most
+ * selective kmer rather than its last one, so that fewer `SearchState`s get
+ * carried through highly variable regions.
+ *
+ * The vBWT only extends leftwards, so the part of the read left of the seed is
+ * searched as usual, and the part right of it is then verified by walking the
+ * coverage graph forward from each occurrence found.
+ */
+#ifndef GRAMTOOLS_SEED_EXTEND_HPP
+#define GRAMTOOLS_SEED_EXTEND_HPP
+
+#include "build/kmer_index/kmer_index_types.hpp"
+#include "genotype/quasimap/search/types.hpp"
+#include "prg/prg_info.hpp"
+
+namespace gram {
+
+/** Number of occurrences in the prg of the mappings of a kmer */
+std::size_t count_occurrences(SearchStates const &search_states);
+
+/**
+ * @return the offset in `read` of the kmer with fewest occurrences in
+ * `kmer_index`; on ties, the rightmost such kmer. All kmers of `read` must be
+ * in `kmer_index`.
+ */
+std::size_t most_selective_kmer_offset(uint32_t const &kmer_size,
+                                       Sequence const &read,
+                                       KmerIndex const &kmer_index);
+
+/**
+ * The paths of a single occurrence of a read, in the form vBWT search gives
+ * them: loci in order of the sites they get met in, from read end to start.
+ */
+struct OccurrencePaths {
+  VariantSitePath traversed_path;
+  VariantSitePath traversing_path;
+};
+
+/**
+ * Finds all the ways `read` matches the prg going forward from `prg_pos`,
+ * following the coverage graph through variant sites.
+ */
+std::vector<OccurrencePaths> match_read_forward(Sequence const &read,
+                                                std::size_t prg_pos,
+                                                PRG_Info const &prg_info);
+
+/**
+ * Maps `read`, which must be at least `kmer_size` long, from its most selective
+ * kmer.
+ * Gives the same mapping instances and paths as `search_read_backwards()`,
+ * though SA intervals may get grouped into `SearchState`s differently.
+ */
+SearchStates search_read_seed_extend(Sequence const &read,
+                                     uint32_t const &kmer_size,
+                                     KmerIndex const &kmer_index,
+                                     PRG_Info const &prg_info);
+}  // namespace gram
+
+#endif  // GRAMTOOLS_SEED_EXTEND_HPP
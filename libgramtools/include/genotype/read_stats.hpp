@@ -5,6 +5,11 @@
  * recording that, as well as some other usable metrics, such as max read length
  * and number of sites with no coverage.
  */
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <random>
+
+#include "genotype/infer/types.hpp"
 #include "genotype/quasimap/coverage/types.hpp"
 #include "prg/types.hpp"
 
@@ -37,9 +42,11 @@ class AbstractReadStats {
    * Compute the depth of coverage using recorded coverage of reads over variant
    * sites after `quasimap`.
    * @param coverage gram::Coverage containing read coverage over variant sites.
+   * @param selection if not empty, only the selected sites are used.
    */
-  void compute_coverage_depth(Coverage const& coverage,
-                              coverage_Graph const& cov_graph);
+  void compute_coverage_depth(
+      Coverage const& coverage, coverage_Graph const& cov_graph,
+      genotype::infer::SiteSelection const& selection = {});
 
   double const& get_mean_cov() const { return mean_cov_depth; }
   double const& get_var_cov() const { return variance_cov_depth; }
@@ -66,11 +73,6 @@ class ReadStats : public AbstractReadStats {
         num_bases_processed(-1),
         mean_pb_error(-1) {}
 
-  /**
-   * From a file
-   */
-  void compute_base_error_rate(const std::string& reads_fpath);
-
   /**
    * From random access memory
    */
@@ -81,6 +83,34 @@ class ReadStats : public AbstractReadStats {
    */
   void process_read_perbase_error_rates(AbstractGenomicReadIterator& reads_it);
 
+  /**
+   * Records the length and base qualities of a read, so that statistics get
+   * gathered as reads are loaded for mapping.
+   * The qualities of up to `NUM_READS_USED` reads with quality scores are kept,
+   * as a uniform (reservoir) sample of all recorded such reads.
+   */
+  void record_read(GenomicRead const& read);
+
+  /** Estimates the per-base error rate from the recorded reads' qualities */
+  void finalise_base_error_rate();
+
+  /**
+   * Adds the reads recorded by `other` (eg, from another part of the same
+   * sample's reads) to those recorded here. The merged quality sample stays a
+   * uniform sample of all the reads.
+   */
+  void merge(ReadStats const& other);
+
+  /**
+   * The state of the generator drawing which reads get sampled. Together with
+   * the serialised recorded reads, it lets recording carry on elsewhere as if
+   * uninterrupted.
+   */
+  std::string get_sampler_state() const;
+  void set_sampler_state(std::string const& state);
+  /** Seeds the generator drawing which reads get sampled */
+  void seed_sampler(uint64_t seed) { sample_generator.seed(seed); }
+
   using haplogroup_cov = std::pair<AlleleId, CovCount>;
 
   static haplogroup_cov get_max_cov_haplogroup(
@@ -102,6 +132,22 @@ class ReadStats : public AbstractReadStats {
   int64_t no_qual_reads;
   std::size_t max_read_length;
   int64_t num_bases_processed;
+
+  /** Phred score sum and number of bases of each read in the sample */
+  std::vector<std::pair<uint64_t, uint64_t>> quality_sample;
+  uint64_t num_qual_reads_recorded = 0;
+  int64_t num_no_qual_reads_recorded = 0;
+  std::mt19937_64 sample_generator;
+
+  // Only the recorded reads get serialised: the rest is computed from them
+  friend class boost::serialization::access;
+  template <typename Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar& max_read_length;
+    ar& quality_sample;
+    ar& num_qual_reads_recorded;
+    ar& num_no_qual_reads_recorded;
+  }
 };
 
 }  // namespace gram
@@ -0,0 +1,75 @@
+/** @file
+ * Restricting genotyping to regions of the reference, given in BED format.
+ * Region coordinates are those of the sequences the PRG was built from, as
+ * tracked by `SegmentTracker`. They select the sites to genotype, and the
+ * kmers that reads must contain to be worth mapping.
+ */
+#ifndef GRAMTOOLS_GENOTYPE_REGIONS_HPP
+#define GRAMTOOLS_GENOTYPE_REGIONS_HPP
+
+#include <istream>
+#include <unordered_set>
+
+#include "build/kmer_index/kmer_index_types.hpp"
+#include "genotype/infer/output_specs/segment_tracker.hpp"
+#include "genotype/infer/types.hpp"
+#include "prg/prg_info.hpp"
+
+namespace gram::genotype {
+
+class RegionsException : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+struct Region {
+  std::string chrom;
+  std::size_t start; /**< 0-based */
+  std::size_t end;   /**< 0-based, exclusive */
+};
+using Regions = std::vector<Region>;
+
+using KmerSet = std::unordered_set<Sequence, sequence_hash<Sequence>>;
+
+struct RegionSelection {
+  infer::SiteSelection sites;
+  KmerSet kmers; /**< Kmers occurring in the selected sites, or overlapping
+                    their start */
+};
+
+/**
+ * Reads the first three columns of a BED file.
+ * Blank, comment ('#'), 'track' and 'browser' lines are skipped.
+ */
+Regions load_bed(std::istream& bed_file);
+
+/**
+ * Selects the level 1 sites whose REF allele overlaps a region, along with all
+ * the sites nested in them: genotyping a site requires genotyping the sites
+ * nested in it, and nested sites have no REF coordinates of their own.
+ */
+infer::SiteSelection select_sites(coverage_Graph const& cov_graph,
+                                  Regions const& regions,
+                                  SegmentTracker const& tracker);
+
+/**
+ * Finds the kmers of `kmer_index` that a read mapping to a selected site must
+ * contain: those with an occurrence inside a selected site, or running into
+ * one.
+ */
+KmerSet get_region_kmers(KmerIndex const& kmer_index, PRG_Info const& prg_info,
+                         infer::SiteSelection const& selection,
+                         uint32_t kmer_size);
+
+RegionSelection select_regions(Regions const& regions,
+                               SegmentTracker const& tracker,
+                               KmerIndex const& kmer_index,
+                               PRG_Info const& prg_info, uint32_t kmer_size);
+
+/**
+ * Whether any kmer of `read` is in `kmers`.
+ */
+bool read_hits_kmers(Sequence const& read, uint32_t kmer_size,
+                     KmerSet const& kmers);
+}  // namespace gram::genotype
+
+#endif  // GRAMTOOLS_GENOTYPE_REGIONS_HPP
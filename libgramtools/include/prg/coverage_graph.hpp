@@ -4,7 +4,7 @@
  *  - Sequence nodes (`coverage_Node`). Each node has:
  *      - Nucleotide sequence
  *      - Outgoing edges (pointers) to other nodes
- *      - Coverage array to store per base coverage for each node
+ *      - Per base coverage, held in a store shared by all nodes
  *      - Site and allele ID
  *      - A position which refers to that in the original Multiple Sequence
  * Alignment
@@ -27,8 +27,10 @@
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unordered_map.hpp>
 #include <boost/serialization/vector.hpp>
+#include <limits>
 
 #include "linearised_prg.hpp"
+#include "prg/per_base_coverage.hpp"
 #include "prg/types.hpp"
 
 using namespace gram;
@@ -74,11 +76,25 @@ class coverage_Node {
    * Getters
    */
   std::size_t get_pos() const { return pos; }
-  std::string get_sequence() const { return sequence; }
+  std::string const& get_sequence() const { return sequence; }
   std::size_t get_sequence_size() const { return sequence.size(); }
-  int get_coverage_space() const { return coverage.size(); }
-  PerBaseCoverage const& get_coverage() const { return coverage; }
-  PerBaseCoverage& get_ref_to_coverage() { return coverage; }
+  /** Only variant site coverage gets used, so only nodes in sites have any */
+  int get_coverage_space() const {
+    return is_in_bubble() ? sequence.size() : 0;
+  }
+  /** A node not attached to a `PbCovStore` has zero coverage */
+  PerBaseCoverage get_coverage() const;
+  void increment_coverage(std::size_t base_index) {
+    cov_store->increment(cov_offset + base_index);
+  }
+  /** The cov ID of nodes not attached to a `PbCovStore` */
+  static constexpr std::size_t no_cov_ID{
+      std::numeric_limits<std::size_t>::max()};
+  /**
+   * Dense index of the node among those attached to its `PbCovStore`, usable
+   * to key per-node scratch space; `no_cov_ID` if not attached
+   */
+  std::size_t get_cov_ID() const { return cov_ID; }
   Marker get_site_ID() const { return site_ID; }
   AlleleId get_allele_ID() const { return allele_ID; }
   std::vector<covG_ptr> const& get_edges() const { return next; }
@@ -89,11 +105,12 @@ class coverage_Node {
    */
   void set_pos(std::size_t pos) { this->pos = pos; }
   void mark_as_boundary() { is_site_boundary = true; }
-  void set_coverage(PerBaseCoverage const& new_cov) {
-    assert(new_cov.size() == coverage.size() &&
-           new_cov.size() == sequence.size());
-    coverage = new_cov;
-  }
+  void set_coverage(PerBaseCoverage const& new_cov);
+  /**
+   * Gives the node counters in `store`, if it needs coverage and does not
+   * have any yet.
+   */
+  void attach_coverage(boost::shared_ptr<PbCovStore> const& store);
 
   void add_sequence(std::string const& new_seq);
   void add_edge(covG_ptr const target) { next.emplace_back(target); }
@@ -104,7 +121,9 @@ class coverage_Node {
   Marker site_ID;
   AlleleId allele_ID;
   std::size_t pos;
-  PerBaseCoverage coverage;
+  boost::shared_ptr<PbCovStore> cov_store;
+  std::size_t cov_offset; /**< Index of the node's first base in `cov_store` */
+  std::size_t cov_ID;
   bool is_site_boundary;
   std::vector<covG_ptr> next;
 
@@ -116,7 +135,9 @@ class coverage_Node {
     ar& site_ID;
     ar& allele_ID;
     ar& pos;
-    ar& coverage;
+    ar& cov_store;
+    ar& cov_offset;
+    ar& cov_ID;
     ar& is_site_boundary;
     ar& next;  // Array of shared pointers, needs custom includes
   }
@@ -211,6 +232,9 @@ class coverage_Graph {
   bool is_nested{false}; /**< Upon construction, gets set to true if graph has
                             nested bubbles */
 
+  boost::shared_ptr<PbCovStore> pb_cov_store; /**< Per base coverage of all the
+                                                 nodes in variant sites */
+
   friend bool operator==(coverage_Graph const& f, coverage_Graph const& s);
 
  private:
@@ -231,6 +255,7 @@ class coverage_Graph {
     ar& random_access;
     ar& target_map;
     ar& is_nested;
+    ar& pb_cov_store;
   }
 };
 
@@ -253,6 +278,7 @@ class cov_Graph_Builder {
   parental_map par_map;
   access_vec random_access;
   target_m target_map;
+  boost::shared_ptr<PbCovStore> pb_cov_store;
 
   void make_root(); /**< Start state: set up the globals such as `cur_Node` &
                        `backWire` */
@@ -294,6 +320,12 @@ class cov_Graph_Builder {
    */
   void add_exit_target(Marker cur_m, targeted_marker const new_t_m);
 
+  /**
+   * Gives per base coverage to the nodes in variant sites, laid out in PRG
+   * order in a single store.
+   */
+  void allocate_coverage();
+
   /*
    * variables & data structures
    */
@@ -8,7 +8,6 @@
 #define PRG_STRING_HPP
 
 #include <assert.h>
-#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <set>
@@ -31,8 +30,8 @@ class PRG_String {
 
   /**
    * Read in PRG String from binary int vector
-   * Reads byte per byte in specified endianness; the serialisor must write that
-   * way too.
+   * Reads the whole (memory-mapped) file at once, in specified endianness; the
+   * serialisor must write that way too.
    */
   PRG_String(std::string const &file_in, endianness en = endianness::little);
 
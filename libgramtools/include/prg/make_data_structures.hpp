@@ -28,6 +28,16 @@ FM_Index load_fm_index(CommonParameters const &parameters);
 coverage_Graph generate_cov_graph(CommonParameters const &parameters,
                                   PRG_String const &prg_string);
 
+/**
+ * Serialise where each site ends in the prg (`PRG_Info::last_allele_positions`)
+ * so that it can be loaded without reading the whole prg.
+ */
+void dump_site_ends(CommonParameters const &parameters,
+                    std::unordered_map<Marker, int> const &site_ends);
+
+std::unordered_map<Marker, int> load_site_ends(
+    CommonParameters const &parameters);
+
 /**
  * Build child_map from parental_map
  */
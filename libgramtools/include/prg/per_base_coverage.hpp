@@ -0,0 +1,118 @@
+/** @file
+ * Storage for the per base coverage of the `coverage_Node`s of a
+ * `coverage_Graph`.
+ * All counters live in one contiguous buffer, each `PB_COV_COUNTER_BITS`
+ * wide (set at build time). A counter saturates at its maximum, and further
+ * counts spill over to a 32-bit counter that only bases needing one get.
+ * Overflow counters are spread across shards by base index, each with its own
+ * lock, so that threads spilling over different bases rarely contend.
+ */
+#ifndef GRAMTOOLS_PER_BASE_COVERAGE_HPP
+#define GRAMTOOLS_PER_BASE_COVERAGE_HPP
+
+// Declares library_version_type, which unordered_map.hpp relies on
+#include <array>
+#include <boost/archive/basic_archive.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/vector.hpp>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/data_types.hpp"
+
+#ifndef PB_COV_COUNTER_BITS
+#define PB_COV_COUNTER_BITS 16
+#endif
+
+namespace gram {
+constexpr std::size_t PB_COV_OVERFLOW_SHARDS{64};
+
+#if PB_COV_COUNTER_BITS == 8
+using PbCovCounter = uint8_t;
+#elif PB_COV_COUNTER_BITS == 16
+using PbCovCounter = uint16_t;
+#elif PB_COV_COUNTER_BITS == 32
+using PbCovCounter = uint32_t;
+#else
+#error "PB_COV_COUNTER_BITS must be one of 8, 16 or 32"
+#endif
+
+class PbCovStore {
+ public:
+  using OverflowCounter = uint32_t;
+
+  PbCovStore() = default;
+
+  /**
+   * Reserves zeroed counters for `num_bases` consecutive bases.
+   * @return the index of the first of them.
+   */
+  std::size_t allocate(std::size_t num_bases);
+
+  /**
+   * Adds one to the coverage of a base. Safe to call from several threads at
+   * once, with no locking unless the base's counter is saturated.
+   */
+  void increment(std::size_t index);
+
+  /** Total coverage of a base, itself saturating at the maximum `CovCount` */
+  CovCount get(std::size_t index) const;
+  PerBaseCoverage get_range(std::size_t start, std::size_t num_bases) const;
+
+  /** Not safe to call concurrently with `increment` */
+  void set(std::size_t index, CovCount value);
+
+  std::size_t size() const { return counters.size(); }
+  /** Number of calls to `allocate` so far */
+  std::size_t num_allocations() const { return allocations; }
+  std::size_t num_overflow_counters() const;
+  /** Bytes used by the counters, including the overflow ones */
+  std::size_t memory_usage() const;
+
+ private:
+  std::vector<PbCovCounter> counters;
+  std::size_t allocations{0};
+  using OverflowCounters = std::unordered_map<std::size_t, OverflowCounter>;
+  struct OverflowShard {
+    mutable std::mutex mutex;
+    OverflowCounters counters;
+  };
+  std::array<OverflowShard, PB_COV_OVERFLOW_SHARDS> overflow_shards;
+
+  OverflowShard& get_overflow_shard(std::size_t index) {
+    return overflow_shards[index % PB_COV_OVERFLOW_SHARDS];
+  }
+  OverflowShard const& get_overflow_shard(std::size_t index) const {
+    return overflow_shards[index % PB_COV_OVERFLOW_SHARDS];
+  }
+
+  friend class boost::serialization::access;
+  // The overflow counters are archived as one map, independent of sharding
+  template <typename Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    OverflowCounters overflow_counters;
+    for (auto const& shard : overflow_shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      overflow_counters.insert(shard.counters.begin(), shard.counters.end());
+    }
+    ar& counters;
+    ar& allocations;
+    ar& overflow_counters;
+  }
+  template <typename Archive>
+  void load(Archive& ar, const unsigned int version) {
+    OverflowCounters overflow_counters;
+    ar& counters;
+    ar& allocations;
+    ar& overflow_counters;
+    for (auto& shard : overflow_shards) shard.counters.clear();
+    for (auto const& entry : overflow_counters)
+      get_overflow_shard(entry.first).counters.insert(entry);
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
+}  // namespace gram
+
+#endif  // GRAMTOOLS_PER_BASE_COVERAGE_HPP
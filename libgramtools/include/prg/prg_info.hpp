@@ -45,6 +45,14 @@ struct PRG_Info {
 
   uint64_t num_variant_sites;
 
+  /** Site and allele IDs of each PRG position, densely stored so that
+   * allele-encapsulated mappings are resolved without visiting graph nodes.
+   * Unlike `sites_mask` and `allele_mask`, these hold the innermost site of
+   * nested positions; positions outside variant sites get site 0.
+   * @see index_site_allele_IDs() */
+  std::vector<Marker> pos_site_IDs;
+  std::vector<AlleleId> pos_allele_IDs;
+
   // Only used for kmer indexing without `all-kmers`
   sdsl::int_vector<>
       sites_mask; /**< Stores the site number at each allele position. Variant
@@ -67,6 +75,19 @@ struct PRG_Info {
  */
 PRG_Info load_prg_info(CommonParameters const &parameters);
 
+/**
+ * Fills `pos_site_IDs` and `pos_allele_IDs` from the coverage graph, which must
+ * already be loaded.
+ */
+void index_site_allele_IDs(PRG_Info &prg_info);
+
+/**
+ * Hash of where each site ends in the prg, which files of coverage record to
+ * be checked against the prg they get loaded with. It is the same whatever
+ * the platform or library versions, as files can be moved between machines.
+ */
+uint64_t site_ends_hash(PRG_Info const &prg_info);
+
 }  // namespace gram
 
 #endif  // GRAMTOOLS_PRG_INFO_HPP
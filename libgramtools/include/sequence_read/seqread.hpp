@@ -162,6 +162,19 @@ class SeqRead {
 
   SeqIterator end() { return SeqIterator(this, -1); }
 
+  /**
+   * Bytes of the file read so far (before decompressing it, if compressed), or
+   * 0 if unknown (eg for sam/bam files).
+   */
+  uint64_t bytes_read() const {
+    long offset = -1;
+    if (file->gz_file != NULL)
+      offset = gzoffset(file->gz_file);
+    else if (file->f_file != NULL)
+      offset = ftell(file->f_file);
+    return offset < 0 ? 0 : offset;
+  }
+
   GenomicRead *next() {
     if (seq_read(file, read) > 0) {
       gr->name = read->name.b;
@@ -1,6 +1,7 @@
 #ifndef SIMU_PARAMETERS_HPP
 #define SIMU_PARAMETERS_HPP
 
+#include "common/data_types.hpp"
 #include "common/parameters.hpp"
 
 namespace gram {
@@ -11,6 +12,7 @@ class SimulateParams : public CommonParameters {
   std::string sample_id;
   uint64_t max_num_paths;
   std::string input_sequences_fpath;
+  Seed seed = std::nullopt; /**< Random if not set */
 };
 
 namespace commands::simulate {
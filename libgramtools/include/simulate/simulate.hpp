@@ -15,9 +15,10 @@ class SimulationGenotyper : public LevelGenotyper {
   /**
    * The genotyping process is the same in form to
    * `gram::genotype::infer::LevelGenotyper` except that genotype is randomly
-   * assigned among the list of alleles.
+   * assigned among the list of alleles, using `rand`.
    */
-  SimulationGenotyper(coverage_Graph const &cov_graph);
+  SimulationGenotyper(coverage_Graph const &cov_graph,
+                      RandomGenerator *const rand);
 
   /**
    * For taking in directly genotyped sites
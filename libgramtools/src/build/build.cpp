@@ -19,6 +19,7 @@ void commands::build::run(BuildParams const &parameters) {
             << ps.size() << std::endl;
 
   prg_info.last_allele_positions = ps.get_end_positions();
+  dump_site_ends(parameters, prg_info.last_allele_positions);
 
   std::cout << "Generating coverage graph" << std::endl;
   timer.start("Generate Coverage Graph");
@@ -1,3 +1,5 @@
+#include <omp.h>
+
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <iostream>
@@ -55,6 +57,7 @@ BuildParams commands::build::parse_parameters(
   parameters.all_kmers_flag = vm["all_kmers"].as<bool>();
   parameters.max_read_size = vm["max_read_size"].as<uint32_t>();
   parameters.maximum_threads = vm["max_threads"].as<uint32_t>();
+  omp_set_num_threads(parameters.maximum_threads);
 
   if (!parameters.all_kmers_flag and parameters.max_read_size == 0)
     throw std::invalid_argument(
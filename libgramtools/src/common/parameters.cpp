@@ -29,6 +29,7 @@ void gram::fill_common_parameters(CommonParameters& parameters,
   parameters.prg_coords_fpath = full_path(gram_dirpath, "prg_coords.tsv");
   parameters.fm_index_fpath = full_path(gram_dirpath, "fm_index");
   parameters.cov_graph_fpath = full_path(gram_dirpath, "cov_graph");
+  parameters.site_ends_fpath = full_path(gram_dirpath, "site_ends");
   parameters.sites_mask_fpath = full_path(gram_dirpath, "variant_site_mask");
   parameters.allele_mask_fpath = full_path(gram_dirpath, "allele_mask");
 
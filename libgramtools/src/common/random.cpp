@@ -17,4 +17,28 @@ uint32_t RandomInclusiveInt::generate(uint32_t min, uint32_t max) {
   std::uniform_int_distribution<uint32_t> range(min, max);
   return range(random_number_generator);
 }
+
+/** The splitmix64 finaliser: flips each output bit for about half of inputs */
+static uint64_t mix_bits(uint64_t bits) {
+  bits += 0x9e3779b97f4a7c15;
+  bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9;
+  bits = (bits ^ (bits >> 27)) * 0x94d049bb133111eb;
+  return bits ^ (bits >> 31);
+}
+
+/**
+ * Draws are those of splitmix64 started at `key`. Reducing 64 random bits to
+ * the (at most 2^32 wide) range by modulo biases it by under 2^-32.
+ */
+uint32_t CounterRandomInt::generate(uint32_t min, uint32_t max) {
+  uint64_t const range_size = uint64_t{max} - min + 1;
+  auto const bits = mix_bits(key + num_draws * 0x9e3779b97f4a7c15);
+  ++num_draws;
+  return min + static_cast<uint32_t>(bits % range_size);
+}
+
+SelectionKey derive_key(SeedSize const seed, uint64_t const stream,
+                        uint64_t const counter) {
+  return mix_bits(mix_bits(mix_bits(seed) ^ stream) ^ counter);
+}
 }  // namespace gram
@@ -1,5 +1,7 @@
 #include "genotype/genotype.hpp"
 
+#include <algorithm>
+
 #include "build/kmer_index/load.hpp"
 #include "common/timer_report.hpp"
 #include "genotype/infer/level_genotyping/runner.hpp"
@@ -7,7 +9,9 @@
 #include "genotype/infer/output_specs/make_vcf.hpp"
 #include "genotype/infer/output_specs/segment_tracker.hpp"
 #include "genotype/infer/personalised_reference.hpp"
+#include "genotype/quasimap/coverage/partial_coverage.hpp"
 #include "genotype/quasimap/quasimap.hpp"
+#include "genotype/regions.hpp"
 
 using namespace gram;
 using namespace gram::genotype;
@@ -30,25 +34,66 @@ void gram::commands::genotype::run(GenotypeParams const& parameters,
   std::cout << "Executing genotype command" << std::endl;
 
   ReadStats readstats;
-  std::string first_reads_fpath = parameters.reads_fpaths[0];
-  readstats.compute_base_error_rate(first_reads_fpath);
 
   timer.start("Load data");
   std::cout << "Loading PRG data" << std::endl;
   const auto prg_info = load_prg_info(parameters);
-  std::cout << "Loading kmer index data" << std::endl;
-  const auto kmer_index = kmer_index::load(parameters);
+  // Only used to map reads and select regions
+  KmerIndex kmer_index;
+  if (parameters.merge_coverage_fpaths.empty() ||
+      !parameters.regions_fpath.empty()) {
+    std::cout << "Loading kmer index data" << std::endl;
+    kmer_index = kmer_index::load(parameters);
+  }
   timer.stop();
 
-  std::cout << "Running quasimap" << std::endl;
-  timer.start("Quasimap");
-  auto quasimap_stats =
-      quasimap_reads(parameters, kmer_index, prg_info, readstats);
+  std::ifstream coords_file(parameters.prg_coords_fpath);
+  SegmentTracker tracker(coords_file);
+  coords_file.close();
 
-  // Commit the read stats into quasimap output dir.
-  std::cout << "Writing read stats to " << parameters.read_stats_fpath
-            << std::endl;
-  readstats.serialise(parameters.read_stats_fpath);
+  std::unique_ptr<RegionSelection> regions;
+  if (!parameters.regions_fpath.empty()) {
+    timer.start("Select regions");
+    std::ifstream bed_file(parameters.regions_fpath);
+    if (!bed_file.good())
+      throw RegionsException("Could not open " + parameters.regions_fpath);
+    regions = std::make_unique<RegionSelection>(
+        select_regions(load_bed(bed_file), tracker, kmer_index, prg_info,
+                       parameters.kmers_size));
+    auto const num_selected = std::count(regions->sites.begin(),
+                                         regions->sites.end(), true);
+    if (num_selected == 0)
+      throw RegionsException("No sites overlap the regions in " +
+                             parameters.regions_fpath);
+    std::cout << "Sites selected by regions: " << num_selected << std::endl;
+    timer.stop();
+  }
+
+  QuasimapReadsStats quasimap_stats;
+  if (parameters.merge_coverage_fpaths.empty()) {
+    std::cout << "Running quasimap" << std::endl;
+    timer.start("Quasimap");
+    quasimap_stats = quasimap_reads(parameters, kmer_index, prg_info, readstats,
+                                    regions.get());
+  } else {
+    timer.start("Merge coverage");
+    quasimap_stats = coverage::partial::merge_all(
+        parameters.merge_coverage_fpaths, readstats, prg_info);
+  }
+
+  if (parameters.quasimap_only) {
+    std::cout << "Writing partial coverage to "
+              << parameters.partial_coverage_fpath << std::endl;
+    coverage::partial::dump(parameters.partial_coverage_fpath, quasimap_stats,
+                            readstats, prg_info);
+  } else {
+    finalise_coverage(quasimap_stats, readstats, parameters, prg_info,
+                      regions.get());
+    // Commit the read stats into quasimap output dir.
+    std::cout << "Writing read stats to " << parameters.read_stats_fpath
+              << std::endl;
+    readstats.serialise(parameters.read_stats_fpath);
+  }
 
   std::cout << std::endl;
   std::cout
@@ -58,13 +103,40 @@ void gram::commands::genotype::run(GenotypeParams const& parameters,
             << std::endl;
   std::cout << "Count skipped reads with no sequence: "
             << quasimap_stats.skipped_reads_count << std::endl;
+  if (regions != nullptr)
+    std::cout << "Count reads skipped for not reaching the regions: "
+              << quasimap_stats.off_region_reads_count << std::endl;
   std::cout << "Count reads with >0 kmers not in kmer index: "
             << quasimap_stats.missing_kmer_reads_count << std::endl;
   std::cout << "Count reads with no exact mapping: "
             << quasimap_stats.no_extension_reads_count << std::endl;
   std::cout << "Count exact mapped reads: "
             << quasimap_stats.exact_mapped_reads_count << std::endl;
+  if (parameters.max_mismatches > 0)
+    std::cout << "Count reads mapped with substitutions: "
+              << quasimap_stats.inexact_mapped_reads_count << std::endl;
+  if (parameters.read_cache_size > 0) {
+    std::cout << "Count reads with mappings taken from the read cache: "
+              << quasimap_stats.cached_reads_count << std::endl;
+    std::cout << "Read cache memory (bytes): "
+              << quasimap_stats.read_cache_bytes << std::endl;
+  }
+  std::cout << "Count read batches: " << quasimap_stats.read_batches_count
+            << std::endl;
+  if (quasimap_stats.mapping_thread_seconds > 0) {
+    auto const thread_seconds = quasimap_stats.mapping_thread_seconds;
+    std::cout << "Thread time loading reads while mapping (%): "
+              << 100 * quasimap_stats.loading_thread_seconds / thread_seconds
+              << std::endl;
+    std::cout << "Thread time idle while mapping (%): "
+              << 100 * quasimap_stats.idle_thread_seconds / thread_seconds
+              << std::endl;
+  }
   timer.stop();
+  if (parameters.quasimap_only) {
+    timer.report();
+    return;
+  }
 
   /**
    * Infer
@@ -87,19 +159,22 @@ void gram::commands::genotype::run(GenotypeParams const& parameters,
                            readstats,
                            parameters.ploidy,
                            true,
-                           debug_file};
-
-  std::ifstream coords_file(parameters.prg_coords_fpath);
-  SegmentTracker tracker(coords_file);
-  coords_file.close();
+                           debug_file,
+                           parameters.max_allele_combinations,
+                           regions == nullptr ? SiteSelection{}
+                                              : regions->sites};
+  if (genotyper.get_num_dropped_alleles() > 0)
+    std::cout << "Nested site alleles dropped to stay within "
+              << parameters.max_allele_combinations
+              << " allele combinations: "
+              << genotyper.get_num_dropped_alleles() << std::endl;
 
   std::cout << "Producing json vcf" << std::endl;
   std::ofstream geno_json_fhandle(parameters.genotyped_json_fpath);
   auto gtyper = std::make_shared<LevelGenotyper>(genotyper);
-  auto sample_json = make_json_prg(gtyper, tracker);
-  sample_json->set_sample_info(parameters.sample_id,
-                               "made by gramtools genotype");
-  geno_json_fhandle << sample_json->get_prg() << std::endl;
+  write_json_prg(geno_json_fhandle, gtyper, tracker, parameters.sample_id,
+                 "made by gramtools genotype");
+  geno_json_fhandle << std::endl;
   geno_json_fhandle.close();
 
   std::cout << "Producing personalised reference" << std::endl;
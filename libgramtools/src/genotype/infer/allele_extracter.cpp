@@ -3,13 +3,62 @@
 #include "genotype/infer/interfaces.hpp"
 #include "prg/coverage_graph.hpp"
 
-#define MAX_COMBINATIONS 10000
-
 using namespace gram::genotype::infer;
 
+void AlleleProduct::paste(Allele const& allele) {
+  if (segments.back().size() == 1)
+    segments.back().at(0) = segments.back().at(0) + allele;
+  else
+    segments.push_back(allele_vector{allele});
+}
+
+void AlleleProduct::combine(allele_vector const& alleles) {
+  segments.push_back(alleles);
+  num_combinations *= alleles.size();
+}
+
+std::vector<std::size_t> AlleleProduct::get_choices(std::size_t index) const {
+  std::vector<std::size_t> choices(segments.size());
+  for (auto segment_index = segments.size(); segment_index-- > 0;) {
+    auto const num_choices = segments[segment_index].size();
+    choices[segment_index] = index % num_choices;
+    index /= num_choices;
+  }
+  return choices;
+}
+
+Allele AlleleProduct::at(std::size_t index) const {
+  assert(index < num_combinations);
+  auto const choices = get_choices(index);
+  std::size_t total_length{0};
+  for (std::size_t i{0}; i < segments.size(); ++i)
+    total_length += segments[i][choices[i]].sequence.size();
+
+  // The first segment's haplogroup is kept
+  Allele result = segments[0][choices[0]];
+  result.sequence.reserve(total_length);
+  result.pbCov.reserve(total_length);
+  for (std::size_t i{1}; i < segments.size(); ++i) {
+    auto const& part = segments[i][choices[i]];
+    result.sequence.append(part.sequence);
+    result.pbCov.insert(result.pbCov.end(), part.pbCov.begin(),
+                        part.pbCov.end());
+    result.nesting_consistent &= part.nesting_consistent;
+  }
+  return result;
+}
+
+allele_vector AlleleProduct::materialise() const {
+  allele_vector result;
+  result.reserve(num_combinations);
+  for (std::size_t index{0}; index < num_combinations; ++index)
+    result.push_back(at(index));
+  return result;
+}
+
 AlleleExtracter::AlleleExtracter(covG_ptr site_start, covG_ptr site_end,
-                                 gt_sites& sites)
-    : genotyped_sites(&sites) {
+                                 gt_sites& sites, std::size_t max_combinations)
+    : genotyped_sites(&sites), max_combinations(max_combinations) {
   assert(site_start->is_bubble_start());
   AlleleId haplogroup_ID{FIRST_ALLELE};
 
@@ -22,8 +71,8 @@ AlleleExtracter::AlleleExtracter(covG_ptr site_start, covG_ptr site_end,
   }
 }
 
-allele_vector AlleleExtracter::allele_combine(allele_vector const& existing,
-                                              std::size_t site_index) {
+void AlleleExtracter::allele_combine(AlleleProduct& existing,
+                                     std::size_t site_index) {
   // Sanity check: site_index refers to actual site
   assert(0 <= site_index && site_index < genotyped_sites->size());
   gt_site_ptr referent_site = genotyped_sites->at(site_index);
@@ -41,26 +90,19 @@ allele_vector AlleleExtracter::allele_combine(allele_vector const& existing,
   // Avoid combinatorial blowups, by removing first the extra_alleles
   // (case: too many nested low conf calls), then the genotyped alleles
   // (case: too many nested heterozygous calls in diploid calling)
-  while (existing.size() * relevant_alleles.size() > MAX_COMBINATIONS)
-    relevant_alleles.resize(relevant_alleles.size() - 1);
-
-  allele_vector combinations(existing.size() * relevant_alleles.size());
-
-  std::size_t insertion_index{0};
-  for (auto const& allele : existing) {
-    for (auto const& added_allele : relevant_alleles) {
-      combinations.at(insertion_index) = allele + added_allele;
-      ++insertion_index;
-    }
+  while (relevant_alleles.size() > 1 &&
+         existing.size() * relevant_alleles.size() > max_combinations) {
+    relevant_alleles.pop_back();
+    ++num_dropped_alleles;
   }
-  return combinations;
+
+  existing.combine(relevant_alleles);
 }
 
-void AlleleExtracter::allele_paste(allele_vector& existing,
+void AlleleExtracter::allele_paste(AlleleProduct& existing,
                                    covG_ptr sequence_node) {
-  Allele to_paste_allele{sequence_node->get_sequence(),
-                         sequence_node->get_coverage()};
-  for (auto& allele : existing) allele = allele + to_paste_allele;
+  existing.paste(
+      Allele{sequence_node->get_sequence(), sequence_node->get_coverage()});
 }
 
 void AlleleExtracter::place_ref_as_first_allele(allele_vector& alleles,
@@ -91,15 +133,15 @@ Allele gram::genotype::infer::extract_ref_allele(covG_ptr start_node,
 allele_vector AlleleExtracter::extract_alleles(AlleleId const haplogroup,
                                                covG_ptr haplogroup_start,
                                                covG_ptr site_end) {
-  allele_vector haplogroup_alleles{
-      {"", {}, haplogroup}};  // Make one empty allele as starting point, allows
-                              // for direct deletion
+  AlleleProduct haplogroup_alleles{allele_vector{
+      {"", {}, haplogroup}}};  // Make one empty allele as starting point,
+                               // allows for direct deletion
   covG_ptr cur_Node{haplogroup_start};
 
   while (cur_Node != site_end) {
     if (cur_Node->is_bubble_start()) {
       auto site_index = siteID_to_index(cur_Node->get_site_ID());
-      haplogroup_alleles = allele_combine(haplogroup_alleles, site_index);
+      allele_combine(haplogroup_alleles, site_index);
 
       auto referent_site = genotyped_sites->at(site_index);
       cur_Node =
@@ -115,10 +157,11 @@ allele_vector AlleleExtracter::extract_alleles(AlleleId const haplogroup,
     cur_Node = *(cur_Node->get_edges().begin());  // Advance to the next node
   }
 
+  auto result = haplogroup_alleles.materialise();
   if (haplogroup == 0) {
     auto ref_allele = extract_ref_allele(haplogroup_start, site_end);
-    place_ref_as_first_allele(haplogroup_alleles, ref_allele);
+    place_ref_as_first_allele(result, ref_allele);
   }
 
-  return haplogroup_alleles;
+  return result;
 }
@@ -43,6 +43,7 @@ LevelGenotyperModel::LevelGenotyperModel(ModelData& input_data)
 
   allele_vector used_alleles(data.input_alleles);
   assign_coverage_to_empty_alleles(used_alleles);
+  set_likelihood_terms(used_alleles);
 
   if (data.ploidy == Ploidy::Haploid)
     compute_haploid_log_likelihoods(used_alleles);
@@ -237,11 +238,37 @@ std::vector<GtypedIndices> LevelGenotyperModel::get_permutations(
   return result;
 }
 
-void LevelGenotyperModel::add_likelihood(allele_vector const& alleles,
-                                         double const& incompatible_coverage,
-                                         GtypedIndices const& allele_indices) {
+AlleleLikelihoodTerms LevelGenotyperModel::get_likelihood_terms(
+    Allele const& allele) {
+  auto compatible_coverage = allele.get_average_cov();
+  auto gap_penalty = fraction_noncredible_positions(allele);
+  return AlleleLikelihoodTerms{
+      (*data.l_stats->pmf_full_depth)(compatible_coverage),
+      gap_penalty * data.l_stats->log_zero};
+}
+
+void LevelGenotyperModel::set_likelihood_terms(
+    allele_vector const& input_alleles) {
+  allele_terms.clear();
+  allele_terms.reserve(input_alleles.size());
+  for (auto const& allele : input_alleles)
+    allele_terms.push_back(get_likelihood_terms(allele));
+}
+
+double LevelGenotyperModel::compute_log_likelihood(
+    double const& incompatible_coverage,
+    std::vector<AlleleLikelihoodTerms> const& allele_terms) const {
   double log_likelihood =
       incompatible_coverage * data.l_stats->log_mean_pb_error;
+  for (auto const& terms : allele_terms) {
+    log_likelihood += terms.coverage_term;
+    log_likelihood += terms.gap_term;
+  }
+  return log_likelihood;
+}
+
+void LevelGenotyperModel::add_likelihood(double const& incompatible_coverage,
+                                         GtypedIndices const& allele_indices) {
   uint8_t stop_index;
   switch (data.ploidy) {
     case Ploidy::Haploid:
@@ -254,19 +281,13 @@ void LevelGenotyperModel::add_likelihood(allele_vector const& alleles,
       throw UnsupportedPloidy("");
   }
 
-  assert(alleles.size() == stop_index);
   assert(allele_indices.size() == stop_index);
-  double compatible_coverage, gap_penalty;
-  for (uint8_t i = 0; i < stop_index; i++) {
-    auto const& allele = alleles.at(i);
-    compatible_coverage = allele.get_average_cov();
-    gap_penalty = fraction_noncredible_positions(allele);
-    log_likelihood +=
-        data.l_stats->pmf_full_depth->operator()(params{compatible_coverage});
-    log_likelihood += gap_penalty * data.l_stats->log_zero;
-  }
+  std::vector<AlleleLikelihoodTerms> terms;
+  for (uint8_t i = 0; i < stop_index; i++)
+    terms.push_back(allele_terms.at(allele_indices.at(i)));
 
-  likelihoods.insert({log_likelihood, allele_indices});
+  likelihoods.insert(
+      {compute_log_likelihood(incompatible_coverage, terms), allele_indices});
 }
 
 void LevelGenotyperModel::compute_haploid_log_likelihoods(
@@ -278,8 +299,7 @@ void LevelGenotyperModel::compute_haploid_log_likelihoods(
     if (allele_index == 0 && ignore_ref_allele()) continue;
     auto haploid_cov = haploid_allele_coverages.at(allele.haplogroup);
     auto incompatible_coverage = total_coverage - haploid_cov;
-    add_likelihood(allele_vector{allele}, incompatible_coverage,
-                   GtypedIndices{allele_index});
+    add_likelihood(incompatible_coverage, GtypedIndices{allele_index});
   }
 }
 
@@ -297,11 +317,27 @@ void LevelGenotyperModel::compute_homozygous_log_likelihoods(
     auto incompatible_coverage =
         total_coverage - coverages.first - coverages.second;
 
-    add_likelihood(allele_vector{allele, allele}, incompatible_coverage,
+    add_likelihood(incompatible_coverage,
                    GtypedIndices{allele_index, allele_index});
   }
 }
 
+static bool is_nesting_consistent(allele_vector const& alleles,
+                                  GtypedIndices const& gtype) {
+  for (auto const& gt : gtype) {
+    if (!alleles.at(gt).nesting_consistent) return false;
+  }
+  return true;
+}
+
+/**
+ * Min-heap on likelihood, so that the least likely candidate is evicted first
+ */
+static bool less_likely_last(GenotypeCandidate const& first,
+                             GenotypeCandidate const& second) {
+  return first.log_likelihood > second.log_likelihood;
+}
+
 void LevelGenotyperModel::compute_heterozygous_log_likelihoods(
     allele_vector const& input_alleles,
     multiplicities const& haplogroup_multiplicities) {
@@ -316,20 +352,95 @@ void LevelGenotyperModel::compute_heterozygous_log_likelihoods(
 
   if (selected_indices.size() < 2) return;
 
-  auto all_diploid_combos = get_permutations(selected_indices, 2);
+  std::vector<AlleleLikelihoodTerms> selected_terms;
+  for (auto const& index : selected_indices)
+    selected_terms.push_back(allele_terms.at(index));
+
+  // A genotype can only be called, or be next best to the called genotype, if
+  // it ranks above the second best nesting-consistent genotype. Ties rank in
+  // scoring order, so equally likely later candidates can be pruned too.
+  std::size_t num_consistent{0};
+  double best_consistent{0}, second_best_consistent{0};
+  for (auto const& entry : likelihoods) {
+    if (!is_nesting_consistent(input_alleles, entry.second)) continue;
+    if (num_consistent++ == 0)
+      best_consistent = entry.first;
+    else {
+      second_best_consistent = entry.first;
+      break;
+    }
+  }
+  auto cannot_be_called = [&](double const log_likelihood) {
+    return num_consistent >= 2 && !(log_likelihood > second_best_consistent);
+  };
+  // The bound below requires incompatible coverage to lower the likelihood
+  bool const can_bound = data.l_stats->log_mean_pb_error <= 0;
+
+  std::vector<GenotypeCandidate> candidates;
+  std::size_t num_scored{0};
+  // Iterates over pairs in the same order as `get_permutations`
+  for (std::size_t first{0}; first < selected_indices.size(); ++first) {
+    auto const& allele_1 = input_alleles.at(selected_indices[first]);
+    for (std::size_t second{first + 1}; second < selected_indices.size();
+         ++second) {
+      auto const& allele_2 = input_alleles.at(selected_indices[second]);
+      std::vector<AlleleLikelihoodTerms> terms{selected_terms[first],
+                                               selected_terms[second]};
+      GtypedIndices combo{selected_indices[first], selected_indices[second]};
+
+      if (can_bound && num_consistent >= 2) {
+        // Diploid coverages never exceed haploid coverages, so this
+        // underestimates the incompatible coverage
+        double min_incompatible_coverage = std::max(
+            0., (double)total_coverage -
+                    haploid_allele_coverages.at(allele_1.haplogroup) -
+                    haploid_allele_coverages.at(allele_2.haplogroup));
+        if (cannot_be_called(
+                compute_log_likelihood(min_incompatible_coverage, terms))) {
+          ++num_pruned_genotypes;
+          continue;
+        }
+      }
 
-  for (auto const& combo : all_diploid_combos) {
-    Allele allele_1 = input_alleles.at(combo.at(0));
-    Allele allele_2 = input_alleles.at(combo.at(1));
-    AlleleIds haplogroups{allele_1.haplogroup, allele_2.haplogroup};
-    auto coverages = compute_diploid_coverage(data.gp_counts, haplogroups,
-                                              haplogroup_multiplicities);
-    auto incompatible_coverage =
-        total_coverage - coverages.first - coverages.second;
+      AlleleIds haplogroups{allele_1.haplogroup, allele_2.haplogroup};
+      auto coverages = compute_diploid_coverage(data.gp_counts, haplogroups,
+                                                haplogroup_multiplicities);
+      auto incompatible_coverage =
+          total_coverage - coverages.first - coverages.second;
+      auto log_likelihood =
+          compute_log_likelihood(incompatible_coverage, terms);
+      if (cannot_be_called(log_likelihood)) {
+        ++num_pruned_genotypes;
+        continue;
+      }
 
-    add_likelihood(allele_vector{allele_1, allele_2}, incompatible_coverage,
-                   combo);
+      candidates.push_back(
+          GenotypeCandidate{log_likelihood, num_scored++, combo});
+      std::push_heap(candidates.begin(), candidates.end(), less_likely_last);
+      if (!is_nesting_consistent(input_alleles, combo)) continue;
+
+      if (num_consistent++ == 0 || log_likelihood > best_consistent) {
+        second_best_consistent = best_consistent;
+        best_consistent = log_likelihood;
+      } else
+        second_best_consistent = log_likelihood;
+      if (num_consistent < 2) continue;
+
+      while (candidates.front().log_likelihood < second_best_consistent) {
+        std::pop_heap(candidates.begin(), candidates.end(), less_likely_last);
+        candidates.pop_back();
+        ++num_pruned_genotypes;
+      }
+    }
   }
+
+  std::sort(
+      candidates.begin(), candidates.end(),
+      [](GenotypeCandidate const& first, GenotypeCandidate const& second) {
+        return first.order < second.order;
+      });
+  for (auto& candidate : candidates)
+    likelihoods.insert({candidate.log_likelihood, std::move(candidate.gtype)});
 }
 
 void LevelGenotyperModel::add_next_best_alleles(
@@ -376,20 +487,8 @@ likelihood_map::const_iterator LevelGenotyperModel::ChooseMaxLikelihood(
         "Less than 2 alleles have a likelihood.\n"
         "Allele extraction bug?");
   auto it = likelihoods.begin();
-  while (it != likelihoods.end()) {
-    bool inconsistent = false;
-    auto chosen_gt = it->second;
-    for (auto const& gt : chosen_gt) {
-      if (!alleles.at(gt).nesting_consistent) {
-        inconsistent = true;
-        break;
-      }
-    }
-    if (inconsistent)
-      ++it;
-    else
-      break;
-  }
+  while (it != likelihoods.end() && !is_nesting_consistent(alleles, it->second))
+    ++it;
   if (std::distance(it, likelihoods.end()) < 2)
     throw IncorrectGenotyping(
         "Fewer than 2 alleles are consistent with child"
@@ -463,6 +562,10 @@ void LevelGenotyperModel::CallGenotype(allele_vector const& input_alleles,
       debug_info.append(std::to_string(haploid_allele_coverages.at(hapg)));
       debug_info.append(",");
     }
+    if (ploidy == Ploidy::Diploid) {
+      debug_info.append("\tpruned_gts: ");
+      debug_info.append(std::to_string(num_pruned_genotypes));
+    }
     genotyped_site->set_debug_info(debug_info);
   }
 }
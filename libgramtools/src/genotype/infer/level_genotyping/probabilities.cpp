@@ -1,39 +1,48 @@
 #include "genotype/infer/level_genotyping/probabilities.hpp"
 
-#include <assert.h>
-
+#include <algorithm>
 #include <cmath>
 
 namespace gram::genotype::infer::probabilities {
-double AbstractPmf::operator()(params const& query) {
-  if (probs.find(query) != probs.end())
-    return probs.at(query);
-  else {
-    auto prob = compute_prob(query);
-    probs.insert(std::pair<params, double>(query, prob));
-    return prob;
+void AbstractPmf::tabulate(std::size_t const max_cov) {
+  probs.resize(max_cov + 1);
+  for (std::size_t cov{0}; cov <= max_cov; ++cov)
+    probs[cov] = compute_prob(static_cast<double>(cov));
+}
+
+double AbstractPmf::operator()(double const cov) const {
+  if (cov >= 0 && cov < probs.size()) {
+    auto const as_index = static_cast<std::size_t>(cov);
+    if (as_index == cov) return probs[as_index];
   }
+  return compute_prob(cov);
+}
+
+/**
+ * Tabulated coverages extend well into the upper tail of the distribution, so
+ * that in practice only fractional coverages get computed on lookup.
+ */
+static std::size_t max_tabulated_cov(double const mean_cov) {
+  if (!(4 * mean_cov > min_tabulated_covs)) return min_tabulated_covs;
+  return static_cast<std::size_t>(
+      std::min(4 * mean_cov, static_cast<double>(max_tabulated_covs)));
 }
 
-double PoissonLogPmf::compute_prob(params const& query) const {
-  assert(query.size() == 1);
-  auto cov{query.at(0)};
+double PoissonLogPmf::compute_prob(double const cov) const {
   return (-1 * lambda + cov * log(lambda) - lgamma(cov + 1));
 }
 
 PoissonLogPmf::PoissonLogPmf(params const& parameterisation)
     : lambda(parameterisation[0]) {
-  operator()(params{0});
+  tabulate(max_tabulated_cov(lambda));
 }
 
 NegBinomLogPmf::NegBinomLogPmf(params const& parameterisation)
     : k(parameterisation[0]), p(parameterisation[1]), AbstractPmf() {
-  operator()(params{0});
+  tabulate(max_tabulated_cov(k * (1 - p) / p));
 }
 
-double NegBinomLogPmf::compute_prob(params const& query) const {
-  assert(query.size() == 1);
-  auto cov{query.at(0)};
+double NegBinomLogPmf::compute_prob(double const cov) const {
   return (lgamma(k + cov) - lgamma(cov + 1) - lgamma(k) + k * log(p) +
           cov * log(1 - p));
 }
@@ -24,13 +24,33 @@ void add_percentiles(gt_sites const& input_sites,
   }
 }
 
+/**
+ * Sites outside the selection do not get genotyped: they get a null genotype
+ * on their REF allele, which is what the personalised reference then uses.
+ */
+static gt_site_ptr make_unselected_site(covG_ptr const& site_start,
+                                        covG_ptr const& site_end) {
+  auto result = std::make_shared<LevelGenotypedSite>();
+  result->set_alleles(allele_vector{extract_ref_allele(site_start, site_end)});
+  result->make_null();
+  result->set_pos(site_start->get_pos());
+  result->set_site_end_node(site_end);
+  return result;
+}
+
 LevelGenotyper::LevelGenotyper(coverage_Graph const& cov_graph,
                                SitesGroupedAlleleCounts const& gped_covs,
                                ReadStats const& read_stats, Ploidy const ploidy,
-                               bool get_gcp, std::string debug_fpath)
+                               bool get_gcp, std::string debug_fpath,
+                               std::size_t max_allele_combinations,
+                               SiteSelection const& selection)
     : ploidy(ploidy) {
   this->cov_graph = &cov_graph;
   this->gped_covs = &gped_covs;
+  if (!selection.empty() && selection.size() != cov_graph.bubble_map.size())
+    throw std::invalid_argument(
+        "Site selection does not have one entry per site");
+  site_selection = selection;
   child_m =
       build_child_map(cov_graph.par_map);  // Required for site invalidation
   genotyped_records.resize(
@@ -54,10 +74,17 @@ LevelGenotyper::LevelGenotyper(coverage_Graph const& cov_graph,
   for (auto const& bubble_pair : cov_graph.bubble_map) {
     auto site_ID = bubble_pair.first->get_site_ID();
     auto site_index = siteID_to_index(site_ID);
+    if (!is_selected(site_index)) {
+      genotyped_records.at(site_index) =
+          make_unselected_site(bubble_pair.first, bubble_pair.second);
+      continue;
+    }
 
-    auto extracter = AlleleExtracter(bubble_pair.first, bubble_pair.second,
-                                     genotyped_records);
+    auto extracter =
+        AlleleExtracter(bubble_pair.first, bubble_pair.second,
+                        genotyped_records, max_allele_combinations);
     auto extracted_alleles = extracter.get_alleles();
+    num_dropped_alleles += extracter.get_num_dropped_alleles();
     auto& gped_covs_for_site = gped_covs.at(site_index);
 
     ModelData data(extracted_alleles, gped_covs_for_site, ploidy, &l_stats,
@@ -68,6 +95,9 @@ LevelGenotyper::LevelGenotyper(coverage_Graph const& cov_graph,
 
     if (debug_file.is_open()) {
       debug_file << "site index: \t" << site_index;
+      if (extracter.get_num_dropped_alleles() > 0)
+        debug_file << "\tdropped_nested_alleles: "
+                   << extracter.get_num_dropped_alleles();
       if (genotyped_site->is_null())
         debug_file << "\tnull gt \n";
       else {
@@ -91,8 +121,11 @@ LevelGenotyper::LevelGenotyper(coverage_Graph const& cov_graph,
       uppropagate_filter("AMBIG", site_ID);
   }
   if (get_gcp) {
-    auto confidences = get_gtconf_distrib(genotyped_records, l_stats, ploidy);
-    add_percentiles(genotyped_records, confidences);
+    gt_sites selected_records;
+    for (std::size_t i{0}; i < genotyped_records.size(); ++i)
+      if (is_selected(i)) selected_records.push_back(genotyped_records.at(i));
+    auto confidences = get_gtconf_distrib(selected_records, l_stats, ploidy);
+    add_percentiles(selected_records, confidences);
   }
 }
 
@@ -237,8 +270,8 @@ likelihood_related_stats LevelGenotyper::make_l_stats(
   return likelihood_related_stats{
       data_params,
       log(mean_pb_error),
-      pmf->operator()(params{0}),
-      pmf_half_depth->operator()(params{0}),
+      (*pmf)(0),
+      (*pmf_half_depth)(0),
       prob_no_zero,
       prob_no_zero_half_depth,
       find_minimum_non_error_cov(mean_pb_error, pmf),
@@ -249,7 +282,7 @@ likelihood_related_stats LevelGenotyper::make_l_stats(
 CovCount LevelGenotyper::find_minimum_non_error_cov(double mean_pb_error,
                                                     pmf_ptr pmf) {
   double min_count{1};
-  while ((*pmf)(params{min_count}) <= min_count * log(mean_pb_error))
+  while ((*pmf)(min_count) <= min_count * log(mean_pb_error))
     ++min_count;
   return min_count;
 }
@@ -0,0 +1,180 @@
+#include "genotype/infer/output_specs/json_combine.hpp"
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+
+#include "genotype/infer/output_specs/json_prg_spec.hpp"
+#include "genotype/infer/output_specs/json_prg_stream.hpp"
+#include "genotype/infer/output_specs/json_site_spec.hpp"
+
+namespace fs = std::filesystem;
+using namespace gram::json;
+
+/**
+ * Calls `f(i)` for all i in [0, n) across threads.
+ * Exceptions cannot leave an OpenMP region, so they are rethrown after it.
+ */
+template <typename Function>
+static void parallel_for_each_index(std::size_t const n, Function const& f) {
+  std::vector<std::exception_ptr> errors(n);
+#pragma omp parallel for
+  for (std::size_t i = 0; i < n; ++i) {
+    try {
+      f(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+  for (auto const& error : errors)
+    if (error) std::rethrow_exception(error);
+}
+
+JSON gram::json::combine_headers(std::vector<JSON> const& headers,
+                                 bool const force) {
+  JSON result = headers.at(0);
+  for (std::size_t i{1}; i < headers.size(); i++) {
+    Json_Prg::check_combinable(result, headers.at(i));
+    Json_Prg::append_samples(result.at("Samples"), headers.at(i).at("Samples"),
+                             force);
+  }
+  return result;
+}
+
+JSON gram::json::combine_sites(std::vector<JSON>& sites,
+                               std::string const& gtyping_model,
+                               bool const keep_uncalled_alleles) {
+  auto& first = sites.at(0);
+  for (std::size_t i{1}; i < sites.size(); i++)
+    Json_Site::check_combinable(first, sites.at(i));
+  if (sites.size() == 1) return std::move(first);
+
+  std::string const ref = first.at("ALS").at(0);
+  allele_combi_map m{{ref, site_rescaler{0, 0}}};  // Always place the REF
+  for (auto const& site : sites) Json_Site::build_allele_combi_map(site, m);
+  if (keep_uncalled_alleles) {
+    for (auto const& site : sites) {
+      for (std::string const allele : site.at("ALS"))
+        m.insert({allele, site_rescaler{m.size(), 0}});
+    }
+  }
+
+  Json_Site result(std::move(first));
+  result.rescale_entries(m);
+  for (std::size_t i{1}; i < sites.size(); i++) {
+    Json_Site other(std::move(sites.at(i)));
+    other.rescale_entries(m);
+    result.append_trivial_entries_from(other.get_site());
+    result.add_model_specific_entries_from(other.get_site(), gtyping_model);
+  }
+  result.get_site().at("ALS") = Json_Site::get_all_alleles(m);
+  return std::move(result.get_site());
+}
+
+void gram::json::combine_jsons(std::vector<std::istream*> const& inputs,
+                               std::ostream& out, combine_params const& params,
+                               bool const keep_uncalled_alleles) {
+  auto const num_inputs = inputs.size();
+  std::vector<Json_Prg_Reader> readers;
+  std::vector<JSON> headers;
+  readers.reserve(num_inputs);
+  for (auto const input : inputs) {
+    readers.emplace_back(*input);
+    headers.push_back(readers.back().get_header());
+  }
+
+  auto const combined_header = combine_headers(headers, params.force);
+  std::string const gtyping_model = combined_header.at("Model");
+  Json_Prg_Writer writer(out, combined_header);
+
+  auto const chunk_size = std::max<std::size_t>(params.chunk_size, 1);
+  std::vector<std::vector<JSON>> chunks(num_inputs);
+  std::vector<JSON> combined_sites;
+  std::size_t num_read;
+  do {
+    parallel_for_each_index(num_inputs, [&](std::size_t const i) {
+      auto const num_samples = headers.at(i).at("Samples").size();
+      auto& chunk = chunks.at(i);
+      chunk.clear();
+      JSON site;
+      while (chunk.size() < chunk_size && readers.at(i).next_site(site)) {
+        if (site.at("GT").size() != num_samples)
+          throw JSONConsistencyException(
+              "Merged in JSON does not have number of GT arrays"
+              " consistent with its number of Samples");
+        chunk.push_back(std::move(site));
+      }
+    });
+    num_read = chunks.at(0).size();
+    for (auto const& chunk : chunks) {
+      if (chunk.size() != num_read)
+        throw JSONCombineException(
+            "JSONs do not have the same number of sites");
+    }
+
+    combined_sites.resize(num_read);
+    parallel_for_each_index(num_read, [&](std::size_t const j) {
+      std::vector<JSON> site_group(num_inputs);
+      for (std::size_t i{0}; i < num_inputs; i++)
+        site_group.at(i) = std::move(chunks.at(i).at(j));
+      combined_sites.at(j) =
+          combine_sites(site_group, gtyping_model, keep_uncalled_alleles);
+    });
+    for (auto const& site : combined_sites) writer.add_site(site);
+  } while (num_read == chunk_size);
+  writer.close();
+}
+
+static void combine_files_into(strings const& fpaths,
+                               std::string const& out_fpath,
+                               combine_params const& params,
+                               bool const keep_uncalled_alleles) {
+  std::vector<std::ifstream> input_files;
+  std::vector<std::istream*> inputs;
+  input_files.reserve(fpaths.size());
+  for (auto const& fpath : fpaths) {
+    input_files.emplace_back(fpath);
+    if (!input_files.back().good())
+      throw JSONCombineException("Could not open JSON file " + fpath);
+    inputs.push_back(&input_files.back());
+  }
+
+  std::ofstream out(out_fpath);
+  if (!out.good())
+    throw JSONCombineException("Could not open JSON file " + out_fpath);
+  combine_jsons(inputs, out, params, keep_uncalled_alleles);
+}
+
+void gram::json::combine_json_files(strings const& fpaths,
+                                    std::string const& out_fpath,
+                                    combine_params const& params) {
+  if (fpaths.empty()) throw JSONCombineException("No JSON files to combine");
+  std::size_t const max_inputs =
+      params.max_inputs_per_merge == 0
+          ? fpaths.size()
+          : std::max<std::size_t>(params.max_inputs_per_merge, 2);
+
+  strings level_fpaths{fpaths};
+  std::size_t level{0};
+  while (level_fpaths.size() > max_inputs) {
+    strings next_level_fpaths;
+    for (std::size_t start{0}; start < level_fpaths.size();
+         start += max_inputs) {
+      auto const end = std::min(start + max_inputs, level_fpaths.size());
+      strings const group(level_fpaths.begin() + start,
+                          level_fpaths.begin() + end);
+      auto const tmp_fpath = out_fpath + ".tmp" + std::to_string(level) + "_" +
+                             std::to_string(next_level_fpaths.size());
+      combine_files_into(group, tmp_fpath, params, true);
+      next_level_fpaths.push_back(tmp_fpath);
+    }
+    if (level > 0)
+      for (auto const& fpath : level_fpaths) fs::remove(fpath);
+    level_fpaths = std::move(next_level_fpaths);
+    level++;
+  }
+
+  combine_files_into(level_fpaths, out_fpath, params, false);
+  if (level > 0)
+    for (auto const& fpath : level_fpaths) fs::remove(fpath);
+}
@@ -46,11 +46,15 @@ void Json_Prg::add_samples(Json_Prg& other, const bool force) {
         "Merged in JSON does not have number of GT arrays"
         " consistent with its number of Samples");
 
+  append_samples(json_prg.at("Samples"), other_prg.at("Samples"), force);
+}
+
+void Json_Prg::append_samples(JSON& samples, JSON other_samples,
+                              bool const force) {
   std::map<std::string, std::size_t> duplicates;
-  for (auto const& e : json_prg.at("Samples"))
-    duplicates.insert({e.at("Name"), 1});
+  for (auto const& e : samples) duplicates.insert({e.at("Name"), 1});
 
-  for (auto& sample_entry : other_prg.at("Samples")) {
+  for (auto& sample_entry : other_samples) {
     std::string const name = sample_entry.at("Name");
     std::string used_name = name;
     if (duplicates.find(name) != duplicates.end()) {
@@ -66,24 +70,28 @@ void Json_Prg::add_samples(Json_Prg& other, const bool force) {
       duplicates.insert({name, 1});
 
     sample_entry.at("Name") = used_name;
-    json_prg.at("Samples").push_back(sample_entry);
+    samples.push_back(sample_entry);
   }
 }
 
-void Json_Prg::combine_with(Json_Prg& other, bool force) {
-  auto other_prg = other.get_prg();
-  if (json_prg.at("Model") != other_prg.at("Model"))
+void Json_Prg::check_combinable(JSON const& first, JSON const& second) {
+  if (first.at("Model") != second.at("Model"))
     throw JSONCombineException("JSONs have different models");
 
-  auto bad_prg = json_prg.at("Lvl1_Sites") != other_prg.at("Lvl1_Sites");
-  bad_prg |= json_prg.at("Child_Map") != other_prg.at("Child_Map");
+  auto bad_prg = first.at("Lvl1_Sites") != second.at("Lvl1_Sites");
+  bad_prg |= first.at("Child_Map") != second.at("Child_Map");
 
   if (bad_prg)
     throw JSONCombineException(
         "Incompatible PRGs (Check Child_Map and Lvl1_Sites)");
 
-  if (json_prg.at("Site_Fields") != other_prg.at("Site_Fields"))
+  if (first.at("Site_Fields") != second.at("Site_Fields"))
     throw JSONCombineException("Incompatible Site Fields");
+}
+
+void Json_Prg::combine_with(Json_Prg& other, bool force) {
+  auto other_prg = other.get_prg();
+  check_combinable(json_prg, other_prg);
 
   if (sites.size() != other.sites.size())
     throw JSONCombineException("JSONs do not have the same number of sites");
@@ -0,0 +1,123 @@
+#include "genotype/infer/output_specs/json_prg_stream.hpp"
+
+using namespace gram::json;
+
+static char read_token(std::istream& in) {
+  in >> std::ws;
+  auto const c = in.get();
+  if (c == std::char_traits<char>::eof())
+    throw JSONParseException("Unexpected end of JSON input");
+  return static_cast<char>(c);
+}
+
+static void expect_token(std::istream& in, char const expected) {
+  if (read_token(in) != expected)
+    throw JSONParseException(std::string("Expected '") + expected +
+                             "' in JSON input");
+}
+
+/**
+ * Reads a JSON string whose opening quote has already been consumed.
+ */
+static std::string read_string(std::istream& in) {
+  std::string raw{"\""};
+  char c;
+  while (in.get(c)) {
+    raw.push_back(c);
+    if (c == '\\' && in.get(c))
+      raw.push_back(c);
+    else if (c == '"')
+      return JSON::parse(raw).get<std::string>();
+  }
+  throw JSONParseException("Unterminated string in JSON input");
+}
+
+/**
+ * Skips past the end of an array or object whose opening bracket has already
+ * been consumed, without parsing its contents.
+ */
+static void skip_container(std::istream& in) {
+  std::size_t depth{1};
+  bool in_string{false};
+  char c;
+  while (in.get(c)) {
+    if (in_string) {
+      if (c == '\\')
+        in.get(c);
+      else if (c == '"')
+        in_string = false;
+    } else if (c == '"')
+      in_string = true;
+    else if (c == '[' || c == '{')
+      depth++;
+    else if ((c == ']' || c == '}') && --depth == 0)
+      return;
+  }
+  throw JSONParseException("Unterminated container in JSON input");
+}
+
+bool Json_Prg_Reader::header_is_complete() const {
+  for (auto const& entry : spec::json_prg.items()) {
+    if (entry.key() != "Sites" && !header.contains(entry.key())) return false;
+  }
+  return true;
+}
+
+Json_Prg_Reader::Json_Prg_Reader(std::istream& in)
+    : in(in), header(JSON::object()), first_site(true), sites_exhausted(false) {
+  expect_token(in, '{');
+  bool found_sites{false};
+  std::streampos sites_start;
+
+  auto next = read_token(in);
+  while (next != '}') {
+    if (next != '"') throw JSONParseException("Expected a key in JSON input");
+    auto const key = read_string(in);
+    expect_token(in, ':');
+    if (key == "Sites") {
+      expect_token(in, '[');
+      sites_start = in.tellg();
+      found_sites = true;
+      // Usual case: we are done, and positioned on the first site.
+      if (header_is_complete()) return;
+      skip_container(in);
+    } else
+      in >> header[key];
+
+    next = read_token(in);
+    if (next == ',') next = read_token(in);
+  }
+
+  if (!found_sites) throw JSONParseException("No \"Sites\" in JSON input");
+  in.seekg(sites_start);
+}
+
+bool Json_Prg_Reader::next_site(JSON& site) {
+  if (sites_exhausted) return false;
+  in >> std::ws;
+  if (in.peek() == ']') {
+    in.get();
+    sites_exhausted = true;
+    return false;
+  }
+  if (!first_site) expect_token(in, ',');
+  first_site = false;
+  in >> site;
+  return true;
+}
+
+Json_Prg_Writer::Json_Prg_Writer(std::ostream& out, JSON header)
+    : out(out), first_site(true) {
+  header.erase("Sites");
+  auto header_str = header.dump();
+  header_str.pop_back();  // Closing brace
+  out << header_str;
+  if (!header.empty()) out << ",";
+  out << "\"Sites\":[";
+}
+
+void Json_Prg_Writer::add_site(JSON const& site) {
+  if (!first_site) out << ",";
+  first_site = false;
+  out << site;
+}
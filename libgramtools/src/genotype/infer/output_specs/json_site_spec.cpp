@@ -43,7 +43,7 @@ void Json_Site::build_allele_combi_map(JSON const& json_site,
   }
 }
 
-allele_vec Json_Site::get_all_alleles(allele_combi_map& m) {
+allele_vec Json_Site::get_all_alleles(allele_combi_map const& m) {
   allele_vec result(m.size());
   for (auto const& entry : m) {
     result.at(entry.second.index) = entry.first;
@@ -107,25 +107,29 @@ void Json_Site::add_model_specific_entries_from(
     return;
 }
 
-void Json_Site::combine_with(Json_Site& other,
-                             std::string const& gtyping_model) {
-  auto& other_json = other.get_site();
-
+void Json_Site::check_combinable(JSON const& first, JSON const& second) {
   for (auto const& entry : singleton_entries) {
-    if (json_site.at(entry) != other_json.at(entry)) {
+    if (first.at(entry) != second.at(entry)) {
       std::string msg("Sites do not have same " + entry + ": ");
       throw JSONCombineException(msg);
     }
   }
 
-  // Combine alleles
-  std::string this_ref = json_site.at("ALS").at(0);
-  if (this_ref != other_json.at("ALS").at(0)) {
+  if (first.at("ALS").at(0) != second.at("ALS").at(0)) {
     std::string msg("Sites do not have same 'reference' allele: ");
-    msg = msg + std::string(json_site.at("ALS").at(0)) + " vs " +
-          std::string(other_json.at("ALS").at(0));
+    msg = msg + std::string(first.at("ALS").at(0)) + " vs " +
+          std::string(second.at("ALS").at(0));
     throw JSONCombineException(msg);
   }
+}
+
+void Json_Site::combine_with(Json_Site& other,
+                             std::string const& gtyping_model) {
+  auto& other_json = other.get_site();
+  check_combinable(json_site, other_json);
+
+  // Combine alleles
+  std::string this_ref = json_site.at("ALS").at(0);
   allele_combi_map m{{this_ref, site_rescaler{0, 0}}};  // Always place the REF
   build_allele_combi_map(json_site, m);
   build_allele_combi_map(other_json, m);
@@ -1,43 +1,75 @@
 #include "genotype/infer/output_specs/make_json.hpp"
+#include "genotype/infer/output_specs/json_prg_stream.hpp"
 #include "genotype/infer/output_specs/segment_tracker.hpp"
 #include "prg/coverage_graph.hpp"
 
 using namespace gram::genotype;
 
+static json_site_ptr make_positioned_json_site(gt_site_ptr const& site,
+                                               SegmentTracker& tracker) {
+  auto json_site = make_json_site(site);
+  auto site_pos = site->get_pos();
+  json_site->set_segment(tracker.get_ID(site_pos));
+  json_site->set_pos(tracker.get_relative_pos(site_pos) +
+                     1);  // 0-based to 1-based
+  return json_site;
+}
+
 json_prg_ptr make_json_prg(gtyper_ptr const& gtyper, SegmentTracker& tracker) {
   auto result = std::make_shared<Json_Prg>();
   populate_json_prg(*result, gtyper);
-  auto genotyped_records = gtyper->get_genotyped_records();
-  for (auto const& site : genotyped_records) {
-    auto json_site = make_json_site(site);
-    auto site_pos = site->get_pos();
-    json_site->set_segment(tracker.get_ID(site_pos));
-    json_site->set_pos(tracker.get_relative_pos(site_pos) +
-                       1);  // 0-based to 1-based
-    result->add_site(json_site);
-  }
+  auto const& genotyped_records = gtyper->get_genotyped_records();
+  for (std::size_t i{0}; i < genotyped_records.size(); ++i)
+    if (gtyper->is_selected(i))
+      result->add_site(
+          make_positioned_json_site(genotyped_records[i], tracker));
   return result;
 }
 
+void write_json_prg(std::ostream& out, gtyper_ptr const& gtyper,
+                    SegmentTracker& tracker, std::string const& sample_name,
+                    std::string const& sample_desc) {
+  Json_Prg header;
+  populate_json_prg(header, gtyper);
+  header.set_sample_info(sample_name, sample_desc);
+
+  Json_Prg_Writer writer(out, header.get_prg());
+  auto const& genotyped_records = gtyper->get_genotyped_records();
+  for (std::size_t i{0}; i < genotyped_records.size(); ++i)
+    if (gtyper->is_selected(i))
+      writer.add_site(
+          make_positioned_json_site(genotyped_records[i], tracker)->get_site());
+  writer.close();
+}
+
 void populate_json_prg(Json_Prg& json_prg, gtyper_ptr const& gtyper) {
   auto& cur_json = json_prg.get_prg();
   auto cov_graph = gtyper->get_cov_g();
   auto child_m = gtyper->get_child_m();
-  auto genotyped_records = gtyper->get_genotyped_records();
+  auto const& genotyped_records = gtyper->get_genotyped_records();
   if (!cov_graph->is_nested)
     cur_json.at("Lvl1_Sites").push_back("all");
   else {
-    for (int i{0}; i < genotyped_records.size(); ++i)
-      if (cov_graph->par_map.find(index_to_siteID(i)) ==
-          cov_graph->par_map.end())
-        cur_json.at("Lvl1_Sites").push_back(i);
+    // Only selected sites get output, so they get renumbered
+    std::vector<std::size_t> output_index(genotyped_records.size());
+    std::size_t num_output{0};
+    for (std::size_t i{0}; i < genotyped_records.size(); ++i)
+      if (gtyper->is_selected(i)) output_index[i] = num_output++;
+
+    for (std::size_t i{0}; i < genotyped_records.size(); ++i)
+      if (gtyper->is_selected(i) &&
+          cov_graph->par_map.find(index_to_siteID(i)) ==
+              cov_graph->par_map.end())
+        cur_json.at("Lvl1_Sites").push_back(output_index[i]);
 
     for (const auto& child_entry : child_m) {
-      auto site_index = std::to_string(siteID_to_index(child_entry.first));
+      auto const parent_index = siteID_to_index(child_entry.first);
+      if (!gtyper->is_selected(parent_index)) continue;
+      auto site_index = std::to_string(output_index[parent_index]);
       cur_json.at("Child_Map").emplace(site_index, JSON::object());
       for (const auto& hapg_entry : child_entry.second) {
         auto copy = hapg_entry.second;
-        for (auto& el : copy) el = siteID_to_index(el);
+        for (auto& el : copy) el = output_index[siteID_to_index(el)];
         cur_json.at("Child_Map")
             .at(site_index)[std::to_string(hapg_entry.first)] = JSON(copy);
       }
@@ -7,6 +7,11 @@
 void write_vcf(gram::GenotypeParams const& params, gtyper_ptr const& gtyper,
                SegmentTracker& tracker) {
   auto fout = bcf_open(params.genotyped_vcf_fpath.c_str(), "wz");  // Writer
+  if (fout == nullptr)
+    throw VcfWriteException("Failed to open " + params.genotyped_vcf_fpath);
+  // Compression of BGZF blocks is shared across the threads
+  if (params.maximum_threads > 1)
+    hts_set_threads(fout, static_cast<int>(params.maximum_threads));
 
   // Set up and write header
   bcf_hdr_t* header = bcf_hdr_init("w");
@@ -14,9 +19,17 @@ void write_vcf(gram::GenotypeParams const& params, gtyper_ptr const& gtyper,
   if (bcf_hdr_write(fout, header) != 0)
     throw VcfWriteException("Failed to write vcf header");
 
+  // The index gets built as records are written
+  auto const index_fpath = params.genotyped_vcf_fpath + ".csi";
+  if (bcf_idx_init(fout, header, VCF_CSI_MIN_SHIFT, index_fpath.c_str()) < 0)
+    throw VcfWriteException("Failed to initialise vcf index");
+
   write_sites(fout, header, gtyper, tracker);
 
+  if (bcf_idx_save(fout) < 0)
+    throw VcfWriteException("Failed to write vcf index " + index_fpath);
   bcf_close(fout);
+  bcf_hdr_destroy(header);
 }
 
 void populate_vcf_hdr(bcf_hdr_t* hdr, gtyper_ptr gtyper,
@@ -61,48 +74,76 @@ std::size_t next_valid_idx(std::size_t idx, std::size_t max_size,
 
 void write_sites(htsFile* fout, bcf_hdr_t* header, gtyper_ptr const& gtyper,
                  SegmentTracker& tracker) {
-  auto p_map = gtyper->get_cov_g()->par_map;
-  auto genotyped_records = gtyper->get_genotyped_records();
+  auto const& p_map = gtyper->get_cov_g()->par_map;
+  auto const& genotyped_records = gtyper->get_genotyped_records();
   std::size_t site_idx{0}, max_size{genotyped_records.size()};
-  // Set up and write records
-  bcf1_t* record = bcf_init();
-
-  while (true) {
-    site_idx = next_valid_idx(site_idx, max_size, p_map);
-    if (site_idx >= max_size) break;
-
-    bcf_empty(record);
-    populate_vcf_site(header, record, genotyped_records[site_idx], tracker);
-    if (bcf_write(fout, header, record) != 0)
-      throw VcfWriteException("Failed to write vcf record");
-    site_idx++;
+
+  struct vcf_site {
+    std::size_t site_idx;
+    int32_t contig_id;
+    std::size_t pos;
+  };
+  std::vector<vcf_site> chunk;
+  chunk.reserve(VCF_RECORDS_CHUNK_SIZE);
+  std::vector<bcf1_t*> records(VCF_RECORDS_CHUNK_SIZE);
+  for (auto& record : records) record = bcf_init();
+
+  while (site_idx < max_size) {
+    // Locating sites in segments is sequential, so is done up front
+    chunk.clear();
+    while (chunk.size() < VCF_RECORDS_CHUNK_SIZE) {
+      site_idx = next_valid_idx(site_idx, max_size, p_map);
+      if (site_idx >= max_size) break;
+      if (!gtyper->is_selected(site_idx)) {
+        site_idx++;
+        continue;
+      }
+      auto const site_pos = genotyped_records[site_idx]->get_pos();
+      auto const contig_id =
+          bcf_hdr_name2id(header, tracker.get_ID(site_pos).c_str());
+      chunk.push_back(
+          vcf_site{site_idx, contig_id, tracker.get_relative_pos(site_pos)});
+      site_idx++;
+    }
+
+#pragma omp parallel for
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+      bcf_empty(records[i]);
+      populate_vcf_site(header, records[i],
+                        genotyped_records[chunk[i].site_idx],
+                        chunk[i].contig_id, chunk[i].pos);
+    }
+
+    for (std::size_t i{0}; i < chunk.size(); i++) {
+      if (bcf_write(fout, header, records[i]) != 0)
+        throw VcfWriteException("Failed to write vcf record");
+    }
   }
+  for (auto record : records) bcf_destroy(record);
 }
 
 void add_model_specific_entries(bcf_hdr_t* hdr, bcf1_t* record,
                                 site_entries const& entries) {
+  std::vector<float> vals;
   for (auto const& entry : entries.doubles) {
-    std::vector<float> vals;
-    for (auto const& val : entry.vals) vals.push_back((float)val);
+    vals.assign(entry.vals.begin(), entry.vals.end());
     bcf_update_format_float(hdr, record, entry.ID.c_str(), vals.data(),
                             vals.size());
   }
 }
 
-void populate_vcf_site(bcf_hdr_t* header, bcf1_t* record, gt_site_ptr site,
-                       SegmentTracker& tracker) {
-  using str_vec = std::vector<std::string>;
-
+void populate_vcf_site(bcf_hdr_t* header, bcf1_t* record,
+                       gt_site_ptr const& site, int32_t contig_id,
+                       std::size_t pos) {
   // Set CHROM
-  auto numeric_id =
-      bcf_hdr_name2id(header, tracker.get_ID(site->get_pos()).c_str());
-  record->rid = numeric_id;
+  record->rid = contig_id;
   // Set POS. Pass in a 0-based
-  record->pos = tracker.get_relative_pos(site->get_pos());
+  record->pos = pos;
 
   // Set GT
-  auto gtype_info = site->get_all_gtype_info();
-  std::vector<int32_t> gtypes = gtype_info.genotype;
+  auto const& gtype_info = site->get_all_gtype_info();
+  std::vector<int32_t> gtypes(gtype_info.genotype.begin(),
+                              gtype_info.genotype.end());
   if (site->is_null()) {
     for (auto& idx : gtypes) idx = bcf_gt_missing;
   } else {
@@ -111,31 +152,27 @@ void populate_vcf_site(bcf_hdr_t* header, bcf1_t* record, gt_site_ptr site,
   bcf_update_genotypes(header, record, gtypes.data(), gtypes.size());
 
   // Set DP
-  str_vec total_cov{std::to_string(gtype_info.total_coverage)};
-  bcf_update_format_string(header, record, "DP",
-                           reinterpret_cast<char const**>(total_cov.data()), 1);
+  auto const total_cov = std::to_string(gtype_info.total_coverage);
+  char const* total_cov_str = total_cov.c_str();
+  bcf_update_format_string(header, record, "DP", &total_cov_str, 1);
 
   // Set COV
-  auto covs = gtype_info.allele_covs;
+  auto const& covs = gtype_info.allele_covs;
   if (covs.size() > 0) {
-    std::vector<float> depths;
-    for (auto const& cov : covs) depths.push_back((float)cov);
+    std::vector<float> depths(covs.begin(), covs.end());
     bcf_update_format_float(header, record, "COV", depths.data(),
                             depths.size());
   }
 
   // Set FT
-  str_vec filters = gtype_info.filters;
-  if (gtype_info.filters.empty())
-    filters.insert(filters.end(), "PASS");
-  else {
-    auto const max_size = gtype_info.filters.size();
-    for (std::size_t i{0}; i < max_size; i++) {
-      if (i < max_size - 1) filters.at(i).push_back(',');
-    }
+  std::string filters;
+  for (auto const& filter : gtype_info.filters) {
+    if (!filters.empty()) filters.push_back(',');
+    filters += filter;
   }
-  bcf_update_format_string(header, record, "FT",
-                           reinterpret_cast<char const**>(filters.data()), 1);
+  if (filters.empty()) filters = "PASS";
+  char const* filters_str = filters.c_str();
+  bcf_update_format_string(header, record, "FT", &filters_str, 1);
 
   std::string als;
   for (auto const& al : gtype_info.alleles) {
@@ -4,6 +4,11 @@
 
 #include <iostream>
 
+#include "genotype/infer/allele_extracter.hpp"
+#include "genotype/quasimap/progress.hpp"
+#include "genotype/quasimap/read_cache.hpp"
+#include "genotype/quasimap/search/approximate_search.hpp"
+
 using namespace gram;
 using namespace gram::commands::genotype;
 
@@ -42,12 +47,38 @@ void validate(boost::any& v, const std::vector<std::string>& values,
   v = boost::any(ploidy_argument(s));
 }
 
+struct search_mode_argument {
+  SearchMode search_mode;
+
+ public:
+  search_mode_argument() = default;
+  search_mode_argument(const std::string& in) {
+    if (in == "backward")
+      search_mode = SearchMode::Backward;
+    else if (in == "seed_extend")
+      search_mode = SearchMode::SeedExtend;
+    else
+      throw std::invalid_argument("Invalid/unsupported search mode");
+  }
+
+  SearchMode get() { return search_mode; }
+};
+
+void validate(boost::any& v, const std::vector<std::string>& values,
+              search_mode_argument* target_type, int) {
+  using namespace boost::program_options;
+  validators::check_first_occurrence(v);
+  std::string const& s = validators::get_single_string(values);
+  v = boost::any(search_mode_argument(s));
+}
+
 GenotypeParams commands::genotype::parse_parameters(
     po::variables_map& vm, const po::parsed_options& parsed) {
   GenotypeParams parameters = {};
   std::vector<std::string> reads_fpaths;
   std::string run_dirpath;
   ploidy_argument ploidy;
+  search_mode_argument search_mode{"backward"};
   Seed::value_type seed;
 
   po::options_description genotype_description("genotype options");
@@ -55,8 +86,7 @@ GenotypeParams commands::genotype::parse_parameters(
       "gram_dir", po::value<std::string>(&parameters.gram_dirpath)->required(),
       "gramtools directory")("reads",
                              po::value<std::vector<std::string>>(&reads_fpaths)
-                                 ->multitoken()
-                                 ->required(),
+                                 ->multitoken(),
                              "file containing reads (FASTA or FASTQ)")(
       "sample_id", po::value<std::string>(&parameters.sample_id)->required())(
       "ploidy", po::value<ploidy_argument>(&ploidy)->required(),
@@ -69,7 +99,62 @@ GenotypeParams commands::genotype::parse_parameters(
                           "maximum number of threads used")(
       "seed", po::value<SeedSize>(&seed),
       "seed for pseudo-random selection of multi-mapping reads. "
-      "a random seed is generated if this option is not used.");
+      "a random seed is generated if this option is not used.")(
+      "max_allele_combinations",
+      po::value<std::size_t>(&parameters.max_allele_combinations)
+          ->default_value(DEFAULT_MAX_ALLELE_COMBINATIONS),
+      "maximum number of alleles produced per haplogroup of a site when "
+      "combining the alleles of nested sites")(
+      "regions", po::value<std::string>(&parameters.regions_fpath),
+      "BED file of regions of the reference to genotype. only the sites "
+      "overlapping them get genotyped, and only reads reaching them mapped")(
+      "read_cache_size",
+      po::value<std::size_t>(&parameters.read_cache_size)
+          ->default_value(DEFAULT_READ_CACHE_SIZE),
+      "maximum number of reads whose mappings are cached, so that duplicate "
+      "reads are mapped once. 0 disables the cache")(
+      "search_mode", po::value<search_mode_argument>(&search_mode),
+      "where searching a read starts. Choices: {backward, seed_extend}. "
+      "backward starts from its last kmer, seed_extend from its kmer with "
+      "fewest occurrences in the prg")(
+      "max_mismatches",
+      po::value<uint32_t>(&parameters.max_mismatches)->default_value(0),
+      "maximum number of base substitutions allowed when mapping reads that "
+      "have no exact mapping. 0 only maps reads exactly")(
+      "max_search_states",
+      po::value<std::size_t>(&parameters.max_search_states)
+          ->default_value(DEFAULT_MAX_SEARCH_STATES),
+      "maximum number of candidate mappings kept per read when mapping with "
+      "substitutions")(
+      "quasimap_only", po::bool_switch(&parameters.quasimap_only),
+      "only map the reads, writing their coverage to a partial coverage file "
+      "that --merge_coverage can sum with others")(
+      "merge_coverage",
+      po::value<std::vector<std::string>>(&parameters.merge_coverage_fpaths)
+          ->multitoken(),
+      "partial coverage files written with --quasimap_only, from parts of the "
+      "same sample's reads. they get summed and genotyped instead of reads")(
+      "compress_coverage", po::bool_switch(&parameters.compress_coverage),
+      "gzip the binary coverage file")(
+      "no_coverage_json", po::bool_switch(&parameters.no_coverage_json),
+      "do not write per base and grouped allele coverage in the legacy JSON "
+      "files, only in the binary coverage file")(
+      "checkpoint_seconds",
+      po::value<uint32_t>(&parameters.checkpoint_seconds)
+          ->default_value(DEFAULT_CHECKPOINT_SECONDS),
+      "seconds between checkpoints of read mapping, which --resume restarts "
+      "from. 0, the default, disables checkpoints")(
+      "resume", po::bool_switch(&parameters.resume),
+      "restart read mapping from the last checkpoint in --genotype_dir, if "
+      "any. the other options must be those of the interrupted run")(
+      "progress_seconds",
+      po::value<uint32_t>(&parameters.progress_seconds)
+          ->default_value(DEFAULT_PROGRESS_SECONDS),
+      "seconds between reports of read mapping progress, to stderr. 0 "
+      "disables them, but for a last one to --progress_file, if given")(
+      "progress_file", po::value<std::string>(&parameters.progress_fpath),
+      "file replaced with each progress report, in JSON, for job schedulers "
+      "to poll");
 
   std::vector<std::string> opts =
       po::collect_unrecognized(parsed.options, po::include_positional);
@@ -85,11 +170,24 @@ GenotypeParams commands::genotype::parse_parameters(
     exit(1);
   }
 
+  if (reads_fpaths.empty() == parameters.merge_coverage_fpaths.empty())
+    throw std::invalid_argument(
+        "Exactly one of --reads and --merge_coverage must be used");
+
   fill_common_parameters(parameters, parameters.gram_dirpath);
   for (auto& elem : reads_fpaths) elem = fs::absolute(fs::path(elem)).string();
   parameters.reads_fpaths = reads_fpaths;
+  for (auto& elem : parameters.merge_coverage_fpaths)
+    elem = fs::absolute(fs::path(elem)).string();
+  if (!parameters.progress_fpath.empty())
+    parameters.progress_fpath =
+        fs::absolute(fs::path(parameters.progress_fpath)).string();
+  if (!parameters.regions_fpath.empty())
+    parameters.regions_fpath =
+        fs::absolute(fs::path(parameters.regions_fpath)).string();
 
   parameters.ploidy = ploidy.get();
+  parameters.search_mode = search_mode.get();
 
   std::string cov_dirpath = mkdir(run_dirpath, "coverage");
   std::string geno_dirpath = mkdir(run_dirpath, "genotype");
@@ -103,6 +201,12 @@ GenotypeParams commands::genotype::parse_parameters(
       full_path(cov_dirpath, "allele_base_coverage.json");
   parameters.grouped_allele_counts_fpath =
       full_path(cov_dirpath, "grouped_allele_counts_coverage.json");
+  parameters.coverage_fpath = full_path(
+      cov_dirpath,
+      parameters.compress_coverage ? "coverage.bin.gz" : "coverage.bin");
+  parameters.partial_coverage_fpath =
+      full_path(cov_dirpath, "partial_coverage.bin");
+  parameters.checkpoint_fpath = full_path(cov_dirpath, "checkpoint.bin");
 
   parameters.genotyped_json_fpath = full_path(geno_dirpath, "genotyped.json");
   parameters.genotyped_vcf_fpath = full_path(geno_dirpath, "genotyped.vcf.gz");
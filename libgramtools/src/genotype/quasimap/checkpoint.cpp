@@ -0,0 +1,160 @@
+#include "genotype/quasimap/checkpoint.hpp"
+
+#include <omp.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/vector.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace gram;
+namespace fs = std::filesystem;
+
+static std::string const checkpoint_magic{"gramtools quasimap checkpoint"};
+
+namespace {
+/** The options that change how reads map, so cannot change on resuming */
+struct MappingOptions {
+  uint32_t kmers_size;
+  uint32_t search_mode;
+  uint32_t max_mismatches;
+  uint64_t max_search_states;
+  std::string regions; /**< The regions file's contents, if any */
+
+  explicit MappingOptions(GenotypeParams const &parameters)
+      : kmers_size(parameters.kmers_size),
+        search_mode(static_cast<uint32_t>(parameters.search_mode)),
+        max_mismatches(parameters.max_mismatches),
+        max_search_states(parameters.max_search_states) {
+    if (parameters.regions_fpath.empty()) return;
+    std::ifstream ifs{parameters.regions_fpath, std::ios::binary};
+    if (!ifs)
+      throw std::ios::failure("Cannot open: " + parameters.regions_fpath);
+    std::stringstream contents;
+    contents << ifs.rdbuf();
+    regions = contents.str();
+  }
+  MappingOptions() = default;
+
+  template <typename Archive>
+  void serialize(Archive &ar, const unsigned int version) {
+    ar &kmers_size;
+    ar &search_mode;
+    ar &max_mismatches;
+    ar &max_search_states;
+    ar &regions;
+  }
+};
+}  // namespace
+
+Checkpointer::Checkpointer(GenotypeParams const &parameters,
+                           PRG_Info const &prg_info,
+                           SeedSize const &master_seed)
+    : parameters(parameters),
+      prg_info(prg_info),
+      master_seed(master_seed),
+      last_write_time(omp_get_wtime()) {}
+
+bool Checkpointer::due() const {
+  return parameters.checkpoint_seconds > 0 &&
+         omp_get_wtime() - last_write_time >= parameters.checkpoint_seconds;
+}
+
+void Checkpointer::write(QuasimapReadsStats const &quasimap_stats,
+                         ReadsProgress const &progress) {
+  auto const tmp_fpath = parameters.checkpoint_fpath + ".tmp";
+  {
+    std::ofstream ofs{tmp_fpath, std::ios::binary};
+    if (!ofs) throw std::ios::failure("Cannot write to: " + tmp_fpath);
+    boost::archive::binary_oarchive oa{ofs};
+
+    auto const &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+    uint32_t const version{CHECKPOINT_VERSION};
+    uint64_t const num_sites{prg_info.num_variant_sites};
+    uint64_t const num_bases{pb_cov_store.size()};
+    oa << checkpoint_magic << version << num_sites << num_bases;
+    oa << parameters.reads_fpaths << MappingOptions{parameters};
+    oa << master_seed << progress.num_reads;
+    for (auto const &readstats : progress.readstats)
+      oa << readstats << readstats.get_sampler_state();
+
+    for (auto const count : read_counts(quasimap_stats)) oa << *count;
+    oa << quasimap_stats.coverage.allele_sum_coverage;
+    oa << quasimap_stats.coverage.grouped_allele_counts;
+    PerBaseCoverage const base_coverage = pb_cov_store.get_range(0, num_bases);
+    oa << base_coverage;
+  }
+  fs::rename(tmp_fpath, parameters.checkpoint_fpath);
+  last_write_time = omp_get_wtime();
+}
+
+ReadsProgress gram::load_checkpoint(GenotypeParams const &parameters,
+                                    PRG_Info const &prg_info,
+                                    QuasimapReadsStats &quasimap_stats,
+                                    RandomInclusiveInt &seed_generator) {
+  auto const &fpath = parameters.checkpoint_fpath;
+  std::ifstream ifs{fpath, std::ios::binary};
+  if (!ifs) throw std::ios::failure("Cannot open: " + fpath);
+  boost::archive::binary_iarchive ia{ifs};
+
+  std::string magic;
+  uint32_t version;
+  uint64_t num_sites, num_bases;
+  ia >> magic >> version >> num_sites >> num_bases;
+  auto &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+  if (magic != checkpoint_magic || version != CHECKPOINT_VERSION)
+    throw std::runtime_error(fpath + " is not a quasimap checkpoint (version " +
+                             std::to_string(CHECKPOINT_VERSION) + ")");
+  if (num_sites != prg_info.num_variant_sites ||
+      num_bases != pb_cov_store.size())
+    throw std::runtime_error(fpath + " is a checkpoint for a different prg");
+
+  std::vector<std::string> reads_fpaths;
+  ia >> reads_fpaths;
+  if (reads_fpaths != parameters.reads_fpaths)
+    throw std::runtime_error(fpath +
+                             " is a checkpoint for different reads files");
+  MappingOptions options;
+  ia >> options;
+  MappingOptions const expected_options{parameters};
+  auto check_option = [&](bool const same, std::string const &option) {
+    if (!same)
+      throw std::runtime_error(fpath + " is a checkpoint for a different " +
+                               option + ": resuming must keep it the same");
+  };
+  check_option(options.kmers_size == expected_options.kmers_size,
+               "kmer size");
+  check_option(options.search_mode == expected_options.search_mode,
+               "search mode");
+  check_option(options.max_mismatches == expected_options.max_mismatches,
+               "maximum number of mismatches");
+  check_option(options.max_search_states == expected_options.max_search_states,
+               "maximum number of search states");
+  check_option(options.regions == expected_options.regions, "regions file");
+
+  SeedSize seed;
+  ReadsProgress progress;
+  ia >> seed >> progress.num_reads;
+  check_option(!parameters.seed.has_value() || parameters.seed.value() == seed,
+               "seed (" + std::to_string(seed) + ")");
+  seed_generator = RandomInclusiveInt(seed);
+  progress.readstats.resize(progress.num_reads.size());
+  for (auto &readstats : progress.readstats) {
+    std::string sampler_state;
+    ia >> readstats >> sampler_state;
+    readstats.set_sampler_state(sampler_state);
+  }
+
+  for (auto const count : read_counts(quasimap_stats)) ia >> *count;
+  ia >> quasimap_stats.coverage.allele_sum_coverage;
+  ia >> quasimap_stats.coverage.grouped_allele_counts;
+  PerBaseCoverage base_coverage;
+  ia >> base_coverage;
+  for (std::size_t base = 0; base < base_coverage.size(); ++base)
+    pb_cov_store.set(base, base_coverage[base]);
+  return progress;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <vector>
@@ -39,8 +40,10 @@ SitesAlleleBaseCoverage gram::coverage::generate::allele_base_non_nested(
 
 void coverage::record::allele_base(PRG_Info const &prg_info,
                                    const SearchStates &search_states,
-                                   const uint64_t &read_length) {
-  PbCovRecorder record_it{prg_info, search_states, read_length};
+                                   const uint64_t &read_length,
+                                   DummyCovNodes *const dummy_cov_nodes) {
+  PbCovRecorder record_it{prg_info, search_states, read_length,
+                          dummy_cov_nodes};
 }
 
 /**
@@ -134,10 +137,49 @@ void DummyCovNode::extend_coordinates(node_coordinates coords) {
   if (end_pos - start_pos == node_size - 1) full = true;
 }
 
-Traverser::Traverser(node_access start_point, VariantSitePath traversed_loci,
+void DummyCovNodes::clear() {
+  entries.clear();
+  if (++generation == 0) {
+    // Wrapped around: slots from past generations could be taken as current
+    std::fill(generations.begin(), generations.end(), 0);
+    generation = 1;
+  }
+}
+
+DummyCovNode *DummyCovNodes::find(covG_ptr const &node) {
+  auto const cov_ID = node->get_cov_ID();
+  if (cov_ID == coverage_Node::no_cov_ID) {
+    auto const found = std::find_if(
+        entries.begin(), entries.end(),
+        [&](entry const &element) { return element.first == node; });
+    return found == entries.end() ? nullptr : &found->second;
+  }
+  if (cov_ID >= generations.size() || generations[cov_ID] != generation)
+    return nullptr;
+  return &entries[entry_indices[cov_ID]].second;
+}
+
+void DummyCovNodes::insert(covG_ptr const &node,
+                           DummyCovNode const &dummy_node) {
+  auto const cov_ID = node->get_cov_ID();
+  if (cov_ID == coverage_Node::no_cov_ID) {
+    entries.emplace_back(node, dummy_node);
+    return;
+  }
+  if (cov_ID >= generations.size()) {
+    generations.resize(cov_ID + 1, 0);
+    entry_indices.resize(cov_ID + 1);
+  }
+  generations[cov_ID] = generation;
+  entry_indices[cov_ID] = entries.size();
+  entries.emplace_back(node, dummy_node);
+}
+
+Traverser::Traverser(node_access const &start_point,
+                     VariantSitePath const &traversed_loci,
                      std::size_t read_size)
     : cur_Node(start_point.node),
-      traversed_loci(traversed_loci),
+      traversed_loci(&traversed_loci),
       bases_remaining(read_size),
       first_node(true),
       end_pos(0) {
@@ -204,7 +246,7 @@ void Traverser::assign_end_position() {
 }
 
 void Traverser::choose_allele() {
-  auto traversed_locus = traversed_loci[traversed_index];
+  auto const &traversed_locus = (*traversed_loci)[traversed_index];
   auto site_id{traversed_locus.first};
   auto allele_id{traversed_locus.second};
   auto next_node = cur_Node->get_edges()[allele_id];
@@ -220,26 +262,38 @@ void Traverser::choose_allele() {
 
 PbCovRecorder::PbCovRecorder(const PRG_Info &prg_info,
                              SearchStates const &search_states,
-                             std::size_t read_size)
-    : prg_info(&prg_info), read_size(read_size) {
+                             std::size_t read_size,
+                             DummyCovNodes *const dummy_cov_nodes)
+    : cov_mapping(dummy_cov_nodes == nullptr ? own_cov_mapping
+                                             : *dummy_cov_nodes),
+      prg_info(&prg_info),
+      read_size(read_size) {
+  cov_mapping.clear();
   for (auto const &search_state : search_states)
     process_SearchState(search_state);
   write_coverage_from_dummy_nodes();
 }
 
+PbCovRecorder::PbCovRecorder(realCov_to_dummyCov const &existing_cov_mapping) {
+  for (auto const &element : existing_cov_mapping)
+    cov_mapping.insert(element.first, element.second);
+}
+
+realCov_to_dummyCov PbCovRecorder::get_cov_mapping() const {
+  realCov_to_dummyCov result;
+  for (auto const &element : cov_mapping.get_entries())
+    result.insert(element);
+  return result;
+}
+
 void PbCovRecorder::write_coverage_from_dummy_nodes() {
-  covG_ptr cov_node;
-  node_coordinates to_increment;
-  for (auto const &element : cov_mapping) {  // Go through each dummy node
-    cov_node = element.first;
-    to_increment = element.second.get_coordinates();
-    PerBaseCoverage &cur_coverage =
-        cov_node->get_ref_to_coverage();  // Modifiable in place
-    for (auto i = to_increment.first; i <= to_increment.second; i++) {
-      if (cur_coverage[i] == UINT16_MAX) continue;
-#pragma omp atomic
-      cur_coverage[i]++;
-    }
+  // Go through each dummy node
+  for (auto const &element : cov_mapping.get_entries()) {
+    auto const &cov_node = element.first;
+    auto const to_increment = element.second.get_coordinates();
+    // Thread-safe, and saturating
+    for (auto i = to_increment.first; i <= to_increment.second; i++)
+      cov_node->increment_coverage(i);
   }
 }
 
@@ -250,7 +304,8 @@ void PbCovRecorder::process_SearchState(SearchState const &ss) {
   for (auto occurrence = ss.sa_interval.first;
        occurrence <= ss.sa_interval.second; occurrence++) {
     auto coordinate = prg_info->fm_index[occurrence];
-    auto access_point = prg_info->coverage_graph.random_access[coordinate];
+    auto const &access_point =
+        prg_info->coverage_graph.random_access[coordinate];
     t = {access_point, ss.traversed_path, read_size};
 
     // Record a full traversal starting at the first mapping instance
@@ -284,13 +339,13 @@ void PbCovRecorder::process_Node(covG_ptr cov_node, node_coordinate start_pos,
   if (!cov_node->has_sequence())
     return;  // Skips double site entries, where `cov_node` is a no-sequence
              // bubble entry
-  if (cov_mapping.find(cov_node) == cov_mapping.end()) {
+  auto const existing_dummy_cov_node = cov_mapping.find(cov_node);
+  if (existing_dummy_cov_node == nullptr) {
     std::size_t cov_node_size = cov_node->get_sequence_size();
     DummyCovNode new_dummy_cov_node{start_pos, end_pos, cov_node_size};
-    cov_mapping.insert({cov_node, new_dummy_cov_node});
+    cov_mapping.insert(cov_node, new_dummy_cov_node);
   } else {
-    DummyCovNode &existing_dummy_cov_node = cov_mapping.at(cov_node);
-    existing_dummy_cov_node.extend_coordinates(
+    existing_dummy_cov_node->extend_coordinates(
         node_coordinates{start_pos, end_pos});
   }
 }
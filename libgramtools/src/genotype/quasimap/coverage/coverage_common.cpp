@@ -1,34 +1,53 @@
 #include "genotype/quasimap/coverage/coverage_common.hpp"
 
+#include <algorithm>
+
 #include "common/random.hpp"
 #include "genotype/quasimap/coverage/allele_base.hpp"
 #include "genotype/quasimap/coverage/allele_sum.hpp"
+#include "genotype/quasimap/coverage/coverage_file.hpp"
 #include "genotype/quasimap/coverage/grouped_allele_counts.hpp"
 
 using namespace gram;
 
-LocusFinder::LocusFinder(SearchState const search_state, info_ptr prg_info)
-    : search_state(search_state), prg_info(prg_info) {
-  check_site_uniqueness();
-  assign_traversing_loci();
-  assign_traversed_loci();
+/**
+ * Inserts `element` into sorted vector `v`, if absent.
+ * @return whether `element` was inserted.
+ */
+template <typename T>
+static bool insert_sorted(std::vector<T> &v, T const &element) {
+  auto const it = std::lower_bound(v.begin(), v.end(), element);
+  if (it != v.end() && *it == element) return false;
+  v.insert(it, element);
+  return true;
+}
+
+LocusFinder::LocusFinder(SearchState const &search_state, info_ptr prg_info) {
+  assign(search_state, prg_info);
+}
+
+void LocusFinder::assign(SearchState const &search_state, info_ptr prg_info) {
+  base_sites.clear();
+  used_sites.clear();
+  unique_loci.clear();
+  check_site_uniqueness(search_state);
+  assign_traversing_loci(search_state, prg_info);
+  assign_traversed_loci(search_state, prg_info);
 }
 
 void LocusFinder::check_site_uniqueness(SearchState const &search_state) {
-  auto all_loci = search_state.traversed_path;
-  all_loci.insert(all_loci.end(), search_state.traversing_path.begin(),
-                  search_state.traversing_path.end());
-  SitePath unique_sites;
-  for (auto const &entry : all_loci) {
-    Marker site = entry.first;
-    if (unique_sites.find(site) != unique_sites.end()) {
-      throw std::logic_error(
-          "ERROR: A site cannot have been traversed more than once by a read, "
-          "but this one is marked as such.\n");
-    }
-    unique_sites.insert(site);
+  markers_buffer.clear();
+  for (auto const &path :
+       {&search_state.traversed_path, &search_state.traversing_path}) {
+    for (auto const &entry : *path) markers_buffer.push_back(entry.first);
+  }
+  std::sort(markers_buffer.begin(), markers_buffer.end());
+  if (std::adjacent_find(markers_buffer.begin(), markers_buffer.end()) !=
+      markers_buffer.end()) {
+    throw std::logic_error(
+        "ERROR: A site cannot have been traversed more than once by a read, "
+        "but this one is marked as such.\n");
   }
-  return;
 }
 
 void LocusFinder::assign_nested_locus(VariantLocus const &var_loc,
@@ -37,17 +56,16 @@ void LocusFinder::assign_nested_locus(VariantLocus const &var_loc,
   VariantLocus cur_locus = var_loc;
   Marker &cur_marker = cur_locus.first;
   while (true) {
-    if (used_sites.find(cur_marker) != used_sites.end()) break;
-    used_sites.insert(cur_marker);
-    unique_loci.insert(cur_locus);
+    if (!insert_sorted(used_sites, cur_marker)) break;
+    insert_sorted(unique_loci, cur_locus);
 
-    if (par_map.find(cur_marker) == par_map.end()) {
-      base_sites.insert(cur_marker);  // Add non-nested site marker
+    auto const parent = par_map.find(cur_marker);
+    if (parent == par_map.end()) {
+      insert_sorted(base_sites, cur_marker);  // Add non-nested site marker
       break;
     }
-    cur_locus = par_map.at(cur_marker);
+    cur_locus = parent->second;
   }
-  return;
 }
 
 void LocusFinder::assign_traversing_loci(SearchState const &search_state,
@@ -66,7 +84,7 @@ void LocusFinder::assign_traversing_loci(SearchState const &search_state,
     auto allele_id = node_access.node->get_allele_ID();
 
     new_locus = VariantLocus{parent_seed, allele_id};
-    unique_loci.insert(new_locus);
+    insert_sorted(unique_loci, new_locus);
   }
 
   assign_nested_locus(new_locus, prg_info);
@@ -82,48 +100,99 @@ void LocusFinder::assign_traversed_loci(SearchState const &search_state,
   }
 }
 
-MappingInstanceSelector::MappingInstanceSelector(
-    SearchStates const search_states, info_ptr prg_info,
-    rand_ptr rand_generator)
-    : input_search_states(search_states),
-      usps(),
+MappingInstanceSelector::MappingInstanceSelector(info_ptr prg_info,
+                                                 rand_ptr rand_g,
+                                                 SelectorBuffers *const buffers)
+    : input_search_states(nullptr),
+      buffers(buffers == nullptr ? own_buffers : *buffers),
       prg_info(prg_info),
-      rand_generator(rand_generator) {
-  process_searchstates(input_search_states);
+      rand_generator(rand_g) {
+  this->buffers.num_classes = 0;
+  this->buffers.class_indices.clear();
+}
+
+MappingInstanceSelector::MappingInstanceSelector(
+    SearchStates const &search_states, info_ptr prg_info,
+    rand_ptr rand_generator, SelectorBuffers *const buffers)
+    : MappingInstanceSelector(prg_info, rand_generator, buffers) {
+  input_search_states = &search_states;
+  process_searchstates(search_states);
   int32_t selected_index = random_select_entry();
   if (selected_index >= 0) apply_selection(selected_index);
 }
 
 int32_t MappingInstanceSelector::random_select_entry() {
-  if (usps.size() == 0) return -1;
-  uint32_t nonvariant_count = count_nonvar_search_states(input_search_states);
-  uint32_t count_total_options = nonvariant_count + usps.size();
+  if (buffers.num_classes == 0) return -1;
+  uint32_t nonvariant_count =
+      input_search_states == nullptr
+          ? 0
+          : count_nonvar_search_states(*input_search_states);
+  uint32_t count_total_options = nonvariant_count + buffers.num_classes;
 
   auto selected_option = rand_generator->generate(1, count_total_options);
   // If we select a non-variant path, no coverage information will get recorded.
   bool no_variants = selected_option <= nonvariant_count;
   if (no_variants) return -1;
-  return selected_option - nonvariant_count - 1;  // return 0-based index in map
+  // Return 0-based index in `level0_Sites` order
+  return selected_option - nonvariant_count - 1;
 }
 
 void MappingInstanceSelector::apply_selection(int32_t selected_index) {
-  auto it = usps.begin();
-  std::advance(it, selected_index);
-  auto chosen_traversal = it->second;
-  selected = SelectedMapping{chosen_traversal.first, chosen_traversal.second};
+  auto &ordered = buffers.ordered_classes;
+  ordered.clear();
+  for (std::size_t i{0}; i < buffers.num_classes; ++i)
+    ordered.push_back(&buffers.classes[i]);
+  std::nth_element(ordered.begin(), ordered.begin() + selected_index,
+                   ordered.end(),
+                   [](EquivalenceClass const *a, EquivalenceClass const *b) {
+                     return a->base_sites < b->base_sites;
+                   });
+  auto const &chosen_class = *ordered[selected_index];
+
+  selected.navigational_search_states.clear();
+  for (auto const search_state : chosen_class.search_states)
+    selected.navigational_search_states.push_back(*search_state);
+  selected.equivalence_class_loci = chosen_class.loci;
 }
 
 void MappingInstanceSelector::add_searchstate(SearchState const &ss) {
-  LocusFinder l{ss, prg_info};
-  // Create or retrieve the coverage information
-  auto &cov_info = usps[l.base_sites];
+  auto &l = buffers.locus_finder;
+  l.assign(ss, prg_info);
+
+  // Retrieve the coverage information, or create it reusing a buffered class
+  auto &classes = buffers.classes;
+  auto const found =
+      buffers.class_indices.emplace(l.base_sites, buffers.num_classes);
+  bool const new_class = found.second;
+  if (new_class) {
+    if (buffers.num_classes == classes.size()) classes.emplace_back();
+    ++buffers.num_classes;
+  }
+  auto const cov_info = classes.begin() + found.first->second;
+  if (new_class) {
+    cov_info->base_sites = l.base_sites;
+    cov_info->search_states.clear();
+    cov_info->loci.clear();
+  }
 
   // Merge each `VariantLocus` into the existing set of unique `VariantLocus`
-  for (auto &locus : l.unique_loci) cov_info.second.insert(locus);
+  for (auto const &locus : l.unique_loci) insert_sorted(cov_info->loci, locus);
 
   // Add the `SearchState` to the list of `SearchStates` compatible with the
   // `base_sites`
-  cov_info.first.push_back(ss);
+  cov_info->search_states.push_back(&ss);
+}
+
+uniqueSitePaths MappingInstanceSelector::get_usps() const {
+  uniqueSitePaths result;
+  for (std::size_t i{0}; i < buffers.num_classes; ++i) {
+    auto const &c = buffers.classes[i];
+    auto &cov_info = result[c.base_sites];
+    for (auto const search_state : c.search_states)
+      cov_info.first.push_back(*search_state);
+    cov_info.second = c.loci;
+  }
+  return result;
 }
 
 void MappingInstanceSelector::process_searchstates(SearchStates const &all_ss) {
@@ -165,9 +234,10 @@ uint32_t MappingInstanceSelector::count_nonvar_search_states(
  */
 SelectedMapping selection(const SearchStates &search_states,
                           const uint64_t &read_length, const PRG_Info &prg_info,
-                          SeedSize const &selection_seed) {
-  RandomInclusiveInt selector{Seed{selection_seed}};
-  MappingInstanceSelector m{search_states, &prg_info, &selector};
+                          SelectionKey const &selection_key,
+                          SelectorBuffers *const buffers) {
+  CounterRandomInt selector{selection_key};
+  MappingInstanceSelector m{search_states, &prg_info, &selector, buffers};
 
   // This contains empty containers if we selected a mapping instance in an
   // invariant part of the PRG
@@ -180,16 +250,19 @@ void coverage::record::search_states(Coverage &coverage,
                                      const SearchStates &search_states,
                                      const uint64_t &read_length,
                                      const PRG_Info &prg_info,
-                                     SeedSize const &selection_seed) {
+                                     SelectionKey const &selection_key,
+                                     RecordingBuffers *const buffers) {
   SelectedMapping selected_search_states =
-      selection(search_states, read_length, prg_info, selection_seed);
+      selection(search_states, read_length, prg_info, selection_key,
+                buffers == nullptr ? nullptr : &buffers->selector);
 
   // If we selected a mapping instance that does not overlap any variant site,
   // there is no coverage to record.
   if (selected_search_states.navigational_search_states.empty()) return;
 
   coverage::record::allele_base(
-      prg_info, selected_search_states.navigational_search_states, read_length);
+      prg_info, selected_search_states.navigational_search_states, read_length,
+      buffers == nullptr ? nullptr : &buffers->dummy_cov_nodes);
   coverage::record::allele_sum(coverage,
                                selected_search_states.equivalence_class_loci);
   coverage::record::grouped_allele_counts(
@@ -199,6 +272,9 @@ void coverage::record::search_states(Coverage &coverage,
 void coverage::dump::all(const Coverage &coverage,
                          const GenotypeParams &parameters) {
   coverage::dump::allele_sum(coverage, parameters);
+  coverage::file::dump(parameters.coverage_fpath, coverage,
+                       parameters.compress_coverage);
+  if (parameters.no_coverage_json) return;
   coverage::dump::allele_base(coverage, parameters);
   coverage::dump::grouped_allele_counts(coverage, parameters);
 }
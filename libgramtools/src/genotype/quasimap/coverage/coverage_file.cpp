@@ -0,0 +1,236 @@
+#include "genotype/quasimap/coverage/coverage_file.hpp"
+
+#include <algorithm>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace gram;
+
+static char const coverage_file_magic[8] = {'G', 'R', 'A', 'M',
+                                            'C', 'O', 'V', '\0'};
+
+/** Appends `value` to `buffer` as `num_bytes` little-endian bytes */
+static void put(std::string &buffer, uint64_t const value,
+                std::size_t const num_bytes) {
+  for (std::size_t i = 0; i < num_bytes; ++i)
+    buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+static void put_u32s(std::string &buffer, std::vector<CovCount> const &values) {
+  put(buffer, values.size(), 4);
+  for (auto const value : values) put(buffer, value, 4);
+}
+
+static uint64_t decode(unsigned char const *bytes,
+                       std::size_t const num_bytes) {
+  uint64_t value{0};
+  for (std::size_t i = num_bytes; i-- > 0;) value = (value << 8) | bytes[i];
+  return value;
+}
+
+namespace {
+/**
+ * Reads the fields of a coverage file, keeping track of how many bytes are
+ * left. Compressed streams cannot tell, so arrays are then read in chunks:
+ * memory only grows with the data actually there.
+ */
+class CoverageReader {
+ public:
+  explicit CoverageReader(std::istream &stream) : stream(stream) {
+    // Telling or seeking fails, setting the failbit, on compressed streams
+    auto const no_position = std::istream::pos_type(-1);
+    auto const start = stream.tellg();
+    if (start != no_position && stream.seekg(0, std::ios::end)) {
+      auto const end = stream.tellg();
+      if (end != no_position) remaining = static_cast<uint64_t>(end - start);
+    }
+    stream.clear();
+    if (start != no_position) stream.seekg(start);
+  }
+
+  void read_bytes(char *bytes, std::size_t const num_bytes) {
+    stream.read(bytes, num_bytes);
+    if (static_cast<std::size_t>(stream.gcount()) != num_bytes)
+      throw std::runtime_error("Truncated coverage file");
+    if (remaining != unknown_size) remaining -= num_bytes;
+  }
+
+  uint64_t get(std::size_t const num_bytes) {
+    unsigned char bytes[8];
+    read_bytes(reinterpret_cast<char *>(bytes), num_bytes);
+    return decode(bytes, num_bytes);
+  }
+
+  /** Throws if `count` items of `item_bytes` each cannot fit in the stream */
+  void check_count(uint64_t const count, std::size_t const item_bytes) const {
+    if (remaining != unknown_size && count > remaining / item_bytes)
+      throw std::runtime_error("Truncated coverage file");
+  }
+
+  /** Reads `count` u32s, after checking they can be there */
+  std::vector<uint32_t> get_u32s(uint64_t const count) {
+    check_count(count, 4);
+    constexpr uint64_t chunk_size{uint64_t{1} << 16};
+    std::vector<uint32_t> values;
+    std::vector<unsigned char> bytes;
+    while (values.size() < count) {
+      auto const num_values = std::min(count - values.size(), chunk_size);
+      bytes.resize(num_values * 4);
+      read_bytes(reinterpret_cast<char *>(bytes.data()), bytes.size());
+      for (std::size_t i = 0; i < num_values; ++i)
+        values.push_back(decode(bytes.data() + 4 * i, 4));
+    }
+    return values;
+  }
+
+  /** Reads a u32 count, then that many u32s */
+  std::vector<uint32_t> get_u32s() { return get_u32s(get(4)); }
+
+ private:
+  static constexpr uint64_t unknown_size{std::numeric_limits<uint64_t>::max()};
+  std::istream &stream;
+  uint64_t remaining{unknown_size};
+};
+}  // namespace
+
+void coverage::file::write(std::ostream &stream, Coverage const &coverage) {
+  auto const num_sites = coverage.allele_sum_coverage.size();
+  bool const has_per_base = !coverage.allele_base_coverage.empty();
+  bool const has_graph_per_base = !coverage.graph_base_coverage.empty();
+  if (coverage.grouped_allele_counts.size() != num_sites ||
+      (has_per_base && coverage.allele_base_coverage.size() != num_sites))
+    throw std::invalid_argument(
+        "Coverage structures disagree on the number of sites");
+
+  std::string buffer(coverage_file_magic, sizeof coverage_file_magic);
+  put(buffer, COVERAGE_FILE_VERSION, 4);
+  put(buffer,
+      (has_per_base ? COVERAGE_FILE_HAS_PER_BASE : 0) |
+          (has_graph_per_base ? COVERAGE_FILE_HAS_GRAPH_PER_BASE : 0),
+      4);
+  put(buffer, num_sites, 8);
+
+  for (std::size_t site_index = 0; site_index < num_sites; ++site_index) {
+    put_u32s(buffer, coverage.allele_sum_coverage[site_index]);
+
+    auto const &site_groups = coverage.grouped_allele_counts[site_index];
+    std::vector<std::pair<AlleleIds, CovCount>> groups(site_groups.begin(),
+                                                       site_groups.end());
+    std::sort(groups.begin(), groups.end());
+    put(buffer, groups.size(), 4);
+    for (auto const &group : groups) {
+      put(buffer, group.first.size(), 4);
+      for (auto const allele_id : group.first) put(buffer, allele_id, 4);
+      put(buffer, group.second, 4);
+    }
+
+    if (has_per_base) {
+      auto const &site_pb_coverage = coverage.allele_base_coverage[site_index];
+      put(buffer, site_pb_coverage.size(), 4);
+      for (auto const &allele : site_pb_coverage) put_u32s(buffer, allele);
+    }
+    stream.write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+
+  if (has_graph_per_base) {
+    auto const &graph_base_coverage = coverage.graph_base_coverage;
+    put(buffer, graph_base_coverage.size(), 8);
+    for (auto const count : graph_base_coverage) put(buffer, count, 4);
+  }
+  stream.write(buffer.data(), buffer.size());
+  if (!stream) throw std::ios::failure("Failed writing coverage file");
+}
+
+Coverage coverage::file::read(std::istream &stream) {
+  CoverageReader reader{stream};
+  char magic[sizeof coverage_file_magic];
+  reader.read_bytes(magic, sizeof magic);
+  if (std::memcmp(magic, coverage_file_magic, sizeof magic) != 0)
+    throw std::runtime_error("Not a gramtools coverage file");
+  auto const version = reader.get(4);
+  if (version < 1 || version > COVERAGE_FILE_VERSION)
+    throw std::runtime_error("Unsupported coverage file version: " +
+                             std::to_string(version));
+  auto const flags = reader.get(4);
+  bool const has_per_base = flags & COVERAGE_FILE_HAS_PER_BASE;
+  bool const has_graph_per_base = flags & COVERAGE_FILE_HAS_GRAPH_PER_BASE;
+  auto const num_sites = reader.get(8);
+
+  // A site takes at least its allele and group counts
+  reader.check_count(num_sites, 8);
+  Coverage coverage{};
+  for (uint64_t site_index = 0; site_index < num_sites; ++site_index) {
+    coverage.allele_sum_coverage.push_back(reader.get_u32s());
+
+    GroupedAlleleCounts site_groups;
+    auto const num_groups = reader.get(4);
+    reader.check_count(num_groups, 8);
+    for (uint64_t group = 0; group < num_groups; ++group) {
+      auto const allele_ids = reader.get_u32s();
+      site_groups[AlleleIds(allele_ids.begin(), allele_ids.end())] =
+          reader.get(4);
+    }
+    coverage.grouped_allele_counts.push_back(std::move(site_groups));
+
+    if (has_per_base) {
+      auto const num_alleles = reader.get(4);
+      reader.check_count(num_alleles, 4);
+      SitePbCoverage site_pb_coverage;
+      for (uint64_t allele = 0; allele < num_alleles; ++allele)
+        site_pb_coverage.push_back(reader.get_u32s());
+      coverage.allele_base_coverage.push_back(std::move(site_pb_coverage));
+    }
+  }
+
+  if (has_graph_per_base)
+    coverage.graph_base_coverage = reader.get_u32s(reader.get(8));
+  return coverage;
+}
+
+void coverage::file::dump(std::string const &fpath, Coverage const &coverage,
+                          bool const compress) {
+  std::ofstream ofs{fpath, std::ios::binary};
+  if (!ofs) throw std::ios::failure("Cannot write to: " + fpath);
+  if (!compress) {
+    write(ofs, coverage);
+    return;
+  }
+  boost::iostreams::filtering_ostream out;
+  out.push(boost::iostreams::gzip_compressor());
+  out.push(ofs);
+  write(out, coverage);
+  // Flushes the gzip trailer
+  out.reset();
+  if (!ofs) throw std::ios::failure("Failed writing coverage file: " + fpath);
+}
+
+Coverage coverage::file::load(std::string const &fpath) {
+  std::ifstream ifs{fpath, std::ios::binary};
+  if (!ifs) throw std::ios::failure("Cannot open: " + fpath);
+  // gzip members start with bytes 0x1f 0x8b
+  bool const gzipped = ifs.peek() == 0x1f;
+  if (!gzipped) return read(ifs);
+  boost::iostreams::filtering_istream in;
+  in.push(boost::iostreams::gzip_decompressor());
+  in.push(ifs);
+  return read(in);
+}
+
+PerBaseCoverage coverage::file::graph_base_coverage(PRG_Info const &prg_info) {
+  auto const &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+  return pb_cov_store.get_range(0, pb_cov_store.size());
+}
+
+void coverage::file::restore_graph_base_coverage(
+    PerBaseCoverage const &graph_base_coverage, PRG_Info const &prg_info) {
+  auto &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+  if (graph_base_coverage.size() != pb_cov_store.size())
+    throw std::runtime_error(
+        "Graph per base coverage was recorded on a different prg");
+  for (std::size_t base = 0; base < graph_base_coverage.size(); ++base)
+    pb_cov_store.set(base, graph_base_coverage[base]);
+}
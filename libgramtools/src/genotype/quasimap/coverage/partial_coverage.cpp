@@ -0,0 +1,113 @@
+#include "genotype/quasimap/coverage/partial_coverage.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/vector.hpp>
+#include <fstream>
+#include <limits>
+
+using namespace gram;
+
+static std::string const partial_coverage_magic{"gramtools partial coverage"};
+
+void coverage::partial::dump(std::string const &fpath,
+                             QuasimapReadsStats const &quasimap_stats,
+                             ReadStats const &readstats,
+                             PRG_Info const &prg_info) {
+  std::ofstream ofs{fpath, std::ios::binary};
+  if (!ofs) throw std::ios::failure("Cannot write to: " + fpath);
+  boost::archive::binary_oarchive oa{ofs};
+
+  auto const &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+  uint32_t const version{PARTIAL_COVERAGE_VERSION};
+  uint64_t const prg_size{prg_info.coverage_graph.random_access.size()};
+  uint64_t const num_sites{prg_info.num_variant_sites};
+  uint64_t const num_bases{pb_cov_store.size()};
+  oa << partial_coverage_magic << version;
+  oa << prg_size << site_ends_hash(prg_info) << num_sites << num_bases;
+
+  for (auto const count : read_counts(quasimap_stats)) oa << *count;
+  oa << quasimap_stats.coverage.allele_sum_coverage;
+  oa << quasimap_stats.coverage.grouped_allele_counts;
+  PerBaseCoverage const base_coverage = pb_cov_store.get_range(0, num_bases);
+  oa << base_coverage;
+  oa << readstats;
+}
+
+void coverage::partial::merge(std::string const &fpath,
+                              QuasimapReadsStats &quasimap_stats,
+                              ReadStats &readstats, PRG_Info const &prg_info) {
+  std::ifstream ifs{fpath, std::ios::binary};
+  if (!ifs) throw std::ios::failure("Cannot open: " + fpath);
+  boost::archive::binary_iarchive ia{ifs};
+
+  std::string magic;
+  uint32_t version;
+  ia >> magic >> version;
+  if (magic != partial_coverage_magic || version != PARTIAL_COVERAGE_VERSION)
+    throw std::runtime_error(
+        fpath + " is not a partial coverage file (version " +
+        std::to_string(PARTIAL_COVERAGE_VERSION) + ")");
+  uint64_t prg_size, prg_site_ends_hash, num_sites, num_bases;
+  ia >> prg_size >> prg_site_ends_hash >> num_sites >> num_bases;
+  auto &pb_cov_store = *prg_info.coverage_graph.pb_cov_store;
+  if (prg_size != prg_info.coverage_graph.random_access.size() ||
+      prg_site_ends_hash != site_ends_hash(prg_info) ||
+      num_sites != prg_info.num_variant_sites ||
+      num_bases != pb_cov_store.size())
+    throw std::runtime_error(fpath +
+                             " holds the partial coverage of a different prg");
+
+  for (auto const count : read_counts(quasimap_stats)) {
+    uint64_t partial_count;
+    ia >> partial_count;
+    *count += partial_count;
+  }
+
+  auto &coverage = quasimap_stats.coverage;
+  AlleleSumCoverage allele_sum_coverage;
+  ia >> allele_sum_coverage;
+  for (std::size_t site = 0; site < allele_sum_coverage.size(); ++site) {
+    auto &site_coverage = coverage.allele_sum_coverage.at(site);
+    for (std::size_t allele = 0; allele < allele_sum_coverage[site].size();
+         ++allele)
+      site_coverage.at(allele) += allele_sum_coverage[site][allele];
+  }
+
+  SitesGroupedAlleleCounts grouped_allele_counts;
+  ia >> grouped_allele_counts;
+  for (std::size_t site = 0; site < grouped_allele_counts.size(); ++site) {
+    auto &site_counts = coverage.grouped_allele_counts.at(site);
+    for (auto const &entry : grouped_allele_counts[site])
+      site_counts[entry.first] += entry.second;
+  }
+
+  PerBaseCoverage base_coverage;
+  ia >> base_coverage;
+  for (std::size_t base = 0; base < base_coverage.size(); ++base) {
+    if (base_coverage[base] == 0) continue;
+    uint64_t const total =
+        uint64_t{pb_cov_store.get(base)} + base_coverage[base];
+    pb_cov_store.set(base, static_cast<CovCount>(std::min<uint64_t>(
+                               total, std::numeric_limits<CovCount>::max())));
+  }
+
+  ReadStats partial_readstats;
+  ia >> partial_readstats;
+  readstats.merge(partial_readstats);
+}
+
+QuasimapReadsStats coverage::partial::merge_all(
+    std::vector<std::string> const &fpaths, ReadStats &readstats,
+    PRG_Info const &prg_info) {
+  QuasimapReadsStats quasimap_stats{};
+  quasimap_stats.coverage = coverage::generate::empty_structure(prg_info);
+  for (auto const &fpath : fpaths) {
+    std::cout << "Merging partial coverage from " << fpath << std::endl;
+    merge(fpath, quasimap_stats, readstats, prg_info);
+  }
+  readstats.finalise_base_error_rate();
+  return quasimap_stats;
+}
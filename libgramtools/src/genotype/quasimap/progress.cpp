@@ -0,0 +1,131 @@
+#include "genotype/quasimap/progress.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using namespace gram;
+namespace fs = std::filesystem;
+
+double ProgressSnapshot::reads_per_second() const {
+  return seconds > 0 ? num_reads / seconds : 0;
+}
+
+double ProgressSnapshot::mapped_fraction() const {
+  return num_reads > 0 ? static_cast<double>(num_mapped_reads) / num_reads
+                       : 0;
+}
+
+double ProgressSnapshot::eta_seconds() const {
+  if (num_bytes == 0 || total_bytes == 0) return -1;
+  auto const bytes_left = total_bytes > num_bytes ? total_bytes - num_bytes : 0;
+  return seconds * bytes_left / num_bytes;
+}
+
+std::string ProgressSnapshot::to_json() const {
+  nlohmann::json json{{"seconds", seconds},
+                      {"reads", num_reads},
+                      {"mapped_reads", num_mapped_reads},
+                      {"reads_per_second", reads_per_second()},
+                      {"mapped_fraction", mapped_fraction()},
+                      {"bytes_loaded", num_bytes},
+                      {"total_bytes", total_bytes}};
+  auto const eta = eta_seconds();
+  json["eta_seconds"] = eta < 0 ? nlohmann::json() : nlohmann::json(eta);
+  return json.dump();
+}
+
+std::string ProgressSnapshot::to_string() const {
+  std::stringstream result;
+  result << std::fixed;
+  result.precision(1);
+  result << "Processed reads: " << num_reads
+         << " (mapped: " << 100 * mapped_fraction() << "%, "
+         << reads_per_second() << " reads/s";
+  auto const eta = eta_seconds();
+  if (eta >= 0) result << ", about " << eta << " s left";
+  result << ")";
+  return result.str();
+}
+
+ProgressReporter::ProgressReporter(std::size_t const num_threads,
+                                   uint64_t const total_bytes,
+                                   std::string progress_fpath,
+                                   double const report_seconds)
+    : threads(std::max<std::size_t>(1, num_threads)),
+      total_bytes(total_bytes),
+      progress_fpath(std::move(progress_fpath)),
+      report_seconds(report_seconds),
+      start_time(omp_get_wtime()) {
+  if (report_seconds > 0) reporter = std::thread(&ProgressReporter::run, this);
+}
+
+ProgressReporter::~ProgressReporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  stop_condition.notify_one();
+  if (reporter.joinable()) reporter.join();
+  if (report_seconds <= 0 && progress_fpath.empty()) return;
+  try {
+    report(snapshot());
+  } catch (std::exception const &e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+ProgressSnapshot ProgressReporter::snapshot() const {
+  ProgressSnapshot result;
+  result.seconds = omp_get_wtime() - start_time;
+  result.total_bytes = total_bytes;
+  for (auto const &thread : threads) {
+    result.num_reads += thread.num_reads.load(std::memory_order_relaxed);
+    result.num_mapped_reads +=
+        thread.num_mapped_reads.load(std::memory_order_relaxed);
+    result.num_bytes += thread.num_bytes.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+void ProgressReporter::report(ProgressSnapshot const &snapshot) {
+  std::cerr << snapshot.to_string() << std::endl;
+  if (progress_fpath.empty()) return;
+  // Written in full before replacing the previous report, so that the file
+  // never gets polled half written
+  auto const tmp_fpath = progress_fpath + ".tmp";
+  {
+    std::ofstream ofs{tmp_fpath};
+    if (!ofs) throw std::ios::failure("Cannot write to: " + tmp_fpath);
+    ofs << snapshot.to_json() << std::endl;
+  }
+  fs::rename(tmp_fpath, progress_fpath);
+}
+
+void ProgressReporter::run() {
+  auto const interval = std::chrono::duration<double>(report_seconds);
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stop_condition.wait_for(lock, interval, [&] { return stopping; })) {
+    try {
+      report(snapshot());
+    } catch (std::exception const &e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+}
+
+uint64_t gram::files_size(std::vector<std::string> const &fpaths) {
+  uint64_t result = 0;
+  for (auto const &fpath : fpaths) {
+    std::error_code error;
+    auto const size = fs::file_size(fpath, error);
+    if (!error) result += size;
+  }
+  return result;
+}
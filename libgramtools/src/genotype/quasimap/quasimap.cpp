@@ -2,21 +2,38 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <exception>
+#include <filesystem>
+#include <limits>
 #include <stdexcept>
 
 #include "common/random.hpp"
+#include "genotype/quasimap/checkpoint.hpp"
 #include "genotype/quasimap/coverage/allele_base.hpp"
 #include "genotype/quasimap/coverage/coverage_common.hpp"
+#include "genotype/quasimap/coverage/coverage_file.hpp"
+#include "genotype/quasimap/progress.hpp"
 #include "genotype/quasimap/search/BWT_search.hpp"
+#include "genotype/quasimap/search/approximate_search.hpp"
+#include "genotype/quasimap/search/seed_extend.hpp"
 #include "genotype/quasimap/search/vBWT_jump.hpp"
 
 using namespace gram;
 
-QuasimapReadsStats gram::quasimap_reads(const GenotypeParams &parameters,
-                                        const KmerIndex &kmer_index,
-                                        const PRG_Info &prg_info,
-                                        ReadStats &readstats) {
+/**
+ * The seed of the reads sampler of the `stream`-th `ReadStats`, off the master
+ * seed. Its counter is one no read gets, so that it differs from read keys.
+ */
+static uint64_t sampler_seed(SeedSize const master_seed,
+                             uint64_t const stream) {
+  return derive_key(master_seed, stream, std::numeric_limits<uint64_t>::max());
+}
+
+QuasimapReadsStats gram::quasimap_reads(
+    const GenotypeParams &parameters, const KmerIndex &kmer_index,
+    const PRG_Info &prg_info, ReadStats &readstats,
+    genotype::RegionSelection const *const regions) {
   QuasimapReadsStats quasimap_stats{};
   std::cout << "Generating allele quasimap data structure" << std::endl;
   // The coverage structure records mapped allele counts (per site), aggregated
@@ -24,50 +41,101 @@ QuasimapReadsStats gram::quasimap_reads(const GenotypeParams &parameters,
   quasimap_stats.coverage = coverage::generate::empty_structure(prg_info);
   std::cout << "Done generating allele quasimap data structure" << std::endl;
 
-  // Produces seeds to initialise other random number generators used
-  // in multi-mapping read selection
+  // Picks the master seed (if not given), off which the keys of multi-mapping
+  // read selection derive
   auto master_seed_generator = RandomInclusiveInt(parameters.seed);
 
+  ReadsProgress progress;
+  if (parameters.resume &&
+      std::filesystem::exists(parameters.checkpoint_fpath)) {
+    progress = load_checkpoint(parameters, prg_info, quasimap_stats,
+                               master_seed_generator);
+    uint64_t num_mapped = 0;
+    for (auto const num_reads : progress.num_reads) num_mapped += num_reads;
+    std::cout << "Resuming from checkpoint: " << num_mapped << " reads mapped"
+              << std::endl;
+  }
+  SeedSize const master_seed{master_seed_generator.get_seed().value()};
+  Checkpointer checkpointer{parameters, prg_info, master_seed};
+
   std::cout << "Master random seed for read selection: "
-            << std::to_string(master_seed_generator.get_seed().value())
-            << std::endl;
+            << std::to_string(master_seed) << std::endl;
   std::cout << "Maximum thread count: " << parameters.maximum_threads
             << std::endl;
 
   std::cout << "Processing reads:" << std::endl;
 
-  // Execute quasimap for each read file provided
-  for (const auto &reads_fpath : parameters.reads_fpaths) {
-    handle_read_file(quasimap_stats, reads_fpath, parameters, kmer_index,
-                     prg_info, &master_seed_generator);
+  std::unique_ptr<MappedReadCache> read_cache;
+  if (parameters.read_cache_size > 0)
+    read_cache = std::make_unique<MappedReadCache>(parameters.read_cache_size);
+
+  auto const region_kmers = regions == nullptr ? nullptr : &regions->kmers;
+  {
+    ProgressReporter progress_reporter{
+        static_cast<std::size_t>(omp_get_max_threads()),
+        files_size(parameters.reads_fpaths), parameters.progress_fpath,
+        static_cast<double>(parameters.progress_seconds)};
+    handle_read_files(quasimap_stats, parameters, kmer_index, prg_info,
+                      master_seed, progress, region_kmers, read_cache.get(),
+                      &checkpointer, &progress_reporter);
   }
+  // Lets a run killed after mapping resume without mapping again
+  if (parameters.checkpoint_seconds > 0)
+    checkpointer.write(quasimap_stats, progress);
+  // Off a stream that no reads file has
+  readstats.seed_sampler(
+      sampler_seed(master_seed, parameters.reads_fpaths.size()));
+  // In reads file order, so that statistics do not depend on which reads
+  // files got mapped together
+  for (auto const &file_readstats : progress.readstats)
+    readstats.merge(file_readstats);
+  readstats.finalise_base_error_rate();
+  if (read_cache != nullptr)
+    quasimap_stats.read_cache_bytes = read_cache->memory_usage();
+  return quasimap_stats;
+}
 
+void gram::finalise_coverage(QuasimapReadsStats &quasimap_stats,
+                             ReadStats &readstats,
+                             const GenotypeParams &parameters,
+                             const PRG_Info &prg_info,
+                             genotype::RegionSelection const *const regions) {
   auto &coverage = quasimap_stats.coverage;
   // Compute read mapping statistics (used in `infer` command). Can only be done
   // after mapping!
-  readstats.compute_coverage_depth(coverage, prg_info.coverage_graph);
+  if (regions == nullptr)
+    readstats.compute_coverage_depth(coverage, prg_info.coverage_graph);
+  else
+    readstats.compute_coverage_depth(coverage, prg_info.coverage_graph,
+                                     regions->sites);
 
   // Extract non-nested per base coverage
   coverage.allele_base_coverage =
       coverage::generate::allele_base_non_nested(prg_info);
+  // Nested per base coverage is kept as the coverage graph holds it
+  if (prg_info.coverage_graph.is_nested)
+    coverage.graph_base_coverage =
+        coverage::file::graph_base_coverage(prg_info);
 
   // Write coverage results to disk
   coverage::dump::all(coverage, parameters);
-  return quasimap_stats;
 }
 
 /**
- * Emplace up to `max_set_size` reads into the reads buffer.
+ * Emplace up to `max_set_size` reads into the reads buffer, recording their
+ * statistics in `readstats`.
  * Returns a vector of `Pattern`s: a `Pattern` being a vector of `Base`s, which
  * are integer encoded. The encoding of DNA letters to integers also performed
  * in this function.
  */
 std::vector<Sequence> get_reads_buffer(SeqRead::SeqIterator &reads_it,
                                        SeqRead &reads,
-                                       const uint64_t &max_set_size) {
+                                       const uint64_t &max_set_size,
+                                       ReadStats &readstats) {
   std::vector<Sequence> reads_buffer;
   while (reads_it != reads.end() and reads_buffer.size() < max_set_size) {
     const auto *const raw_read = *reads_it;
+    readstats.record_read(*raw_read);
     auto read = encode_dna_bases(*raw_read);
     reads_buffer.emplace_back(read);
     ++reads_it;
@@ -75,92 +143,333 @@ std::vector<Sequence> get_reads_buffer(SeqRead::SeqIterator &reads_it,
   return reads_buffer;
 }
 
+ReadCounts &ReadCounts::operator+=(ReadCounts const &other) {
+  all_reads_count += other.all_reads_count;
+  skipped_reads_count += other.skipped_reads_count;
+  missing_kmer_reads_count += other.missing_kmer_reads_count;
+  no_extension_reads_count += other.no_extension_reads_count;
+  exact_mapped_reads_count += other.exact_mapped_reads_count;
+  inexact_mapped_reads_count += other.inexact_mapped_reads_count;
+  off_region_reads_count += other.off_region_reads_count;
+  cached_reads_count += other.cached_reads_count;
+  return *this;
+}
+
 /**
- * Calls the (forward_reverse) mapping routine for each read in the read buffer,
- * in parallel (if the CL option has been specified).
+ * Calls the (forward_reverse) mapping routine on a read, unless it is empty or
+ * (if regions are specified) shares no kmer with the regions.
+ * @return whether the read (or its reverse complement) got mapped.
  */
-void handle_reads_buffer(QuasimapReadsStats &quasimap_stats,
-                         const std::vector<Sequence> &reads_buffer,
-                         Seeds const &selection_seeds,
-                         const GenotypeParams &parameters,
-                         const KmerIndex &kmer_index,
-                         const PRG_Info &prg_info) {
-  uint64_t last_count_reported = 0;
-
-#pragma omp parallel for
-  for (std::size_t i = 0; i < reads_buffer.size(); ++i) {
-    auto thread_id = omp_get_thread_num();
-    //  Report total number of mapped reads everytime at least `diff` such have
-    //  been mapped
-    if (thread_id == 0) {
-      uint64_t diff = quasimap_stats.all_reads_count - last_count_reported;
-      if (diff >= 10000) {
-        std::cout << quasimap_stats.all_reads_count << std::endl;
-        last_count_reported = quasimap_stats.all_reads_count;
-      }
-    }
+static bool map_buffered_read(ReadCounts &read_counts, Coverage &coverage,
+                              Sequence const &read,
+                              SelectionKey const &selection_key,
+                              GenotypeParams const &parameters,
+                              KmerIndex const &kmer_index,
+                              PRG_Info const &prg_info,
+                              genotype::KmerSet const *const region_kmers,
+                              MappedReadCache *const read_cache,
+                              RecordingBuffers &buffers) {
+  //  Increment by 2: mapping forward and reverse of read
+  read_counts.all_reads_count += 2;
+
+  if (read.empty()) {
+    read_counts.skipped_reads_count += 2;
+    return false;
+  }
+  if (region_kmers != nullptr &&
+      !genotype::read_hits_kmers(read, parameters.kmers_size, *region_kmers) &&
+      !genotype::read_hits_kmers(reverse_complement_read(read),
+                                 parameters.kmers_size, *region_kmers)) {
+    read_counts.off_region_reads_count += 2;
+    return false;
+  }
+  auto const num_mapped = read_counts.exact_mapped_reads_count +
+                          read_counts.inexact_mapped_reads_count;
+  quasimap_forward_reverse(read_counts, coverage, read, parameters, kmer_index,
+                           prg_info, selection_key, read_cache, &buffers);
+  return read_counts.exact_mapped_reads_count +
+             read_counts.inexact_mapped_reads_count >
+         num_mapped;
+}
 
-//  atomic: for manipulating a static variable (shared among the threads)
-#pragma omp atomic
-    quasimap_stats.all_reads_count +=
-        2;  //  Increment by 2: mapping forward and reverse of read
+void gram::ReadBatchSizer::update(std::size_t const num_reads,
+                                  double const seconds) {
+  if (num_reads == 0 || seconds <= 0) return;
+  auto const target_size = num_reads / seconds * TARGET_READS_BATCH_SECONDS;
+  batch_size = static_cast<std::size_t>(
+      std::min<double>(std::max<double>(target_size, MIN_READS_BATCH_SIZE),
+                       MAX_READS_BATCH_SIZE));
+}
 
-    auto const read = reads_buffer.at(i);
-    if (read.empty()) {
-#pragma omp atomic
-      quasimap_stats.skipped_reads_count += 2;
-      continue;
+namespace {
+/** A reads file that batches of reads get loaded from */
+struct ReadsSource {
+  /** Opens the reads file, skipping its first `num_mapped` reads */
+  ReadsSource(std::string const &reads_fpath, std::size_t const file_index,
+              uint64_t const num_mapped)
+      : reads(reads_fpath.c_str()),
+        reads_it(reads.begin()),
+        file_index(file_index),
+        num_loaded(num_mapped) {
+    for (uint64_t i = 0; i < num_mapped; ++i, ++reads_it) {
+      if (reads_it == reads.end())
+        throw std::runtime_error(reads_fpath +
+                                 " has fewer reads than got mapped from it");
     }
-    auto const selection_seed = selection_seeds.at(i);
-    quasimap_forward_reverse(quasimap_stats, read, parameters, kmer_index,
-                             prg_info, selection_seed);
   }
+
+  bool exhausted() { return reads_it == reads.end(); }
+
+  /** Bytes of the reads file read since the last call */
+  uint64_t take_bytes_read() {
+    auto const bytes_read = reads.bytes_read();
+    auto const result =
+        bytes_read > bytes_counted ? bytes_read - bytes_counted : 0;
+    bytes_counted = std::max(bytes_counted, bytes_read);
+    return result;
+  }
+
+  SeqRead reads;
+  SeqRead::SeqIterator reads_it;
+  std::size_t file_index;
+  uint64_t num_loaded;
+  uint64_t bytes_counted = 0;
+};
+
+/** Consecutive reads of a batch, from one reads file */
+struct ReadsPart {
+  std::size_t file_index;
+  uint64_t first_read_index; /**< In the reads file */
+  std::vector<Sequence> reads;
+};
+
+/**
+ * Loads up to `max_size` reads from `source`, recording their statistics in
+ * `readstats`.
+ */
+ReadsPart load_part(ReadsSource &source, std::size_t const max_size,
+                    ReadStats &readstats) {
+  ReadsPart part{source.file_index, source.num_loaded};
+  part.reads =
+      get_reads_buffer(source.reads_it, source.reads, max_size, readstats);
+  source.num_loaded += part.reads.size();
+  return part;
 }
+}  // namespace
+
+void gram::handle_read_files(QuasimapReadsStats &quasimap_stats,
+                             const GenotypeParams &parameters,
+                             const KmerIndex &kmer_index,
+                             const PRG_Info &prg_info,
+                             SeedSize const &master_seed,
+                             ReadsProgress &progress,
+                             genotype::KmerSet const *const region_kmers,
+                             MappedReadCache *const read_cache,
+                             Checkpointer *const checkpointer,
+                             ProgressReporter *const progress_reporter) {
+  auto const &reads_fpaths = parameters.reads_fpaths;
+  progress.num_reads.resize(reads_fpaths.size(), 0);
+  // Those resumed from a checkpoint already carry on their sampler's state
+  auto const num_resumed = progress.readstats.size();
+  progress.readstats.resize(reads_fpaths.size());
+  for (auto file_index = num_resumed; file_index < reads_fpaths.size();
+       ++file_index)
+    progress.readstats[file_index].seed_sampler(
+        sampler_seed(master_seed, file_index));
+  // Loading a part ties up a thread, so at least half of them are left to map
+  std::size_t const max_sources = std::max(1, omp_get_max_threads() / 2);
+  std::vector<std::unique_ptr<ReadsSource>> sources;
+  std::size_t next_file_index = 0;
+  ReadBatchSizer batch_sizer;
+
+  // Closes the exhausted reads files and opens the next ones in their place.
+  // Returns how many of the open reads files were already open.
+  auto open_sources = [&]() {
+    sources.erase(std::remove_if(sources.begin(), sources.end(),
+                                 [](auto &source) {
+                                   return source->exhausted();
+                                 }),
+                  sources.end());
+    auto const num_kept = sources.size();
+    while (sources.size() < max_sources &&
+           next_file_index < reads_fpaths.size()) {
+      auto source = std::make_unique<ReadsSource>(
+          reads_fpaths[next_file_index], next_file_index,
+          progress.num_reads[next_file_index]);
+      ++next_file_index;
+      if (!source->exhausted()) sources.push_back(std::move(source));
+    }
+    return num_kept;
+  };
+  // Each batch takes reads from all open reads files, for about the batch size
+  auto part_size = [&]() {
+    return std::max<std::size_t>(1, batch_sizer.size() / sources.size());
+  };
+  auto load_source = [&](std::size_t const source_index,
+                         std::size_t const max_size) {
+    auto &source = *sources[source_index];
+    auto part =
+        load_part(source, max_size, progress.readstats[source.file_index]);
+    if (progress_reporter != nullptr)
+      ThreadProgress::add(
+          progress_reporter->thread_progress(omp_get_thread_num()).num_bytes,
+          source.take_bytes_read());
+    return part;
+  };
+  // Loads parts from the open reads files from `first_source` on
+  auto load_parts = [&](std::size_t const first_source,
+                        std::vector<ReadsPart> &parts) {
+    if (first_source >= sources.size()) return;
+    auto const max_size = part_size();
+    auto const num_loaded = parts.size();
+    parts.resize(num_loaded + sources.size() - first_source);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (std::size_t i = first_source; i < sources.size(); ++i)
+      parts[num_loaded + i - first_source] = load_source(i, max_size);
+  };
+
+  std::vector<ReadsPart> parts, next_parts;
+  open_sources();
+  load_parts(0, parts);
+  // Where each part starts in the batch
+  std::vector<std::size_t> part_starts;
+  while (!parts.empty()) {
+    part_starts.clear();
+    std::size_t batch_size = 0;
+    for (auto const &part : parts) {
+      part_starts.push_back(batch_size);
+      batch_size += part.reads.size();
+    }
+
+    double busy_seconds = 0, loading_seconds = 0;
+    int num_threads = 1;
+    auto const start_time = omp_get_wtime();
+    // Checkpoints must not hold reads that are loaded but not yet mapped, so
+    // the next batch only gets loaded once they are written
+    bool const write_checkpoint =
+        checkpointer != nullptr && checkpointer->due();
+    auto const next_part_size = part_size();
+    next_parts.clear();
+    if (!write_checkpoint) next_parts.resize(sources.size());
+
+#pragma omp parallel
+    {
+#pragma omp single
+      num_threads = omp_get_num_threads();
+
+      // One thread per open reads file loads the next batch while the others
+      // start mapping this one; they then join in on what is left of it
+      double thread_loading_seconds = 0;
+      if (!write_checkpoint) {
+#pragma omp for schedule(dynamic, 1) nowait
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+          auto const load_start_time = omp_get_wtime();
+          next_parts[i] = load_source(i, next_part_size);
+          thread_loading_seconds += omp_get_wtime() - load_start_time;
+        }
+      }
 
-void gram::handle_read_file(QuasimapReadsStats &quasimap_stats,
-                            const std::string &reads_fpath,
-                            const GenotypeParams &parameters,
-                            const KmerIndex &kmer_index,
-                            const PRG_Info &prg_info,
-                            RandomGenerator *const seed_generator) {
-  //  Number of reads to load in memory; is upper limit of number of reads that
-  //  can be mapped in parallel
-  uint64_t max_num_reads = 5000;
-  // Used for random selection of multi-mapping reads
-  Seeds selection_seeds(max_num_reads);
-
-  SeqRead reads(reads_fpath.c_str());
-  auto reads_it = reads.begin();
-  while (reads_it != reads.end()) {
-    auto reads_buffer = get_reads_buffer(reads_it, reads, max_num_reads);
-    for (int i = 0; i < max_num_reads; i++)
-      selection_seeds.at(i) = (*seed_generator)();
-    handle_reads_buffer(quasimap_stats, reads_buffer, selection_seeds,
-                        parameters, kmer_index, prg_info);
+      double thread_busy_seconds = 0;
+      ReadCounts thread_read_counts;
+      RecordingBuffers thread_buffers;
+      auto *const thread_progress =
+          progress_reporter == nullptr
+              ? nullptr
+              : &progress_reporter->thread_progress(omp_get_thread_num());
+#pragma omp for schedule(dynamic, READS_CHUNK_SIZE)
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        auto const read_start_time = omp_get_wtime();
+        auto const part_index =
+            std::upper_bound(part_starts.begin(), part_starts.end(), i) -
+            part_starts.begin() - 1;
+        auto const &part = parts[part_index];
+        auto const read_index = i - part_starts[part_index];
+        auto const selection_key =
+            derive_key(master_seed, part.file_index,
+                       part.first_read_index + read_index);
+        auto const mapped = map_buffered_read(
+            thread_read_counts, quasimap_stats.coverage,
+            part.reads[read_index], selection_key, parameters, kmer_index,
+            prg_info, region_kmers, read_cache, thread_buffers);
+        if (thread_progress != nullptr) {
+          ThreadProgress::add(thread_progress->num_reads, 1);
+          if (mapped) ThreadProgress::add(thread_progress->num_mapped_reads, 1);
+        }
+        thread_busy_seconds += omp_get_wtime() - read_start_time;
+      }
+#pragma omp critical(sum_read_counts)
+      {
+        busy_seconds += thread_busy_seconds;
+        loading_seconds += thread_loading_seconds;
+        quasimap_stats += thread_read_counts;
+      }
+    }
+
+    auto const elapsed_seconds = omp_get_wtime() - start_time;
+    batch_sizer.update(batch_size, elapsed_seconds);
+    ++quasimap_stats.read_batches_count;
+    quasimap_stats.mapping_seconds += elapsed_seconds;
+    quasimap_stats.mapping_thread_seconds += elapsed_seconds * num_threads;
+    quasimap_stats.loading_thread_seconds += loading_seconds;
+    quasimap_stats.idle_thread_seconds +=
+        std::max(0.0, elapsed_seconds * num_threads - busy_seconds -
+                          loading_seconds);
+    for (auto const &part : parts)
+      progress.num_reads[part.file_index] += part.reads.size();
+
+    if (write_checkpoint) checkpointer->write(quasimap_stats, progress);
+    // Reads files opened in place of exhausted ones have no part loaded yet,
+    // and neither has any if a checkpoint got written
+    auto const num_kept = open_sources();
+    load_parts(write_checkpoint ? 0 : num_kept, next_parts);
+    next_parts.erase(std::remove_if(next_parts.begin(), next_parts.end(),
+                                    [](ReadsPart const &part) {
+                                      return part.reads.empty();
+                                    }),
+                     next_parts.end());
+    std::swap(parts, next_parts);
   }
 }
 
-void gram::quasimap_forward_reverse(QuasimapReadsStats &quasimap_stats,
-                                    const Sequence &read,
+void gram::quasimap_forward_reverse(ReadCounts &read_counts,
+                                    Coverage &coverage, const Sequence &read,
                                     const GenotypeParams &parameters,
                                     const KmerIndex &kmer_index,
                                     const PRG_Info &prg_info,
-                                    SeedSize const &selection_seed) {
-  // Forward mapping
-  quasimap_read(read, quasimap_stats.coverage, kmer_index, prg_info, parameters,
-                quasimap_stats, selection_seed);
+                                    SelectionKey const &selection_key,
+                                    MappedReadCache *const read_cache,
+                                    RecordingBuffers *const buffers) {
+  auto mappings = read_cache == nullptr ? nullptr : read_cache->find(read);
+  if (mappings != nullptr) {
+    read_counts.cached_reads_count += 2;
+  } else {
+    auto reverse_read = reverse_complement_read(read);
+    mappings = std::make_shared<ReadMappings const>(ReadMappings{
+        map_read(read, kmer_index, prg_info, parameters),
+        map_read(reverse_read, kmer_index, prg_info, parameters)});
+    if (read_cache != nullptr) read_cache->insert(read, mappings);
+  }
 
-  auto reverse_read = reverse_complement_read(read);
+  // Forward mapping
+  record_read_mapping(mappings->forward, read.size(), coverage, prg_info,
+                      read_counts, selection_key, buffers);
   // Reverse mapping
-  quasimap_read(reverse_read, quasimap_stats.coverage, kmer_index, prg_info,
-                parameters, quasimap_stats, selection_seed);
+  record_read_mapping(mappings->reverse, read.size(), coverage, prg_info,
+                      read_counts, selection_key, buffers);
 }
 
 void gram::quasimap_read(const Sequence &read, Coverage &coverage,
                          const KmerIndex &kmer_index, const PRG_Info &prg_info,
-                         const GenotypeParams &parameters,
-                         QuasimapReadsStats &stats,
-                         SeedSize const &selection_seed) {
+                         const GenotypeParams &parameters, ReadCounts &stats,
+                         SelectionKey const &selection_key) {
+  record_read_mapping(map_read(read, kmer_index, prg_info, parameters),
+                      read.size(), coverage, prg_info, stats, selection_key);
+}
+
+static ReadMapping map_read_exactly(const Sequence &read,
+                                   const KmerIndex &kmer_index,
+                                   const PRG_Info &prg_info,
+                                   const GenotypeParams &parameters) {
   /*
    * We can discard reads containing 1 or more kmers not present in the index.
    * This is based on the following assumptions:
@@ -169,28 +478,65 @@ void gram::quasimap_read(const Sequence &read, Coverage &coverage,
    */
   bool read_can_map_exactly =
       all_read_kmers_occur_in_index(parameters.kmers_size, read, kmer_index);
-  if (not read_can_map_exactly) {
-#pragma omp atomic
-    stats.missing_kmer_reads_count += 1;
-    return;
+  if (not read_can_map_exactly)
+    return ReadMapping{ReadMappingOutcome::missing_kmer, {}};
+
+  SearchStates search_states;
+  if (parameters.search_mode == SearchMode::SeedExtend)
+    search_states = search_read_seed_extend(read, parameters.kmers_size,
+                                            kmer_index, prg_info);
+  else {
+    auto seeding_kmer = get_last_kmer_in_read(parameters.kmers_size, read);
+    search_states =
+        search_read_backwards(read, seeding_kmer, kmer_index, prg_info);
   }
-
-  auto seeding_kmer = get_last_kmer_in_read(parameters.kmers_size, read);
-  auto search_states =
-      search_read_backwards(read, seeding_kmer, kmer_index, prg_info);
   // Test read did not map
-  if (search_states.empty()) {
-#pragma omp atomic
-    stats.no_extension_reads_count += 1;
-    return;
+  if (search_states.empty())
+    return ReadMapping{ReadMappingOutcome::no_extension, {}};
+
+  return ReadMapping{ReadMappingOutcome::mapped, std::move(search_states)};
+}
+
+ReadMapping gram::map_read(const Sequence &read, const KmerIndex &kmer_index,
+                           const PRG_Info &prg_info,
+                           const GenotypeParams &parameters) {
+  auto mapping = map_read_exactly(read, kmer_index, prg_info, parameters);
+  if (mapping.outcome == ReadMappingOutcome::mapped ||
+      parameters.max_mismatches == 0 || read.size() < parameters.kmers_size)
+    return mapping;
+
+  auto search_states = search_read_approximate(
+      read, parameters.kmers_size, kmer_index, prg_info,
+      parameters.max_mismatches, parameters.max_search_states);
+  if (search_states.empty()) return mapping;
+  return ReadMapping{ReadMappingOutcome::mapped_inexact,
+                     std::move(search_states)};
+}
+
+void gram::record_read_mapping(ReadMapping const &mapping,
+                               std::size_t const read_length,
+                               Coverage &coverage, const PRG_Info &prg_info,
+                               ReadCounts &stats,
+                               SelectionKey const &selection_key,
+                               RecordingBuffers *const buffers) {
+  switch (mapping.outcome) {
+    case ReadMappingOutcome::missing_kmer:
+      stats.missing_kmer_reads_count += 1;
+      return;
+    case ReadMappingOutcome::no_extension:
+      stats.no_extension_reads_count += 1;
+      return;
+    case ReadMappingOutcome::mapped:
+      stats.exact_mapped_reads_count += 1;
+      break;
+    case ReadMappingOutcome::mapped_inexact:
+      stats.inexact_mapped_reads_count += 1;
+      break;
   }
 
-  auto read_length = read.size();
-  coverage::record::search_states(coverage, search_states, read_length,
-                                  prg_info, selection_seed);
-#pragma omp atomic
-  stats.exact_mapped_reads_count += 1;
-  return;
+  coverage::record::search_states(coverage, mapping.search_states,
+                                  read_length, prg_info, selection_key,
+                                  buffers);
 }
 
 Sequence gram::get_kmer_in_read(const uint32_t &kmer_size,
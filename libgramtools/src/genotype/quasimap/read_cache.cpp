@@ -0,0 +1,108 @@
+#include "genotype/quasimap/read_cache.hpp"
+
+#include <algorithm>
+
+#include "common/utils.hpp"
+
+using namespace gram;
+
+MappedReadCache::MappedReadCache(std::size_t const max_reads,
+                                 std::size_t const max_bytes)
+    : max_reads_per_shard(
+          std::max<std::size_t>(1, max_reads / READ_CACHE_SHARDS)),
+      max_bytes_per_shard(max_bytes / READ_CACHE_SHARDS),
+      shards(READ_CACHE_SHARDS) {}
+
+ReadMappingsPtr MappedReadCache::find(Sequence const &read) {
+  auto const read_hash = sequence_hash<Sequence>{}(read);
+  auto &shard = get_shard(read_hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  ++shard.lookups;
+  auto const found = shard.entries.find(read_hash);
+  // Hashes can collide, so the read itself is checked
+  if (found == shard.entries.end() || found->second.read != read)
+    return nullptr;
+  ++shard.hits;
+  return found->second.mappings;
+}
+
+void MappedReadCache::insert(Sequence const &read,
+                             ReadMappingsPtr const &mappings) {
+  auto const read_hash = sequence_hash<Sequence>{}(read);
+  // Also counts the hash table node
+  auto const bytes = sizeof(read_hash) + sizeof(Entry) +
+                     read_mappings_bytes(read, *mappings);
+  auto &shard = get_shard(read_hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // Already cached by another thread, or hash taken by a different read
+  if (shard.entries.find(read_hash) != shard.entries.end()) return;
+  // Too large to cache without evicting the whole shard
+  if (bytes > max_bytes_per_shard) return;
+
+  while (!shard.entries.empty() &&
+         (shard.entries.size() >= max_reads_per_shard ||
+          shard.bytes + bytes > max_bytes_per_shard)) {
+    auto const oldest = shard.entries.find(shard.insertion_order.front());
+    shard.bytes -= oldest->second.bytes;
+    shard.entries.erase(oldest);
+    shard.insertion_order.pop_front();
+  }
+  shard.entries.insert({read_hash, Entry{read, mappings, bytes}});
+  shard.insertion_order.push_back(read_hash);
+  shard.bytes += bytes;
+}
+
+std::size_t MappedReadCache::size() const {
+  std::size_t result{0};
+  for (auto const &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.entries.size();
+  }
+  return result;
+}
+
+uint64_t MappedReadCache::num_lookups() const {
+  uint64_t result{0};
+  for (auto const &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.lookups;
+  }
+  return result;
+}
+
+uint64_t MappedReadCache::num_hits() const {
+  uint64_t result{0};
+  for (auto const &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.hits;
+  }
+  return result;
+}
+
+std::size_t MappedReadCache::memory_usage() const {
+  std::size_t result{0};
+  for (auto const &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.bytes;
+  }
+  return result;
+}
+
+static std::size_t search_states_bytes(SearchStates const &search_states) {
+  // Each list node holds two pointers besides its `SearchState`
+  std::size_t result{0};
+  for (auto const &search_state : search_states) {
+    result += sizeof(SearchState) + 2 * sizeof(void *);
+    result += (search_state.traversed_path.capacity() +
+               search_state.traversing_path.capacity()) *
+              sizeof(VariantLocus);
+  }
+  return result;
+}
+
+std::size_t gram::read_mappings_bytes(Sequence const &read,
+                                      ReadMappings const &mappings) {
+  return sizeof(ReadMappings) + read.capacity() * sizeof(int_Base) +
+         search_states_bytes(mappings.forward.search_states) +
+         search_states_bytes(mappings.reverse.search_states);
+}
@@ -0,0 +1,130 @@
+#include "genotype/quasimap/search/approximate_search.hpp"
+
+#include <algorithm>
+
+#include "genotype/quasimap/quasimap.hpp"
+#include "genotype/quasimap/search/BWT_search.hpp"
+#include "genotype/quasimap/search/vBWT_jump.hpp"
+
+using namespace gram;
+
+std::vector<bool> gram::likely_error_positions(uint32_t const &kmer_size,
+                                               Sequence const &read,
+                                               KmerIndex const &kmer_index) {
+  std::vector<uint32_t> num_missing_kmers(read.size(), 0);
+  uint32_t total_missing_kmers{0};
+  for (std::size_t offset = 0; offset + kmer_size <= read.size(); ++offset) {
+    auto const kmer = get_kmer_in_read(kmer_size, offset, read);
+    if (kmer_index.find(kmer) != kmer_index.end()) continue;
+    ++total_missing_kmers;
+    for (auto pos = offset; pos < offset + kmer_size; ++pos)
+      ++num_missing_kmers[pos];
+  }
+
+  std::vector<bool> result(read.size(), true);
+  if (total_missing_kmers == 0) return result;
+
+  // A single error lies in all the kmers it makes go missing
+  bool const single_error = std::find(num_missing_kmers.begin(),
+                                      num_missing_kmers.end(),
+                                      total_missing_kmers) !=
+                            num_missing_kmers.end();
+  for (std::size_t pos = 0; pos < read.size(); ++pos) {
+    result[pos] = single_error ? num_missing_kmers[pos] == total_missing_kmers
+                               : num_missing_kmers[pos] > 0;
+  }
+  return result;
+}
+
+/**
+ * Adds the indexed search states of `kmer`, and of its variants with
+ * substitutions at positions from `pos` on, to `seeds`.
+ */
+static void seed_kmer_variants(Sequence &kmer, std::size_t const pos,
+                               uint32_t const num_mismatches,
+                               std::vector<bool> const &error_positions,
+                               KmerIndex const &kmer_index,
+                               MismatchSearchStates &seeds) {
+  if (pos == kmer.size()) {
+    auto const found = kmer_index.find(kmer);
+    if (found == kmer_index.end()) return;
+    auto search_states = found->second;
+    seeds[num_mismatches].splice(seeds[num_mismatches].end(), search_states);
+    return;
+  }
+  seed_kmer_variants(kmer, pos + 1, num_mismatches, error_positions,
+                     kmer_index, seeds);
+  if (num_mismatches + 1 == seeds.size() || !error_positions[pos]) return;
+
+  int_Base const read_base = kmer[pos];
+  for (int_Base base = 1; base <= 4; ++base) {
+    if (base == read_base) continue;
+    kmer[pos] = base;
+    seed_kmer_variants(kmer, pos + 1, num_mismatches + 1, error_positions,
+                       kmer_index, seeds);
+  }
+  kmer[pos] = read_base;
+}
+
+/** Drops search states with the most substitutions, down to `max_size` */
+static void apply_search_states_budget(MismatchSearchStates &search_states,
+                                       std::size_t const max_size) {
+  std::size_t size{0};
+  for (auto const &states : search_states) size += states.size();
+  for (auto num_mismatches = search_states.size() - 1;
+       num_mismatches > 0 && size > max_size; --num_mismatches) {
+    size -= search_states[num_mismatches].size();
+    search_states[num_mismatches].clear();
+  }
+}
+
+SearchStates gram::search_read_approximate(
+    Sequence const &read, uint32_t const &kmer_size,
+    KmerIndex const &kmer_index, PRG_Info const &prg_info,
+    uint32_t const &max_mismatches, std::size_t const &max_search_states) {
+  auto const error_positions =
+      likely_error_positions(kmer_size, read, kmer_index);
+  auto const kmer_offset = read.size() - kmer_size;
+
+  MismatchSearchStates search_states(max_mismatches + 1);
+  auto kmer = get_kmer_in_read(kmer_size, kmer_offset, read);
+  std::vector<bool> const kmer_error_positions(
+      error_positions.begin() + kmer_offset, error_positions.end());
+  seed_kmer_variants(kmer, 0, 0, kmer_error_positions, kmer_index,
+                     search_states);
+  apply_search_states_budget(search_states, max_search_states);
+
+  for (auto pos = kmer_offset; pos-- > 0;) {
+    int_Base const read_base = read[pos];
+    MismatchSearchStates new_search_states(max_mismatches + 1);
+    bool mapped{false};
+    for (uint32_t num_mismatches = 0; num_mismatches <= max_mismatches;
+         ++num_mismatches) {
+      auto &states = search_states[num_mismatches];
+      if (states.empty()) continue;
+      process_markers_search_states(states, prg_info);
+      new_search_states[num_mismatches].splice(
+          new_search_states[num_mismatches].end(),
+          search_base_backwards(read_base, states, prg_info));
+
+      if (num_mismatches < max_mismatches && error_positions[pos]) {
+        for (int_Base base = 1; base <= 4; ++base) {
+          if (base == read_base) continue;
+          new_search_states[num_mismatches + 1].splice(
+              new_search_states[num_mismatches + 1].end(),
+              search_base_backwards(base, states, prg_info));
+        }
+      }
+    }
+    search_states = std::move(new_search_states);
+    apply_search_states_budget(search_states, max_search_states);
+    for (auto const &states : search_states) mapped |= !states.empty();
+    if (!mapped) return SearchStates{};
+  }
+
+  for (auto &states : search_states) {
+    if (!states.empty())
+      return handle_allele_encapsulated_states(states, prg_info);
+  }
+  return SearchStates{};
+}
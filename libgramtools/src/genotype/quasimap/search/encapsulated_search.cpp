@@ -1,89 +1,71 @@
 #include "genotype/quasimap/search/encapsulated_search.hpp"
 
-/**
- * A caching object used to temporarily store a single search state
- * @see handle_allele_encapsulated_state()
- */
-class SearchStateCache {
- public:
-  SearchState search_state = {};
-  bool empty = true;
+#include <algorithm>
+#include <array>
 
-  void set(const SearchState &search_state) {
-    this->search_state = search_state;
-    this->empty = false;
-  }
-
-  void flush(SearchStates &search_states) {
-    if (this->empty) return;
-    search_states.emplace_back(this->search_state);
-    this->empty = true;
-  }
-
-  void update_sa_interval_max(const SA_Index &new_sa_interval_max) {
-    assert(not this->empty);
-    assert(this->search_state.sa_interval.second + 1 == new_sa_interval_max);
-    this->search_state.sa_interval.second = new_sa_interval_max;
-  }
-};
+/** Number of SA indices whose PRG positions are gathered at once */
+constexpr std::size_t ENCAPSULATED_SCAN_BLOCK{64};
 
 SearchStates gram::handle_allele_encapsulated_state(
     const SearchState &search_state, const PRG_Info &prg_info) {
   assert(not search_state.has_path());
+  assert(prg_info.pos_site_IDs.size() ==
+         prg_info.coverage_graph.random_access.size());
 
   SearchStates new_search_states = {};
-  SearchStateCache cache;
+  auto const first = search_state.sa_interval.first;
+  auto const last = search_state.sa_interval.second;
 
-  for (uint64_t sa_index = search_state.sa_interval.first;
-       sa_index <= search_state.sa_interval.second; ++sa_index) {
-    // Retrieve site and allele IDs
-    auto prg_index = prg_info.fm_index[sa_index];
-    auto cov_node = prg_info.coverage_graph.random_access[prg_index].node;
-    auto site_marker = cov_node->get_site_ID();
-    auto allele_id = cov_node->get_allele_ID();
+  // Mappings encapsulated in the same allele get merged into one search state,
+  // as long as they are consecutive in the SA (they need not be).
+  bool in_run = false;
+  Marker run_site_ID{0};
+  AlleleId run_allele_ID{0};
+  uint64_t run_start{0};
 
-    bool within_site = site_marker != 0;
-    if (not within_site) {
-      cache.flush(new_search_states);
-      cache.set(SearchState{
-          SA_Interval{sa_index, sa_index},
-          VariantSitePath{},
-          VariantSitePath{},
-      });
-      cache.flush(new_search_states);
-      continue;
-    }
+  std::array<uint64_t, ENCAPSULATED_SCAN_BLOCK> prg_indices;
+  for (uint64_t block_start = first; block_start <= last;
+       block_start += ENCAPSULATED_SCAN_BLOCK) {
+    auto const block_size =
+        std::min<uint64_t>(ENCAPSULATED_SCAN_BLOCK, last - block_start + 1);
+    // Suffix array accesses are done up front, apart from the branching below
+    for (uint64_t i{0}; i < block_size; ++i)
+      prg_indices[i] = prg_info.fm_index[block_start + i];
 
-    //  else: read is completely encapsulated within allele
-    if (cache.empty) {
-      cache.set(SearchState{
-          SA_Interval{sa_index, sa_index},
-          VariantSitePath{VariantLocus{site_marker, allele_id}},
-          VariantSitePath{},
-      });
-      continue;
-    }
+    for (uint64_t i{0}; i < block_size; ++i) {
+      auto const site_ID = prg_info.pos_site_IDs[prg_indices[i]];
+      auto const allele_ID = prg_info.pos_allele_IDs[prg_indices[i]];
+      if (in_run and site_ID == run_site_ID and allele_ID == run_allele_ID)
+        continue;
 
-    // cache is not empty: if the current SearchState goes through same site and
-    // allele, lengthen the SA interval of cached SearchState; saves space. Note
-    // that two encapsulated mapping do NOT have to be (lexicographic ordering)
-    // consecutive in the suffix array.
-    VariantSitePath current_path = {VariantLocus{site_marker, allele_id}};
-    bool cache_has_same_path =
-        current_path == cache.search_state.traversed_path;
-    if (cache_has_same_path) {
-      cache.update_sa_interval_max(sa_index);
-      continue;
-    } else {
-      cache.flush(new_search_states);
-      cache.set(SearchState{
-          SA_Interval{sa_index, sa_index},
-          current_path,
-          VariantSitePath{},
-      });
+      uint64_t const sa_index = block_start + i;
+      if (in_run)
+        new_search_states.emplace_back(SearchState{
+            SA_Interval{run_start, sa_index - 1},
+            VariantSitePath{VariantLocus{run_site_ID, run_allele_ID}},
+            VariantSitePath{},
+        });
+      in_run = site_ID != 0;
+      if (in_run) {
+        run_site_ID = site_ID;
+        run_allele_ID = allele_ID;
+        run_start = sa_index;
+      } else {
+        // Outside of variant sites, each SA index is a separate mapping
+        new_search_states.emplace_back(SearchState{
+            SA_Interval{sa_index, sa_index},
+            VariantSitePath{},
+            VariantSitePath{},
+        });
+      }
     }
   }
-  cache.flush(new_search_states);
+  if (in_run)
+    new_search_states.emplace_back(SearchState{
+        SA_Interval{run_start, last},
+        VariantSitePath{VariantLocus{run_site_ID, run_allele_ID}},
+        VariantSitePath{},
+    });
   return new_search_states;
 }
 
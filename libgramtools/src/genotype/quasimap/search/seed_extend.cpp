@@ -0,0 +1,181 @@
+#include "genotype/quasimap/search/seed_extend.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#include "common/utils.hpp"
+#include "genotype/quasimap/quasimap.hpp"
+
+using namespace gram;
+
+std::size_t gram::count_occurrences(SearchStates const &search_states) {
+  std::size_t result{0};
+  for (auto const &search_state : search_states)
+    result += search_state.sa_interval.second -
+              search_state.sa_interval.first + 1;
+  return result;
+}
+
+std::size_t gram::most_selective_kmer_offset(uint32_t const &kmer_size,
+                                             Sequence const &read,
+                                             KmerIndex const &kmer_index) {
+  auto best_offset = read.size() - kmer_size;
+  auto fewest_occurrences = count_occurrences(
+      kmer_index.at(get_kmer_in_read(kmer_size, best_offset, read)));
+  for (auto offset = best_offset; offset-- > 0;) {
+    auto const num_occurrences = count_occurrences(
+        kmer_index.at(get_kmer_in_read(kmer_size, offset, read)));
+    if (num_occurrences < fewest_occurrences) {
+      fewest_occurrences = num_occurrences;
+      best_offset = offset;
+    }
+  }
+  return best_offset;
+}
+
+/**
+ * Depth-first walk of the coverage graph matching a read, recording the sites
+ * whose start and end get crossed on the way.
+ */
+class ForwardMatcher {
+ public:
+  ForwardMatcher(Sequence const &read) : read(read) {}
+
+  void extend(covG_ptr const &node, std::size_t offset, std::size_t read_pos) {
+    if (node->has_sequence()) {
+      auto const &sequence = node->get_sequence();
+      for (; offset < sequence.size() && read_pos < read.size();
+           ++offset, ++read_pos) {
+        if (encode_dna_base(sequence[offset]) != read[read_pos]) return;
+      }
+      if (read_pos == read.size()) {
+        record_match();
+        return;
+      }
+    } else if (node->is_bubble_start()) {
+      // Edges out of a site's start are in allele order
+      auto const site_ID = node->get_site_ID();
+      AlleleId allele_ID{FIRST_ALLELE};
+      for (auto const &allele_start : node->get_edges()) {
+        entered_sites.push_back(VariantLocus{site_ID, allele_ID++});
+        extend(allele_start, 0, read_pos);
+        entered_sites.pop_back();
+      }
+      return;
+    } else if (node->is_bubble_end() && !was_entered(node->get_site_ID())) {
+      exited_sites.push_back(node->get_site_ID());
+      extend(node->get_edges().front(), 0, read_pos);
+      exited_sites.pop_back();
+      return;
+    }
+    for (auto const &next_node : node->get_edges())
+      extend(next_node, 0, read_pos);
+  }
+
+  std::vector<OccurrencePaths> matches;
+
+ private:
+  bool was_entered(Marker const site_ID) const {
+    return std::any_of(entered_sites.begin(), entered_sites.end(),
+                       [site_ID](VariantLocus const &locus) {
+                         return locus.first == site_ID;
+                       });
+  }
+
+  /** vBWT search meets sites from read end to start, so paths get reversed */
+  void record_match() {
+    OccurrencePaths paths;
+    paths.traversed_path.assign(entered_sites.rbegin(), entered_sites.rend());
+    for (auto it = exited_sites.rbegin(); it != exited_sites.rend(); ++it)
+      paths.traversing_path.push_back(VariantLocus{*it, ALLELE_UNKNOWN});
+    matches.push_back(std::move(paths));
+  }
+
+  Sequence const &read;
+  VariantSitePath entered_sites; /**< Sites whose start got crossed */
+  /** Sites whose end, but not start, got crossed */
+  std::vector<Marker> exited_sites;
+};
+
+std::vector<OccurrencePaths> gram::match_read_forward(
+    Sequence const &read, std::size_t const prg_pos,
+    PRG_Info const &prg_info) {
+  auto const &access_point = prg_info.coverage_graph.random_access[prg_pos];
+  ForwardMatcher matcher{read};
+  matcher.extend(access_point.node, access_point.offset, 0);
+  return std::move(matcher.matches);
+}
+
+/**
+ * Searches the read up to the end of its seed kmer, and gives the SA indices
+ * of the start of all occurrences found.
+ */
+static std::vector<SA_Index> search_seeded_prefix(Sequence const &read,
+                                                  std::size_t const seed_end,
+                                                  Sequence const &seed_kmer,
+                                                  KmerIndex const &kmer_index,
+                                                  PRG_Info const &prg_info) {
+  auto search_states = kmer_index.at(seed_kmer);
+  auto const prefix_start = read.rend() - (seed_end - seed_kmer.size());
+  for (auto it = prefix_start; it != read.rend(); ++it) {
+    search_states =
+        process_read_char_search_states(*it, search_states, prg_info);
+    if (search_states.empty()) break;
+  }
+
+  std::vector<SA_Index> sa_indices;
+  for (auto const &search_state : search_states) {
+    for (auto sa_index = search_state.sa_interval.first;
+         sa_index <= search_state.sa_interval.second; ++sa_index)
+      sa_indices.push_back(sa_index);
+  }
+  std::sort(sa_indices.begin(), sa_indices.end());
+  sa_indices.erase(std::unique(sa_indices.begin(), sa_indices.end()),
+                   sa_indices.end());
+  return sa_indices;
+}
+
+SearchStates gram::search_read_seed_extend(Sequence const &read,
+                                           uint32_t const &kmer_size,
+                                           KmerIndex const &kmer_index,
+                                           PRG_Info const &prg_info) {
+  auto const seed_offset =
+      most_selective_kmer_offset(kmer_size, read, kmer_index);
+  auto const seed_kmer = get_kmer_in_read(kmer_size, seed_offset, read);
+  if (seed_offset + kmer_size == read.size())
+    return search_read_backwards(read, seed_kmer, kmer_index, prg_info);
+
+  using Occurrence = std::tuple<VariantSitePath, VariantSitePath, SA_Index>;
+  std::vector<Occurrence> occurrences;
+  for (auto const sa_index : search_seeded_prefix(
+           read, seed_offset + kmer_size, seed_kmer, kmer_index, prg_info)) {
+    auto const prg_pos = prg_info.fm_index[sa_index];
+    for (auto &paths : match_read_forward(read, prg_pos, prg_info))
+      occurrences.emplace_back(std::move(paths.traversed_path),
+                               std::move(paths.traversing_path), sa_index);
+  }
+
+  // Occurrences with the same paths and consecutive in the SA form one
+  // `SearchState`, as they do in backward search
+  std::sort(occurrences.begin(), occurrences.end());
+  SearchStates search_states;
+  for (auto &occurrence : occurrences) {
+    auto &[traversed_path, traversing_path, sa_index] = occurrence;
+    if (!search_states.empty()) {
+      auto &last = search_states.back();
+      if (last.sa_interval.second + 1 == sa_index &&
+          last.traversed_path == traversed_path &&
+          last.traversing_path == traversing_path) {
+        last.sa_interval.second = sa_index;
+        continue;
+      }
+    }
+    search_states.emplace_back(SearchState{SA_Interval{sa_index, sa_index},
+                                           std::move(traversed_path),
+                                           std::move(traversing_path)});
+  }
+  search_states.sort([](SearchState const &lhs, SearchState const &rhs) {
+    return lhs.sa_interval < rhs.sa_interval;
+  });
+  return handle_allele_encapsulated_states(search_states, prg_info);
+}
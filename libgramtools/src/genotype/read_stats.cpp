@@ -2,17 +2,13 @@
 
 #include <math.h>
 
+#include <sstream>
+
 #include "genotype/infer/types.hpp"
 #include "prg/coverage_graph.hpp"
 
 using namespace gram;
 
-void gram::ReadStats::compute_base_error_rate(const std::string& reads_fpath) {
-  SeqRead reads(reads_fpath.c_str());
-  SeqRead::SeqIterator reads_it = reads.begin();
-  process_read_perbase_error_rates(reads_it);
-}
-
 void gram::ReadStats::compute_base_error_rate(GenomicRead_vector const& reads) {
   GenomicReadIterator reads_it(reads);
   process_read_perbase_error_rates(reads_it);
@@ -20,55 +16,102 @@ void gram::ReadStats::compute_base_error_rate(GenomicRead_vector const& reads) {
 
 void gram::ReadStats::process_read_perbase_error_rates(
     AbstractGenomicReadIterator& reads_it) {
-  // The number of reads (with at least one base with recorded quality) to
-  // estimate from. Is defined in the header file.
-  uint64_t required_reads = NUM_READS_USED;
-  uint64_t num_informative_reads = 0;
-
-  int64_t no_qual_reads = 0;
-  int64_t num_bases_processed = 0;
-  double mean_error = 0;
-
-  float running_qual_score = 0.0;
-
-  while (num_informative_reads < required_reads and reads_it.has_more_reads()) {
-    auto* const raw_read = *reads_it;
+  while (reads_it.has_more_reads()) {
+    record_read(**reads_it);
+    ++reads_it;
+  }
+  finalise_base_error_rate();
+}
 
-    // Test for max read length
-    std::string sequence = std::string(raw_read->seq);
-    auto sequence_length = sequence.length();
-    if (sequence_length > this->max_read_length)
-      this->max_read_length = sequence_length;
+void gram::ReadStats::record_read(GenomicRead const& read) {
+  if (read.seq.length() > this->max_read_length)
+    this->max_read_length = read.seq.length();
 
-    // Process quality scores
-    std::string qualities = std::string(raw_read->qual);
+  if (read.qual.empty()) {
+    ++num_no_qual_reads_recorded;
+    return;
+  }
 
-    if (qualities.length() ==
-        0) {  // We will keep looking for reads with quality scored bases.
-      no_qual_reads++;
-      ++reads_it;
-      continue;
-    }
+  uint64_t qual_sum = 0;
+  for (const auto base : read.qual)
+    qual_sum += base - 33;  // Assuming +33 Phred-scoring
 
-    for (const auto base : qualities) {
-      running_qual_score += (base - 33);  // Assuming +33 Phred-scoring
-      num_bases_processed++;
-    }
+  // Reservoir sampling: the n-th read replaces a sampled one with probability
+  // `NUM_READS_USED` / n
+  ++num_qual_reads_recorded;
+  if (quality_sample.size() < NUM_READS_USED) {
+    quality_sample.emplace_back(qual_sum, read.qual.length());
+    return;
+  }
+  std::uniform_int_distribution<uint64_t> distribution(
+      0, num_qual_reads_recorded - 1);
+  auto const replaced = distribution(sample_generator);
+  if (replaced < NUM_READS_USED)
+    quality_sample[replaced] = {qual_sum, read.qual.length()};
+}
 
-    num_informative_reads++;
-    ++reads_it;
+void gram::ReadStats::finalise_base_error_rate() {
+  uint64_t qual_sum = 0, num_bases = 0;
+  for (auto const& read_quality : quality_sample) {
+    qual_sum += read_quality.first;
+    num_bases += read_quality.second;
   }
 
-  if (num_bases_processed > 0) {
-    double mean_qual = running_qual_score / num_bases_processed;
+  double mean_error = 0;
+  if (num_bases > 0) {
+    double mean_qual = static_cast<double>(qual_sum) / num_bases;
     mean_error = pow(10, -mean_qual / 10);
   }
 
-  this->num_bases_processed = num_bases_processed;
-  this->no_qual_reads = no_qual_reads;
+  this->num_bases_processed = num_bases;
+  this->no_qual_reads = num_no_qual_reads_recorded;
   this->mean_pb_error = mean_error;
 }
 
+void gram::ReadStats::merge(ReadStats const& other) {
+  if (other.max_read_length > this->max_read_length)
+    this->max_read_length = other.max_read_length;
+  num_no_qual_reads_recorded += other.num_no_qual_reads_recorded;
+
+  // Each slot of the merged sample is drawn from either sample, with
+  // probability proportional to the number of reads it has left to stand for
+  auto samples =
+      std::make_pair(std::move(quality_sample), other.quality_sample);
+  auto num_reads =
+      std::make_pair(num_qual_reads_recorded, other.num_qual_reads_recorded);
+  quality_sample.clear();
+  num_qual_reads_recorded += other.num_qual_reads_recorded;
+  while (quality_sample.size() < NUM_READS_USED &&
+         !(samples.first.empty() && samples.second.empty())) {
+    bool from_first = samples.second.empty();
+    if (!from_first && !samples.first.empty()) {
+      std::uniform_int_distribution<uint64_t> distribution(
+          0, num_reads.first + num_reads.second - 1);
+      from_first = distribution(sample_generator) < num_reads.first;
+    }
+    auto& sample = from_first ? samples.first : samples.second;
+    --(from_first ? num_reads.first : num_reads.second);
+
+    std::uniform_int_distribution<std::size_t> distribution(0,
+                                                            sample.size() - 1);
+    auto const drawn = distribution(sample_generator);
+    quality_sample.push_back(sample[drawn]);
+    sample[drawn] = sample.back();
+    sample.pop_back();
+  }
+}
+
+std::string ReadStats::get_sampler_state() const {
+  std::stringstream state;
+  state << sample_generator;
+  return state.str();
+}
+
+void ReadStats::set_sampler_state(std::string const& state) {
+  std::stringstream stream{state};
+  stream >> sample_generator;
+}
+
 ReadStats::haplogroup_cov ReadStats::get_max_cov_haplogroup(
     GroupedAlleleCounts const& gped_cov) {
   std::map<AlleleId, CovCount> counts;
@@ -117,7 +160,8 @@ ReadStats::allele_and_cov ReadStats::extract_max_coverage_allele(
 }
 
 void gram::AbstractReadStats::compute_coverage_depth(
-    Coverage const& coverage, coverage_Graph const& cov_graph) {
+    Coverage const& coverage, coverage_Graph const& cov_graph,
+    genotype::infer::SiteSelection const& selection) {
   ReadStats::allele_and_cov site_extraction;
   double site_perbase_coverage = 0, total_coverage = 0;
   int64_t num_sites_noCov = 0;
@@ -130,6 +174,8 @@ void gram::AbstractReadStats::compute_coverage_depth(
 
     // If the site is nested within another, we do not process its coverage
     if (cov_graph.par_map.find(site_ID) != cov_graph.par_map.end()) continue;
+    // Reads are only mapped to selected sites, so the others have no coverage
+    if (!selection.empty() && !selection.at(siteID_to_index(site_ID))) continue;
     site_extraction = extract_max_coverage_allele(
         coverage.grouped_allele_counts, node_pair.first, node_pair.second);
 
@@ -0,0 +1,202 @@
+#include "genotype/regions.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+#include "prg/coverage_graph.hpp"
+
+using namespace gram;
+using namespace gram::genotype;
+
+using interval = std::pair<std::size_t, std::size_t>;
+
+Regions gram::genotype::load_bed(std::istream& bed_file) {
+  Regions result;
+  std::string line;
+  while (std::getline(bed_file, line)) {
+    if (line.empty() || line[0] == '#' || line.rfind("track", 0) == 0 ||
+        line.rfind("browser", 0) == 0)
+      continue;
+    std::istringstream fields(line);
+    Region region;
+    if (!(fields >> region.chrom >> region.start >> region.end) ||
+        region.start > region.end)
+      throw RegionsException("Invalid BED line: " + line);
+    result.push_back(region);
+  }
+  return result;
+}
+
+/**
+ * Converts regions to sorted, non-overlapping intervals over the
+ * concatenation of all segments.
+ */
+static std::vector<interval> to_global_intervals(
+    Regions const& regions, SegmentTracker const& tracker) {
+  std::unordered_map<std::string, interval> segment_spans;
+  std::size_t offset{0};
+  for (auto const& segment : tracker.get_segments()) {
+    segment_spans.insert({segment.ID, interval{offset, segment.size}});
+    offset += segment.size;
+  }
+
+  std::vector<interval> intervals;
+  for (auto const& region : regions) {
+    auto const found = segment_spans.find(region.chrom);
+    if (found == segment_spans.end())
+      throw RegionsException("Region on unknown sequence " + region.chrom);
+    auto const [segment_start, segment_size] = found->second;
+    auto const end = std::min(region.end, segment_size);
+    if (region.start < end)
+      intervals.emplace_back(segment_start + region.start, segment_start + end);
+  }
+
+  std::sort(intervals.begin(), intervals.end());
+  std::vector<interval> merged;
+  for (auto const& i : intervals) {
+    if (!merged.empty() && i.first <= merged.back().second)
+      merged.back().second = std::max(merged.back().second, i.second);
+    else
+      merged.push_back(i);
+  }
+  return merged;
+}
+
+static bool overlaps(std::vector<interval> const& intervals,
+                     interval const& query) {
+  // First interval starting at or after the query's end
+  auto it = std::lower_bound(
+      intervals.begin(), intervals.end(), query.second,
+      [](interval const& i, std::size_t const pos) { return i.first < pos; });
+  if (it == intervals.begin()) return false;
+  return std::prev(it)->second > query.first;
+}
+
+infer::SiteSelection gram::genotype::select_sites(
+    coverage_Graph const& cov_graph, Regions const& regions,
+    SegmentTracker const& tracker) {
+  auto const intervals = to_global_intervals(regions, tracker);
+  auto const& par_map = cov_graph.par_map;
+  infer::SiteSelection result(cov_graph.bubble_map.size(), false);
+
+  for (auto const& bubble : cov_graph.bubble_map) {
+    auto const site_ID = bubble.first->get_site_ID();
+    if (par_map.find(site_ID) != par_map.end()) continue;
+    auto const start = bubble.first->get_pos();
+    // A site whose REF allele is empty still occupies its start position
+    auto const end = std::max(bubble.second->get_pos(), start + 1);
+    result.at(siteID_to_index(site_ID)) = overlaps(intervals, {start, end});
+  }
+
+  for (auto const& entry : par_map) {
+    auto lvl1_site_ID = entry.second.first;
+    while (par_map.find(lvl1_site_ID) != par_map.end())
+      lvl1_site_ID = par_map.at(lvl1_site_ID).first;
+    result.at(siteID_to_index(entry.first)) =
+        result.at(siteID_to_index(lvl1_site_ID));
+  }
+  return result;
+}
+
+/**
+ * Flags the PRG positions from which a kmer runs into a selected site: those
+ * of the site, and the `kmer_size - 1` positions preceding it.
+ */
+static std::vector<bool> get_region_positions(
+    PRG_Info const& prg_info, infer::SiteSelection const& selection,
+    uint32_t const kmer_size) {
+  auto const& cov_graph = prg_info.coverage_graph;
+  auto const& random_access = cov_graph.random_access;
+  std::vector<bool> result(random_access.size(), false);
+
+  covG_ptr site_end{nullptr};
+  std::size_t site_start{0};
+  for (std::size_t pos{0}; pos < random_access.size(); ++pos) {
+    auto const& node = random_access[pos].node;
+    if (site_end == nullptr) {
+      // The site entry marker maps to the bubble start
+      if (node->is_bubble_start() &&
+          cov_graph.par_map.find(node->get_site_ID()) ==
+              cov_graph.par_map.end()) {
+        site_end = cov_graph.bubble_map.at(node);
+        site_start = pos;
+      }
+    } else if (node == site_end) {
+      if (selection.at(siteID_to_index(node->get_site_ID()))) {
+        auto const from = site_start - std::min<std::size_t>(
+                                           site_start, kmer_size - 1);
+        std::fill(result.begin() + from, result.begin() + pos + 1, true);
+      }
+      site_end = nullptr;
+    }
+  }
+  return result;
+}
+
+static bool path_is_selected(VariantSitePath const& path,
+                             infer::SiteSelection const& selection) {
+  for (auto const& locus : path)
+    if (selection.at(siteID_to_index(locus.first))) return true;
+  return false;
+}
+
+KmerSet gram::genotype::get_region_kmers(KmerIndex const& kmer_index,
+                                         PRG_Info const& prg_info,
+                                         infer::SiteSelection const& selection,
+                                         uint32_t const kmer_size) {
+  auto const region_positions =
+      get_region_positions(prg_info, selection, kmer_size);
+
+  std::vector<KmerIndex::const_iterator> entries;
+  entries.reserve(kmer_index.size());
+  for (auto it = kmer_index.begin(); it != kmer_index.end(); ++it)
+    entries.push_back(it);
+
+  std::vector<char> hits(entries.size(), 0);
+#pragma omp parallel for
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    for (auto const& search_state : entries[i]->second) {
+      if (path_is_selected(search_state.traversed_path, selection) ||
+          path_is_selected(search_state.traversing_path, selection)) {
+        hits[i] = 1;
+        break;
+      }
+      auto const& sa_interval = search_state.sa_interval;
+      for (auto sa_index = sa_interval.first;
+           sa_index <= sa_interval.second && !hits[i]; ++sa_index)
+        hits[i] = region_positions[prg_info.fm_index[sa_index]];
+      if (hits[i]) break;
+    }
+  }
+
+  KmerSet result;
+  for (std::size_t i{0}; i < entries.size(); ++i)
+    if (hits[i]) result.insert(entries[i]->first);
+  return result;
+}
+
+RegionSelection gram::genotype::select_regions(Regions const& regions,
+                                               SegmentTracker const& tracker,
+                                               KmerIndex const& kmer_index,
+                                               PRG_Info const& prg_info,
+                                               uint32_t const kmer_size) {
+  RegionSelection result;
+  result.sites = select_sites(prg_info.coverage_graph, regions, tracker);
+  result.kmers =
+      get_region_kmers(kmer_index, prg_info, result.sites, kmer_size);
+  return result;
+}
+
+bool gram::genotype::read_hits_kmers(Sequence const& read,
+                                     uint32_t const kmer_size,
+                                     KmerSet const& kmers) {
+  if (read.size() < kmer_size) return false;
+  Sequence kmer(kmer_size);
+  for (std::size_t offset{0}; offset + kmer_size <= read.size(); ++offset) {
+    std::copy(read.begin() + offset, read.begin() + offset + kmer_size,
+              kmer.begin());
+    if (kmers.find(kmer) != kmers.end()) return true;
+  }
+  return false;
+}
@@ -5,16 +5,18 @@ coverage_Node::coverage_Node()
     : sequence(""),
       site_ID(0),
       allele_ID(ALLELE_UNKNOWN),
-      coverage(),
       pos(0),
+      cov_offset(0),
+      cov_ID(no_cov_ID),
       is_site_boundary{false} {};
 
 coverage_Node::coverage_Node(std::size_t pos)
     : sequence(""),
       site_ID(0),
       allele_ID(ALLELE_UNKNOWN),
-      coverage(),
       pos(pos),
+      cov_offset(0),
+      cov_ID(no_cov_ID),
       is_site_boundary{false} {}
 
 coverage_Node::coverage_Node(std::string const seq, int const pos,
@@ -23,17 +25,36 @@ coverage_Node::coverage_Node(std::string const seq, int const pos,
       pos(pos),
       site_ID(site_ID),
       allele_ID(allele_ID),
-      is_site_boundary(false) {
-  // No need to allocate coverage if outside a variant site, as only variant
-  // site coverage is used for genotyping
-  if (is_in_bubble()) this->coverage = PerBaseCoverage(seq.size(), 0);
-}
+      cov_offset(0),
+      cov_ID(no_cov_ID),
+      is_site_boundary(false) {}
 
 void coverage_Node::add_sequence(std::string const& new_seq) {
+  assert(cov_store == nullptr);  // Coverage is laid out once sequence is final
   sequence += new_seq;
-  if (is_in_bubble()) {
-    for (std::size_t i = 0; i < new_seq.size(); ++i) coverage.emplace_back(0);
-  }
+}
+
+PerBaseCoverage coverage_Node::get_coverage() const {
+  if (cov_store == nullptr) return PerBaseCoverage(get_coverage_space(), 0);
+  return cov_store->get_range(cov_offset, sequence.size());
+}
+
+void coverage_Node::set_coverage(PerBaseCoverage const& new_cov) {
+  assert(new_cov.size() == get_coverage_space() &&
+         new_cov.size() == sequence.size());
+  if (cov_store == nullptr) attach_coverage(boost::make_shared<PbCovStore>());
+  for (std::size_t i{0}; i < new_cov.size(); ++i)
+    cov_store->set(cov_offset + i, new_cov[i]);
+}
+
+void coverage_Node::attach_coverage(
+    boost::shared_ptr<PbCovStore> const& store) {
+  // No need to allocate coverage if outside a variant site, as only variant
+  // site coverage is used for genotyping
+  if (cov_store != nullptr || !is_in_bubble() || !has_sequence()) return;
+  cov_store = store;
+  cov_ID = store->num_allocations();
+  cov_offset = store->allocate(sequence.size());
 }
 
 /**
@@ -58,6 +79,7 @@ coverage_Graph::coverage_Graph(PRG_String const& vec_in) {
   par_map = std::move(built_graph.par_map);
   random_access = std::move(built_graph.random_access);
   target_map = std::move(built_graph.target_map);
+  pb_cov_store = std::move(built_graph.pb_cov_store);
 
   par_map.empty() ? is_nested = false : is_nested = true;
 }
@@ -92,6 +114,13 @@ cov_Graph_Builder::cov_Graph_Builder(PRG_String const& prg_string) {
   }
   make_sink();
   map_targets();
+  allocate_coverage();
+}
+
+void cov_Graph_Builder::allocate_coverage() {
+  pb_cov_store = boost::make_shared<PbCovStore>();
+  for (auto const& access : random_access)
+    access.node->attach_coverage(pb_cov_store);
 }
 
 void cov_Graph_Builder::make_root() {
@@ -402,7 +431,8 @@ bool operator==(coverage_Node const& f, coverage_Node const& s) {
 bool compare_nodes(coverage_Node const& f, coverage_Node const& s) {
   return (f.sequence == s.sequence && f.pos == s.pos &&
           f.site_ID == s.site_ID && f.allele_ID == s.allele_ID &&
-          f.coverage == s.coverage && f.is_site_boundary == s.is_site_boundary);
+          f.get_coverage() == s.get_coverage() &&
+          f.is_site_boundary == s.is_site_boundary);
 }
 
 std::ostream& operator<<(std::ostream& out, coverage_Node const& node) {
@@ -411,7 +441,7 @@ std::ostream& operator<<(std::ostream& out, coverage_Node const& node) {
   out << "Site ID: " << node.site_ID << std::endl;
   out << "Allele ID: " << node.allele_ID << std::endl;
   out << "Cov: ";
-  for (auto& s : node.coverage) std::cout << s << " ";
+  for (auto const& s : node.get_coverage()) std::cout << s << " ";
   std::cout << std::endl;
   out << "Is a site boundary: " << node.is_site_boundary << std::endl;
   return out;
@@ -1,39 +1,75 @@
 #include "prg/linearised_prg.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
 #include "common/parameters.hpp"
 #include "common/utils.hpp"
 
+/** Number of PRG string elements scanned for variant markers at a time */
+#define PRG_SCAN_CHUNK_SIZE (1 << 20)
+
+static_assert(sizeof(Marker) == gram::num_bytes_per_integer,
+              "PRG string files hold one Marker per integer");
+
+/**
+ * Memory-maps `file_in` and copies its integers out in one go, byte swapping
+ * them if they are not in the host's byte order. The swap loop is simple enough
+ * for compilers to vectorise.
+ */
+static marker_vec load_markers(std::string const &file_in, endianness en) {
+  int const fd = open(file_in.c_str(), O_RDONLY);
+  if (fd < 0) throw std::ios::failure("PRG String file not found");
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::ios::failure("Cannot read PRG String file: " + file_in);
+  }
+  auto const num_bytes = static_cast<std::size_t>(file_stat.st_size);
+  if (num_bytes % gram::num_bytes_per_integer != 0) {
+    close(fd);
+    throw std::runtime_error("PRG String file " + file_in +
+                             " does not hold a whole number of integers");
+  }
+
+  marker_vec markers(num_bytes / gram::num_bytes_per_integer);
+  if (num_bytes > 0) {
+    void *const mapped =
+        mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      close(fd);
+      throw std::ios::failure("Cannot map PRG String file: " + file_in);
+    }
+    madvise(mapped, num_bytes, MADV_SEQUENTIAL);
+    std::memcpy(markers.data(), mapped, num_bytes);
+    munmap(mapped, num_bytes);
+  }
+  close(fd);
+
+  bool const host_is_big_endian = __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+  if ((en == endianness::big) != host_is_big_endian) {
+    for (auto &marker : markers) marker = __builtin_bswap32(marker);
+  }
+
+  if (std::find(markers.begin(), markers.end(), 0) != markers.end())
+    throw std::runtime_error("PRG consistency error: null integer in " +
+                             file_in);
+  return markers;
+}
+
 /**********************
  * Supporting nesting**
  **********************/
 PRG_String::PRG_String(std::string const &file_in, endianness en)
-    : odd_site_end_found(false), en(en) {
-  std::fstream input(file_in, std::ios::in | std::ios::binary);
-  if (!input)
-    throw std::ios::failure("PRG String file not found");
-  else {
-    uint32_t c{0};
-    uint8_t buffer[gram::num_bytes_per_integer];  // Note, use uint8_t and not
-                                                  // char which is signed
-    size_t byte_pos;
-    while (true) {
-      input.read((char *)&buffer,
-                 gram::num_bytes_per_integer);  // Read byte by byte
-      if (input.eof()) break;
-
-      if (en == endianness::big) {
-        c = (uint32_t)buffer[0] << 24 | (uint32_t)buffer[1] << 16 |
-            (uint32_t)buffer[2] << 8 | (uint32_t)buffer[3];
-      } else {
-        c = (uint32_t)buffer[0] | (uint32_t)buffer[1] << 8 |
-            (uint32_t)buffer[2] << 16 | (uint32_t)buffer[3] << 24;
-      }
-
-      if (input.eof()) break;
-      assert(c >= 1);
-      my_PRG_string.push_back(c);
-      c = 0;
-    }
-  };
+    : odd_site_end_found(false),
+      en(en),
+      my_PRG_string(load_markers(file_in, en)) {
   output_file = file_in;
   map_ends_and_check_for_duplicates();
 
@@ -50,32 +86,38 @@ PRG_String::PRG_String(marker_vec const &v_in) {
 };
 
 void PRG_String::map_ends_and_check_for_duplicates() {
-  int pos = 0;
-  std::size_t v_size = my_PRG_string.size();  // Converts to signed
-  Marker marker;
-  std::set<Marker> seen_sites;
-
-  while (pos < v_size) {
-    marker = my_PRG_string[pos];
-    if (marker <= 4) {
-      ++pos;
-      continue;
+  // Variant markers are few compared to nucleotides: find them in parallel,
+  // then process them in PRG string order.
+  std::size_t const v_size = my_PRG_string.size();
+  std::size_t const num_chunks =
+      (v_size + PRG_SCAN_CHUNK_SIZE - 1) / PRG_SCAN_CHUNK_SIZE;
+  std::vector<std::vector<int>> chunk_marker_positions(num_chunks);
+
+#pragma omp parallel for schedule(static)
+  for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    auto const chunk_end = std::min(v_size, (chunk + 1) * PRG_SCAN_CHUNK_SIZE);
+    for (auto pos = chunk * PRG_SCAN_CHUNK_SIZE; pos < chunk_end; ++pos) {
+      if (my_PRG_string[pos] > 4) chunk_marker_positions[chunk].push_back(pos);
     }
-    if (is_site_marker(marker)) {
-      bool seen_before = seen_sites.find(marker) != seen_sites.end();
-      if (seen_before) {
-        // Duplicate site marker
-        throw std::runtime_error(
-            "PRG consistency error:"
-            " site marker " +
-            std::to_string(marker) + " used for two different sites");
+  }
+
+  std::unordered_set<Marker> seen_sites;
+  for (auto const &marker_positions : chunk_marker_positions) {
+    for (auto const pos : marker_positions) {
+      auto const marker = my_PRG_string[pos];
+      if (is_site_marker(marker)) {
+        bool const seen_before = !seen_sites.insert(marker).second;
+        if (seen_before) {
+          // Duplicate site marker
+          throw std::runtime_error(
+              "PRG consistency error:"
+              " site marker " +
+              std::to_string(marker) + " used for two different sites");
+        }
       } else
-        seen_sites.insert(marker);
-    } else {
-      end_positions[marker] =
-          pos;  // Inserts if does not exist, updates otherwise
+        end_positions[marker] =
+            pos;  // Inserts if does not exist, updates otherwise
     }
-    ++pos;
   }
 }
 
@@ -50,6 +50,22 @@ coverage_Graph gram::generate_cov_graph(CommonParameters const &parameters,
   return c_g;
 }
 
+void gram::dump_site_ends(CommonParameters const &parameters,
+                          std::unordered_map<Marker, int> const &site_ends) {
+  std::ofstream ofs{parameters.site_ends_fpath};
+  boost::archive::binary_oarchive oa{ofs};
+  oa << site_ends;
+}
+
+std::unordered_map<Marker, int> gram::load_site_ends(
+    CommonParameters const &parameters) {
+  std::unordered_map<Marker, int> site_ends;
+  std::ifstream ifs{parameters.site_ends_fpath};
+  boost::archive::binary_iarchive ia{ifs};
+  ia >> site_ends;
+  return site_ends;
+}
+
 child_map gram::build_child_map(parental_map const &par_map) {
   child_map result;
 
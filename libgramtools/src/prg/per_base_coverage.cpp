@@ -0,0 +1,85 @@
+#include "prg/per_base_coverage.hpp"
+
+#include <algorithm>
+
+using namespace gram;
+
+static constexpr auto max_counter = std::numeric_limits<PbCovCounter>::max();
+
+std::size_t PbCovStore::allocate(std::size_t const num_bases) {
+  auto const start = counters.size();
+  counters.resize(start + num_bases, 0);
+  ++allocations;
+  return start;
+}
+
+void PbCovStore::increment(std::size_t const index) {
+  // Compare-and-swap, so that concurrent increments never take a counter past
+  // its maximum (GCC/Clang builtins, as std::atomic_ref needs C++20)
+  auto* const counter = &counters[index];
+  auto cur = __atomic_load_n(counter, __ATOMIC_RELAXED);
+  while (cur < max_counter) {
+    if (__atomic_compare_exchange_n(counter, &cur,
+                                    static_cast<PbCovCounter>(cur + 1), true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      return;
+  }
+
+  auto& shard = get_overflow_shard(index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto& overflow = shard.counters[index];
+  if (overflow < std::numeric_limits<OverflowCounter>::max()) ++overflow;
+}
+
+CovCount PbCovStore::get(std::size_t const index) const {
+  auto const counter = __atomic_load_n(&counters[index], __ATOMIC_RELAXED);
+  if (counter < max_counter) return counter;
+
+  uint64_t total{counter};
+  {
+    auto const& shard = get_overflow_shard(index);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto const found = shard.counters.find(index);
+    if (found != shard.counters.end()) total += found->second;
+  }
+  return static_cast<CovCount>(std::min<uint64_t>(
+      total, std::numeric_limits<CovCount>::max()));
+}
+
+PerBaseCoverage PbCovStore::get_range(std::size_t const start,
+                                      std::size_t const num_bases) const {
+  PerBaseCoverage result(num_bases);
+  for (std::size_t i{0}; i < num_bases; ++i) result[i] = get(start + i);
+  return result;
+}
+
+void PbCovStore::set(std::size_t const index, CovCount const value) {
+  auto& shard = get_overflow_shard(index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (value < max_counter) {
+    counters[index] = static_cast<PbCovCounter>(value);
+    shard.counters.erase(index);
+  } else {
+    counters[index] = max_counter;
+    shard.counters[index] = static_cast<OverflowCounter>(std::min<uint64_t>(
+        value - max_counter, std::numeric_limits<OverflowCounter>::max()));
+  }
+}
+
+std::size_t PbCovStore::num_overflow_counters() const {
+  std::size_t total{0};
+  for (auto const& shard : overflow_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.counters.size();
+  }
+  return total;
+}
+
+std::size_t PbCovStore::memory_usage() const {
+  // Approximates each hash table entry as a node holding the key, value and a
+  // next pointer, plus one bucket pointer
+  constexpr std::size_t overflow_entry_size =
+      sizeof(std::size_t) + sizeof(OverflowCounter) + 2 * sizeof(void*);
+  return counters.capacity() * sizeof(PbCovCounter) +
+         num_overflow_counters() * overflow_entry_size;
+}
@@ -1,4 +1,7 @@
 #include "prg/prg_info.hpp"
+
+#include <algorithm>
+
 #include "build/kmer_index/masks.hpp"
 
 using namespace gram;
@@ -6,14 +9,20 @@ using namespace gram;
 PRG_Info gram::load_prg_info(CommonParameters const &parameters) {
   PRG_Info prg_info;
 
-  PRG_String ps{parameters.encoded_prg_fpath};
-  prg_info.last_allele_positions = ps.get_end_positions();
+  // Directories built before site ends got serialised only have the prg
+  if (fs::exists(parameters.site_ends_fpath))
+    prg_info.last_allele_positions = load_site_ends(parameters);
+  else {
+    PRG_String ps{parameters.encoded_prg_fpath};
+    prg_info.last_allele_positions = ps.get_end_positions();
+  }
 
   // Load coverage graph
   std::ifstream ifs{parameters.cov_graph_fpath};
   boost::archive::binary_iarchive ia{ifs};
   ia >> prg_info.coverage_graph;
   prg_info.num_variant_sites = prg_info.coverage_graph.bubble_map.size();
+  index_site_allele_IDs(prg_info);
 
   prg_info.fm_index = load_fm_index(parameters);
 
@@ -27,3 +36,31 @@ PRG_Info gram::load_prg_info(CommonParameters const &parameters) {
 
   return prg_info;
 }
+
+void gram::index_site_allele_IDs(PRG_Info &prg_info) {
+  auto const &random_access = prg_info.coverage_graph.random_access;
+  prg_info.pos_site_IDs.resize(random_access.size());
+  prg_info.pos_allele_IDs.resize(random_access.size());
+  for (std::size_t pos{0}; pos < random_access.size(); ++pos) {
+    auto const &node = random_access[pos].node;
+    prg_info.pos_site_IDs[pos] = node->get_site_ID();
+    prg_info.pos_allele_IDs[pos] = node->get_allele_ID();
+  }
+}
+
+uint64_t gram::site_ends_hash(PRG_Info const &prg_info) {
+  std::vector<std::pair<Marker, int>> site_ends(
+      prg_info.last_allele_positions.begin(),
+      prg_info.last_allele_positions.end());
+  std::sort(site_ends.begin(), site_ends.end());
+  // FNV-1a, over the site markers and end positions
+  uint64_t hash{14695981039346656037ULL};
+  for (auto const &site_end : site_ends) {
+    for (uint64_t const value : {uint64_t(site_end.first),
+                                 uint64_t(site_end.second)}) {
+      hash ^= value;
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
@@ -7,6 +7,7 @@ SimulateParams commands::simulate::parse_parameters(
     po::variables_map &vm, const po::parsed_options &parsed) {
   SimulateParams parameters;
   std::string output_dir_fpath;
+  SeedSize seed;
 
   po::options_description simulate_description("simulate options");
   simulate_description.add_options()(
@@ -19,7 +20,10 @@ SimulateParams commands::simulate::parse_parameters(
       "o", po::value<std::string>(&output_dir_fpath)->required(),
       "directory containing outputs")(
       "i", po::value<std::string>(&parameters.input_sequences_fpath),
-      "input sequences to induce genotypes on");
+      "input sequences to induce genotypes on")(
+      "seed", po::value<SeedSize>(&seed),
+      "seed for the random paths. a random seed is generated if this option "
+      "is not used.");
 
   std::vector<std::string> opts =
       po::collect_unrecognized(parsed.options, po::include_positional);
@@ -35,6 +39,7 @@ SimulateParams commands::simulate::parse_parameters(
     exit(1);
   }
 
+  if (vm.count("seed")) parameters.seed = seed;
   parameters.json_out_fpath =
       full_path(output_dir_fpath, parameters.sample_id + std::string(".json"));
   parameters.fasta_out_fpath =
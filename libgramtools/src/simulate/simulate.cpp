@@ -16,7 +16,8 @@ using namespace gram::simulate;
 
 namespace gram::simulate {
 
-SimulationGenotyper::SimulationGenotyper(coverage_Graph const& cov_graph) {
+SimulationGenotyper::SimulationGenotyper(coverage_Graph const& cov_graph,
+                                         RandomGenerator* const rand) {
   this->cov_graph = &cov_graph;
   child_m = build_child_map(
       cov_graph.par_map);  // Required for site invalidation & json output
@@ -31,9 +32,8 @@ SimulationGenotyper::SimulationGenotyper(coverage_Graph const& cov_graph) {
 
     auto extracter = AlleleExtracter(bubble_pair.first, bubble_pair.second,
                                      genotyped_records);
-    RandomInclusiveInt rand(std::nullopt);
     auto genotyped_site =
-        make_randomly_genotyped_site(&rand, extracter.get_alleles());
+        make_randomly_genotyped_site(rand, extracter.get_alleles());
     genotyped_site->set_pos(bubble_pair.first->get_pos());
     genotyped_site->set_site_end_node(bubble_pair.second);
 
@@ -108,10 +108,12 @@ void simulate_paths(json_prg_ptr& simu_json, coverage_Graph const& cov_graph,
   std::stringstream coords_file{""};
   SegmentTracker tracker(coords_file);
 
+  // Shared by all paths, so that a given seed always gives the same paths
+  RandomInclusiveInt rand(parameters.seed);
   uint64_t num_runs{0}, num_sampled{0};
   while (num_runs < parameters.max_num_paths) {
     num_runs++;
-    auto gtyper = std::make_shared<SimulationGenotyper>(cov_graph);
+    auto gtyper = std::make_shared<SimulationGenotyper>(cov_graph, &rand);
     auto genotyped_records = gtyper->get_genotyped_records();
     auto new_p_ref =
         get_personalised_ref(cov_graph.root, genotyped_records, tracker).at(0);
@@ -1,28 +1,33 @@
 /**
  * @file Combine JSON genotyped files into one
  */
+#include <omp.h>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 
-#include <nlohmann/json.hpp>
-
-#include "genotype/infer/output_specs/json_prg_spec.hpp"
+#include "genotype/infer/output_specs/json_combine.hpp"
 
 namespace fs = std::filesystem;
-using JSON = nlohmann::json;
 using namespace gram::json;
 
 void usage(const char* argv[]) {
-  std::cout << "Usage: " << argv[0] << " fofn fout" << std::endl;
+  std::cout << "Usage: " << argv[0]
+            << " fofn fout [num_threads] [max_inputs_per_merge]" << std::endl;
   std::cout << "\t fofn: file of file names of the JSON files to combine"
             << std::endl;
   std::cout << "\t fout: name of output combined JSON file" << std::endl;
+  std::cout << "\t num_threads: number of threads to combine with (default: 1)"
+            << std::endl;
+  std::cout << "\t max_inputs_per_merge: above this many JSON files, combine "
+               "them in groups of this size, hierarchically (default: no "
+               "limit)"
+            << std::endl;
   exit(1);
 }
 
 int main(int argc, const char* argv[]) {
-  if (argc != 3) usage(argv);
+  if (argc < 3 || argc > 5) usage(argv);
   fs::path fofn(argv[1]);
   if (!fs::exists(fofn)) {
     std::cout << fofn << " not found.";
@@ -32,34 +37,25 @@ int main(int argc, const char* argv[]) {
     usage(argv);
   }
 
-  std::ofstream fout(argv[2]);
-  if (!fout.good()) {
-    std::cout << "Error: could not open " << argv[2] << std::endl;
+  combine_params params;
+  try {
+    omp_set_num_threads(argc > 3 ? std::stoi(argv[3]) : 1);
+    if (argc > 4) params.max_inputs_per_merge = std::stoul(argv[4]);
+  } catch (std::logic_error const&) {
     usage(argv);
   }
 
   std::ifstream fin(fofn);
+  strings fpaths;
   std::string next_file;
-  JSON next_json;
-  Json_Prg combined_json;
-  bool first{true};
   while (std::getline(fin, next_file)) {
-    std::ifstream next_istream(next_file);
-    if (!next_istream.good()) {
-      std::cout << "Error: Could not open JSON file " << next_file << std::endl;
-      exit(1);
-    }
-    next_json.clear();
-    next_istream >> next_json;
-    if (first) {
-      combined_json.set_prg(next_json);
-      first = false;
-    }
+    if (!next_file.empty()) fpaths.push_back(next_file);
+  }
 
-    else {
-      Json_Prg next_prg(next_json);
-      combined_json.combine_with(next_prg);
-    }
+  try {
+    combine_json_files(fpaths, argv[2], params);
+  } catch (std::exception const& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    exit(1);
   }
-  fout << combined_json.get_prg();
 }
@@ -0,0 +1,50 @@
+/**
+ * @file Convert a binary coverage file to the legacy JSON coverage files
+ */
+#include <filesystem>
+#include <iostream>
+
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "genotype/quasimap/coverage/coverage_file.hpp"
+#include "genotype/quasimap/coverage/grouped_allele_counts.hpp"
+
+namespace fs = std::filesystem;
+using namespace gram;
+
+void usage(const char* argv[]) {
+  std::cout << "Usage: " << argv[0] << " coverage_file output_dir"
+            << std::endl;
+  std::cout << "\t coverage_file: coverage.bin or coverage.bin.gz, as written "
+               "by gramtools genotype"
+            << std::endl;
+  std::cout << "\t output_dir: where to write allele_base_coverage.json and "
+               "grouped_allele_counts_coverage.json"
+            << std::endl;
+  exit(1);
+}
+
+int main(int argc, const char* argv[]) {
+  if (argc != 3) usage(argv);
+  fs::path coverage_fpath(argv[1]);
+  if (!fs::exists(coverage_fpath)) {
+    std::cout << coverage_fpath << " not found.";
+    usage(argv);
+  }
+  fs::path output_dir(argv[2]);
+
+  GenotypeParams parameters;
+  parameters.allele_base_coverage_fpath =
+      (output_dir / "allele_base_coverage.json").string();
+  parameters.grouped_allele_counts_fpath =
+      (output_dir / "grouped_allele_counts_coverage.json").string();
+
+  try {
+    fs::create_directories(output_dir);
+    auto const coverage = coverage::file::load(coverage_fpath.string());
+    coverage::dump::allele_base(coverage, parameters);
+    coverage::dump::grouped_allele_counts(coverage, parameters);
+  } catch (std::exception const& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    exit(1);
+  }
+}
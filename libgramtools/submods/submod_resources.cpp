@@ -36,6 +36,7 @@ PRG_Info gram::submods::generate_prg_info(const marker_vec& prg_raw) {
   // NB: the move is crucial here, otherwise the initialised cov_Graph's
   // destructor affects the assigned-to cov_Graph
   prg_info.coverage_graph = std::move(coverage_Graph{ps});
+  index_site_allele_IDs(prg_info);
   prg_info.last_allele_positions = ps.get_end_positions();
   prg_info.sites_mask = generate_sites_mask(encoded_prg);
   prg_info.allele_mask = generate_allele_mask(encoded_prg);
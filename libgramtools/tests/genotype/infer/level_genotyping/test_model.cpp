@@ -497,8 +497,38 @@ TEST(TestLevelGenotyperModel_FourAlleles,
   data.ploidy = Ploidy::Diploid;
   auto diploid_genotyped = LevelGenotyperModel(data);
   // Expected number of genotypes: 4 diploid homozygous + (4 choose 2) diploid
-  // heterozygous
-  EXPECT_EQ(diploid_genotyped.get_likelihoods().size(), 10);
+  // heterozygous, some of which do not get stored
+  EXPECT_EQ(diploid_genotyped.get_likelihoods().size() +
+                diploid_genotyped.get_num_pruned_genotypes(),
+            10);
+}
+
+TEST(TestLevelGenotyperModel_ManyAlleles,
+     GivenTwoDominantAlleles_UnlikelyHeterozygotesPrunedAndHetCalled) {
+  allele_vector alleles{
+      Allele{"AA", {1, 1}, 0},   Allele{"CC", {15, 15}, 1},
+      Allele{"GG", {14, 14}, 2}, Allele{"TT", {1, 1}, 3},
+      Allele{"AC", {2, 2}, 4},   Allele{"AG", {1, 1}, 5},
+  };
+  GroupedAlleleCounts gp_counts{
+      {{0}, 1}, {{1}, 15}, {{2}, 14}, {{3}, 1}, {{4}, 2}, {{5}, 1},
+  };
+  likelihood_related_stats l_stats =
+      LevelGenotyper::make_l_stats(30, 0, 0.01);
+
+  ModelData data(alleles, gp_counts, Ploidy::Diploid, &l_stats);
+  auto genotyped = LevelGenotyperModel(data);
+  EXPECT_EQ(genotyped.get_site()->get_genotype(), (GtypedIndices{1, 2}));
+
+  // 6 homozygous + (6 choose 2) heterozygous genotypes
+  auto const& likelihoods = genotyped.get_likelihoods();
+  EXPECT_GT(genotyped.get_num_pruned_genotypes(), 0);
+  EXPECT_EQ(likelihoods.size() + genotyped.get_num_pruned_genotypes(), 21);
+
+  // The next best genotype is still available for computing confidence
+  auto it = likelihoods.begin();
+  auto best = (it++)->first;
+  EXPECT_DOUBLE_EQ(genotyped.get_genotype_confidence(), best - it->first);
 }
 
 class TestMaxLikelihoodCall : public ::testing::Test {
@@ -5,16 +5,31 @@
 using namespace gram::genotype::infer::probabilities;
 using namespace ::testing;
 
-TEST(ProbabilityMemoisation,
-     GivenSameQueryParamsTwice_ProbabilityOnlyComputedOnce) {
+TEST(ProbabilityTabulation,
+     GivenTabulatedPmf_IntegerCoveragesLookedUpOthersComputed) {
   MockPmf pmf;
 
-  EXPECT_CALL(pmf, compute_prob(params{1.5})).Times(1).WillOnce(Return(0.5));
+  EXPECT_CALL(pmf, compute_prob(_)).Times(3).WillRepeatedly(Return(0.5));
+  pmf.tabulate(2);
+  EXPECT_EQ(pmf.get_probs().size(), 3);
+  Mock::VerifyAndClearExpectations(&pmf);
 
-  double prob1 = pmf(params{1.5});
-  EXPECT_DOUBLE_EQ(prob1, 0.5);
-  double prob2 = pmf(params{1.5});
-  EXPECT_DOUBLE_EQ(prob2, prob1);
+  EXPECT_CALL(pmf, compute_prob(_)).Times(0);
+  EXPECT_DOUBLE_EQ(pmf(0), 0.5);
+  EXPECT_DOUBLE_EQ(pmf(2), 0.5);
+  Mock::VerifyAndClearExpectations(&pmf);
+
+  EXPECT_CALL(pmf, compute_prob(1.5)).Times(1).WillOnce(Return(0.25));
+  EXPECT_CALL(pmf, compute_prob(3)).Times(1).WillOnce(Return(0.125));
+  EXPECT_DOUBLE_EQ(pmf(1.5), 0.25);
+  EXPECT_DOUBLE_EQ(pmf(3), 0.125);
+}
+
+TEST(LogPmfs, GivenFractionalCoverage_MatchesClosedForm) {
+  PoissonLogPmf dpois{params{10}};
+  double const fractional{23.0 / 7};
+  double const expected{-10 + fractional * log(10) - lgamma(fractional + 1)};
+  EXPECT_DOUBLE_EQ(dpois(fractional), expected);
 }
 
 TEST(LikelihoodStats, DynamicChoiceOfProbDistribution) {
@@ -57,16 +72,29 @@ TEST(LikelihoodStats, DynamicDataParams) {
   EXPECT_EQ(int(num_successes * (1 - prob_success) / pow(prob_success, 2)), 20);
 }
 
-TEST(LogPmfs, GivenConstructedObject_PmfAt0IsAlreadyMemoised) {
+TEST(LogPmfs, GivenConstructedObject_PmfIsAlreadyTabulated) {
   pmf_ptr pmf;
   pmf = std::make_shared<PoissonLogPmf>(params{2});
   auto probs = pmf->get_probs();
-  EXPECT_EQ(probs.size(), 1);
-  EXPECT_EQ(probs.at(params{0}), -2);
+  EXPECT_EQ(probs.size(), min_tabulated_covs + 1);
+  EXPECT_EQ(probs.at(0), -2);
 
   pmf = std::make_shared<NegBinomLogPmf>(params{2, 0.5});
   probs = pmf->get_probs();
-  EXPECT_EQ(probs.size(), 1);
+  EXPECT_EQ(probs.size(), min_tabulated_covs + 1);
+}
+
+TEST(LogPmfs, GivenHighMeanCoverage_TableExtendsBeyondMinimumSize) {
+  PoissonLogPmf dpois{params{1000}};
+  EXPECT_EQ(dpois.get_probs().size(), 4001);
+}
+
+TEST(LogPmfs, GivenCoverageBeyondTable_ClosedFormMatchesTabulatedForm) {
+  PoissonLogPmf dpois{params{10}};
+  auto beyond_table = static_cast<double>(dpois.get_probs().size());
+  EXPECT_DOUBLE_EQ(dpois(beyond_table),
+                   -10 + beyond_table * log(10) - lgamma(beyond_table + 1));
+  EXPECT_DOUBLE_EQ(dpois(5), -10 + 5 * log(10) - lgamma(6));
 }
 
 /*
@@ -76,22 +104,22 @@ TEST(LogPmfs, GivenConstructedObject_PmfAt0IsAlreadyMemoised) {
 TEST(LogPmfs, GivenTruthProbabilities_LogPmfValuesCorrect) {
   PoissonLogPmf dpois{params{2}};
   double known1{-1.3068528194400546};  // = ln(Poisson(lambda = 2, count = 2))
-  auto res1 = dpois(params{2});
+  auto res1 = dpois(2);
   EXPECT_FLOAT_EQ(res1, known1);
 
   dpois = PoissonLogPmf{params{2.5}};
   double known2{-1.3605657168116352};  // = ln(Poisson(lambda = 2, count = 2.5))
-  auto res2 = dpois(params{2});
+  auto res2 = dpois(2);
   EXPECT_DOUBLE_EQ(res2, known2);
 
   auto dnbinom = std::make_shared<NegBinomLogPmf>(params{2, 0.5});
   known1 = -1.6739764335716716;
-  res1 = (*dnbinom)(params{2});
+  res1 = (*dnbinom)(2);
   EXPECT_DOUBLE_EQ(res1, known1);
 
   dnbinom = std::make_shared<NegBinomLogPmf>(params{2.5, 0.5});
   known2 = -2.3056313146033682;
-  res2 = (*dnbinom)(params{4});
+  res2 = (*dnbinom)(4);
   EXPECT_DOUBLE_EQ(res2, known2);
 }
 
@@ -9,6 +9,7 @@
 #include "../mocks.hpp"
 #include "genotype/infer/level_genotyping/runner.hpp"
 #include "genotype/infer/output_specs/make_json.hpp"
+#include "genotype/infer/output_specs/segment_tracker.hpp"
 #include "gtest/gtest.h"
 
 TEST(LevelGenotyping, Given2SiteNonNestedPRG_CorrectGenotypes) {
@@ -64,6 +65,42 @@ TEST(LevelGenotyping, Given2SiteNestedPRG_CorrectGenotypes) {
   EXPECT_EQ(gt_alleles, (allele_vector{Allele{"CCCG", {5, 5, 5, 5}, 0}}));
 }
 
+TEST(LevelGenotyping, GivenSiteSelection_OnlySelectedSitesGenotypedAndOutput) {
+  std::string prg{"AATAA[CCC[A,G],T]AA[C,G]AA"};
+  prg_setup setup;
+  setup.setup_bracketed_prg(prg);
+
+  GenomicRead_vector reads;
+  for (int i = 0; i < 5; i++) {
+    reads.push_back(GenomicRead("Read1", "AATAACCCGAA", "???????????"));
+    reads.push_back(GenomicRead("Read2", "AAGAA", "?????"));
+  }
+  setup.quasimap_reads(reads);
+
+  SiteSelection selection{false, false, true};
+  auto gtyper = std::make_shared<LevelGenotyper>(
+      setup.prg_info.coverage_graph, setup.coverage.grouped_allele_counts,
+      setup.read_stats, Ploidy::Haploid, false, "",
+      DEFAULT_MAX_ALLELE_COMBINATIONS, selection);
+  auto gt_recs = gtyper->get_genotyped_records();
+
+  // Unselected sites are null, on their REF allele only
+  EXPECT_TRUE(gt_recs.at(0)->is_null());
+  EXPECT_EQ(gt_recs.at(0)->get_alleles().size(), 1);
+  EXPECT_EQ(gt_recs.at(0)->get_alleles().at(0).sequence, "CCCA");
+  EXPECT_TRUE(gt_recs.at(1)->is_null());
+  auto gt_alleles = gt_recs.at(2)->get_unique_genotyped_alleles();
+  EXPECT_EQ(gt_alleles, (allele_vector{Allele{"G", {5}, 1}}));
+
+  std::stringstream coords_file{""};
+  SegmentTracker tracker(coords_file);
+  auto json_prg = make_json_prg(gtyper, tracker)->get_prg();
+  EXPECT_EQ(json_prg.at("Sites").size(), 1);
+  EXPECT_EQ(json_prg.at("Sites").at(0).at("POS"), 12);
+  EXPECT_EQ(json_prg.at("Lvl1_Sites"), JSON::array({0}));
+  EXPECT_TRUE(json_prg.at("Child_Map").empty());
+}
+
 TEST(LevelGenotyper, GivenPRGWithDirectDeletion_CorrectlyCalledEmptyAllele) {
   std::string prg{"GGGGG[CCC,]GG"};
   prg_setup setup;
@@ -150,6 +187,26 @@ TEST_F(LG_SnpsNestedInTwoHaplotypes, MapReads_CorrectlyInvalidatedSites) {
   EXPECT_FLOAT_EQ(json_result.at("GT_CONF").at(0), 0.);
 }
 
+TEST_F(LG_SnpsNestedInTwoHaplotypes, StreamedJson_SameAsInMemoryJson) {
+  setup.quasimap_reads(reads);
+  auto gtyper = std::make_shared<LevelGenotyper>(
+      setup.prg_info.coverage_graph, setup.coverage.grouped_allele_counts,
+      setup.read_stats, Ploidy::Haploid);
+  std::stringstream coords_file{""};
+  SegmentTracker tracker(coords_file);
+
+  auto json_prg = make_json_prg(gtyper, tracker);
+  json_prg->set_sample_info("sample", "desc");
+  std::stringstream expected;
+  expected << json_prg->get_prg();
+
+  tracker.reset();
+  std::stringstream result;
+  write_json_prg(result, gtyper, tracker, "sample", "desc");
+  EXPECT_EQ(result.str(), expected.str());
+  EXPECT_EQ(JSON::parse(result.str()), json_prg->get_prg());
+}
+
 TEST(GCPSimulation, GivenDifferentNumGenotypedSites_ConsistentNumConfidences) {
   auto l_stats = LevelGenotyper::make_l_stats(20, 10, 0.1);
   Ploidy ploidy{Ploidy::Haploid};
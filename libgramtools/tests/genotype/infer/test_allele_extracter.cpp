@@ -41,10 +41,10 @@ TEST_F(AlleleCombineTest,
   site.set_alleles(allele_vector{Allele{"CCC", {1, 1, 1}, 2}});
   site.set_genotype(GtypedIndices{0});
 
-  allele_vector one_allele{existing_alleles.at(0)};
-  auto result = test_extracter.allele_combine(one_allele, 0);
+  AlleleProduct one_allele{allele_vector{existing_alleles.at(0)}};
+  test_extracter.allele_combine(one_allele, 0);
   allele_vector expected{{"ATTGCCC", {0, 1, 2, 3, 1, 1, 1}, 0}};
-  EXPECT_EQ(result, expected);
+  EXPECT_EQ(one_allele.materialise(), expected);
 }
 
 TEST_F(AlleleCombineTest,
@@ -58,10 +58,11 @@ TEST_F(AlleleCombineTest,
   site.set_extra_alleles(allele_vector{Allele{"AAA", {2, 1, 0}, 2, false}});
   site.set_genotype(GtypedIndices{1});
 
-  allele_vector one_allele{existing_alleles.at(0)};
+  AlleleProduct one_allele{allele_vector{existing_alleles.at(0)}};
   EXPECT_TRUE(one_allele.at(0).nesting_consistent);
 
-  auto result = test_extracter.allele_combine(one_allele, 0);
+  test_extracter.allele_combine(one_allele, 0);
+  auto result = one_allele.materialise();
   allele_vector expected{
       {"ATTGGGG", {0, 1, 2, 3, 2, 2, 2}, 0},
       {"ATTGAAA", {0, 1, 2, 3, 2, 1, 0}, 0},
@@ -76,9 +77,10 @@ TEST_F(AlleleCombineTest, TwoAllelesNullGenotype_oneCorrectCombinationAllele) {
   site.set_alleles(
       allele_vector{Allele{"TTT", {1, 1, 1}}, Allele{"CCC", {0, 1, 1}}});
 
-  allele_vector one_allele(existing_alleles.begin(),
-                           existing_alleles.begin() + 1);
-  auto result = test_extracter.allele_combine(one_allele, 0);
+  AlleleProduct one_allele{allele_vector(existing_alleles.begin(),
+                                         existing_alleles.begin() + 1)};
+  test_extracter.allele_combine(one_allele, 0);
+  auto result = one_allele.materialise();
   allele_vector expected{{"ATTGTTT", {0, 1, 2, 3, 1, 1, 1}, 0}};
 
   EXPECT_EQ(result, expected);
@@ -97,7 +99,9 @@ TEST_F(AlleleCombineTest,
           1  // Note the pasted allele's haplogroup should get ignored
       }});
 
-  auto result = test_extracter.allele_combine(existing_alleles, 0);
+  AlleleProduct existing{existing_alleles};
+  test_extracter.allele_combine(existing, 0);
+  auto result = existing.materialise();
   allele_vector expected{
       {"ATTGCCC", {0, 1, 2, 3, 1, 1, 1}, 0},
       {"ATTGTTT", {0, 1, 2, 3, 5, 5, 5}, 0},
@@ -109,6 +113,52 @@ TEST_F(AlleleCombineTest,
   for (auto const& allele : result) EXPECT_TRUE(allele.nesting_consistent);
 }
 
+TEST_F(AlleleCombineTest,
+       TooManyCombinations_LastAllelesDroppedAndDroppedAllelesCounted) {
+  site.set_genotype(GtypedIndices{0, 1});
+  site.set_alleles(allele_vector{Allele{"CCC", {1, 1, 1}, 0},
+                                 Allele{"TTT", {5, 5, 5}, 1}});
+  site.set_extra_alleles(allele_vector{Allele{"AAA", {2, 1, 0}, 2, false}});
+
+  AlleleExtracter limited_extracter{sites, 5};
+  AlleleProduct existing{existing_alleles};
+  limited_extracter.allele_combine(existing, 0);
+
+  // 2 existing alleles x 3 relevant alleles > 5, so the extra allele goes
+  allele_vector expected{
+      {"ATTGCCC", {0, 1, 2, 3, 1, 1, 1}, 0},
+      {"ATTGTTT", {0, 1, 2, 3, 5, 5, 5}, 0},
+      {"ATCGCCC", {0, 0, 1, 1, 1, 1, 1}, 0},
+      {"ATCGTTT", {0, 0, 1, 1, 5, 5, 5}, 0},
+  };
+  EXPECT_EQ(existing.materialise(), expected);
+  EXPECT_EQ(limited_extracter.get_num_dropped_alleles(), 1);
+}
+
+TEST(AlleleProductTest, GivenCombinedAndPastedAlleles_MatchesEagerProduct) {
+  allele_vector first{{"A", {1}, 3}, {"C", {2}, 3}};
+  allele_vector second{{"G", {3}, 0}, {"T", {4}, 1, false}, {"", {}, 2}};
+  Allele common{"TT", {5, 6}};
+
+  AlleleProduct product{first};
+  product.paste(common);
+  product.combine(second);
+  product.paste(common);
+
+  allele_vector eager;
+  for (auto const& f : first) {
+    for (auto const& s : second) eager.push_back(f + common + s + common);
+  }
+  EXPECT_EQ(product.size(), 6);
+  auto materialised = product.materialise();
+  EXPECT_EQ(materialised, eager);
+  for (std::size_t i{0}; i < eager.size(); ++i) {
+    EXPECT_EQ(materialised.at(i).haplogroup, 3);
+    EXPECT_EQ(materialised.at(i).nesting_consistent,
+              eager.at(i).nesting_consistent);
+  }
+}
+
 TEST(AllelePasteTest,
      TwoAllelesOneCoverageNode_CorrectlyAppendedSequenceandCoverage) {
   allele_vector existing_alleles{{"ATTG", {0, 1, 2, 3}, 0},
@@ -119,12 +169,13 @@ TEST(AllelePasteTest,
   covG_ptr cov_Node = boost::make_shared<coverage_Node>("ATTCGC", 120, 1, 1);
 
   AlleleExtracter extracter;
-  extracter.allele_paste(existing_alleles, cov_Node);
+  AlleleProduct existing{existing_alleles};
+  extracter.allele_paste(existing, cov_Node);
 
   allele_vector expected{{"ATTGATTCGC", {0, 1, 2, 3, 0, 0, 0, 0, 0, 0}, 0},
                          {"ATCGATTCGC", {0, 0, 1, 1, 0, 0, 0, 0, 0, 0}, 0}};
 
-  EXPECT_EQ(existing_alleles, expected);
+  EXPECT_EQ(existing.materialise(), expected);
 }
 
 class AlleleExtracter_NestedPRG : public ::testing::Test {
@@ -1,4 +1,9 @@
+#include <filesystem>
+#include <fstream>
+
+#include "genotype/infer/output_specs/json_combine.hpp"
 #include "genotype/infer/output_specs/json_prg_spec.hpp"
+#include "genotype/infer/output_specs/json_prg_stream.hpp"
 #include "genotype/infer/output_specs/json_site_spec.hpp"
 #include "genotype/infer/types.hpp"
 #include "gtest/gtest.h"
@@ -337,3 +342,148 @@ TEST(PRG_Combine_Successs2_cpy, GivenTwoPrgs_CorrectCombined) {
   site2_sample1.combine_with(site2_sample2);
   EXPECT_EQ(data.prg1.get_prg().at("Sites").at(1), site2_sample1.get_site());
 }
+
+TEST(PRG_Stream, GivenWrittenSites_ReadBackSameHeaderAndSites) {
+  JSON_data_store data;
+  auto const& prg = data.prg1.get_prg();
+  std::stringstream stream;
+  Json_Prg_Writer writer(stream, prg);
+  for (auto const& site : prg.at("Sites")) writer.add_site(site);
+  writer.close();
+  EXPECT_EQ(JSON::parse(stream.str()), prg);
+
+  Json_Prg_Reader reader(stream);
+  auto expected_header = prg;
+  expected_header.erase("Sites");
+  EXPECT_EQ(reader.get_header(), expected_header);
+
+  JSON site;
+  for (auto const& expected_site : prg.at("Sites")) {
+    ASSERT_TRUE(reader.next_site(site));
+    EXPECT_EQ(site, expected_site);
+  }
+  EXPECT_FALSE(reader.next_site(site));
+}
+
+TEST(PRG_Stream, GivenSitesBeforeOtherEntries_ReadFullHeaderAndSites) {
+  JSON_data_store data;
+  auto header = data.prg1.get_prg();
+  auto const sites = header.at("Sites");
+  header.erase("Sites");
+  std::stringstream stream;
+  stream << "{\"Sites\": " << sites.dump(2) << ", " << header.dump().substr(1);
+
+  Json_Prg_Reader reader(stream);
+  EXPECT_EQ(reader.get_header(), header);
+  JSON site;
+  for (auto const& expected_site : sites) {
+    ASSERT_TRUE(reader.next_site(site));
+    EXPECT_EQ(site, expected_site);
+  }
+  EXPECT_FALSE(reader.next_site(site));
+}
+
+TEST(Combine_Sites, GivenThreeSites_SameAsPairwiseCombined) {
+  JSON_data_store data;
+  std::vector<JSON> sites;
+  for (auto const& sample : data.site1_samples)
+    sites.push_back(sample->get_site());
+  auto result = combine_sites(sites, "");
+
+  MockJsonSite expected({"CTCCT", "CTT", "GTT"}, {{0, 0}, {1, 1}, {0, 2}},
+                        {{0, 0}, {1, 1}, {0, 2}},
+                        {{10, 2, 0}, {2, 10, 0}, {5, 0, 5}}, {11, 11, 12}, 3,
+                        "gene1");
+  EXPECT_EQ(result, expected.get_site());
+}
+
+TEST(Combine_Sites, GivenAlleleCalledInLaterSample_EarlierSampleKeepsItsCov) {
+  std::vector<JSON> sites{
+      MockJsonSite({"A", "C", "G"}, {0}, {0}, {5, 1, 2}, 8, 1, "").get_site(),
+      MockJsonSite({"A", "C"}, {1}, {1}, {0, 4}, 4, 1, "").get_site(),
+      MockJsonSite({"A", "G"}, {1}, {2}, {1, 3}, 4, 1, "").get_site()};
+  auto result = combine_sites(sites, "");
+
+  MockJsonSite expected({"A", "C", "G"}, {{0}, {1}, {2}}, {{0}, {1}, {2}},
+                        {{5, 1, 2}, {0, 4, 0}, {1, 0, 3}}, {8, 4, 4}, 1, "");
+  EXPECT_EQ(result, expected.get_site());
+}
+
+TEST(Combine_Sites, GivenKeepUncalledAlleles_UncalledAllelesLast) {
+  std::vector<JSON> sites{
+      MockJsonSite({"A", "C", "G"}, {0}, {0}, {5, 1, 2}, 8, 1, "").get_site(),
+      MockJsonSite({"A", "T"}, {1}, {1}, {0, 4}, 4, 1, "").get_site()};
+  auto result = combine_sites(sites, "", true);
+  EXPECT_EQ(result.at("ALS"), JSON({"A", "T", "C", "G"}));
+  EXPECT_EQ(result.at("COV").at(0), JSON({5, 0, 1, 2}));
+}
+
+static std::vector<std::string> dump_all(std::vector<Json_Prg>& prgs) {
+  std::vector<std::string> result;
+  for (auto& prg : prgs) result.push_back(prg.get_prg().dump());
+  return result;
+}
+
+static std::string combine_dumps(std::vector<std::string> const& dumps,
+                                 combine_params const& params) {
+  std::vector<std::stringstream> streams;
+  std::vector<std::istream*> inputs;
+  for (auto const& dump : dumps) streams.emplace_back(dump);
+  for (auto& stream : streams) inputs.push_back(&stream);
+  std::stringstream out;
+  combine_jsons(inputs, out, params);
+  return out.str();
+}
+
+TEST(Combine_Jsons, GivenTwoPrgs_SameAsPairwiseCombined) {
+  JSON_data_store data;
+  std::vector<Json_Prg> prgs{data.prg1, data.prg2};
+  combine_params params;
+  params.chunk_size = 1;
+  auto result = combine_dumps(dump_all(prgs), params);
+
+  data.prg1.combine_with(data.prg2);
+  EXPECT_EQ(result, data.prg1.get_prg().dump());
+}
+
+TEST(Combine_Jsons, GivenDifferentNumOfSites_Fails) {
+  JSON_data_store data;
+  data.prg2.add_site(data.site1_samples.at(2));
+  std::vector<Json_Prg> prgs{data.prg1, data.prg2};
+  EXPECT_THROW(combine_dumps(dump_all(prgs), combine_params{}),
+               JSONCombineException);
+}
+
+TEST(Combine_Jsons, GivenManyFiles_HierarchicalSameAsFlatCombine) {
+  namespace fs = std::filesystem;
+  auto const dir = fs::temp_directory_path() / "gram_combine_jsons_test";
+  fs::create_directories(dir);
+
+  // Each sample calls a different allele, and has coverage on all of them
+  allele_vec const alleles{"A", "C", "G", "T", "AA"};
+  strings fpaths;
+  for (int i{0}; i < 5; i++) {
+    Json_Prg prg;
+    prg.set_sample_info("Sample" + std::to_string(i), "");
+    prg.add_site(std::make_shared<MockJsonSite>(
+        alleles, GtypedIndices{i}, AlleleIds{i},
+        allele_coverages{1, 2, 3, 4, 5}, 15, 1, "seg"));
+    fpaths.push_back((dir / ("in" + std::to_string(i))).string());
+    std::ofstream(fpaths.back()) << prg.get_prg();
+  }
+
+  combine_params params;
+  auto const flat_fpath = (dir / "flat").string();
+  combine_json_files(fpaths, flat_fpath, params);
+  params.max_inputs_per_merge = 2;
+  auto const hierarchical_fpath = (dir / "hierarchical").string();
+  combine_json_files(fpaths, hierarchical_fpath, params);
+
+  JSON flat, hierarchical;
+  std::ifstream(flat_fpath) >> flat;
+  std::ifstream(hierarchical_fpath) >> hierarchical;
+  EXPECT_EQ(flat.at("Samples").size(), 5);
+  EXPECT_EQ(flat.at("Sites").at(0).at("COV").at(0), JSON({1, 2, 3, 4, 5}));
+  EXPECT_EQ(hierarchical, flat);
+  fs::remove_all(dir);
+}
@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+
+#include "genotype/infer/output_specs/make_vcf.hpp"
+#include "genotype/infer/output_specs/segment_tracker.hpp"
+#include "gtest/gtest.h"
+#include "mocks.hpp"
+#include "prg/coverage_graph.hpp"
+
+using namespace ::testing;
+namespace fs = std::filesystem;
+
+class VcfGenotyper : public Genotyper {
+ public:
+  VcfGenotyper(gt_sites const& sites, coverage_Graph const& cov_g)
+      : Genotyper(sites, child_map{}) {
+    cov_graph = &cov_g;
+  }
+  header_vec get_model_specific_headers() override { return {}; }
+};
+
+static gt_site_ptr make_vcf_site(std::size_t pos, Filters const& filters) {
+  auto site = std::make_shared<NiceMock<MockGenotypedSite>>();
+  ON_CALL(*site, get_model_specific_entries())
+      .WillByDefault(Return(site_entries{}));
+  site->populate_site(gtype_information{
+      allele_vector{Allele{"A", {1}, 0}, Allele{"G", {4}, 1}},
+      GtypedIndices{1},
+      allele_coverages{1, 4},
+      5,
+      AlleleIds{1}});
+  for (auto const& filter : filters) site->set_filter(filter);
+  site->set_pos(pos);
+  return site;
+}
+
+/** Reads the FT field of the vcf's single sample */
+static std::string read_ft(bcf_hdr_t* header, bcf1_t* record) {
+  char** dst = nullptr;
+  int ndst = 0;
+  std::string result;
+  if (bcf_get_format_string(header, record, "FT", &dst, &ndst) > 0)
+    result = dst[0];
+  if (dst != nullptr) {
+    free(dst[0]);
+    free(dst);
+  }
+  return result;
+}
+
+class WriteVcf : public Test {
+ protected:
+  void SetUp() override {
+    params.genotyped_vcf_fpath = "@genotyped.vcf.gz";
+    params.sample_id = "sample";
+    params.maximum_threads = 1;
+    gtyper = std::make_shared<VcfGenotyper>(
+        gt_sites{make_vcf_site(5, {}), make_vcf_site(20, {"AMBIG", "LOWQ"})},
+        cov_g);
+    std::istringstream coords{"JAC 100"};
+    tracker = SegmentTracker{coords};
+    write_vcf(params, gtyper, tracker);
+
+    fin = bcf_open(params.genotyped_vcf_fpath.c_str(), "r");
+    ASSERT_NE(fin, nullptr);
+    header = bcf_hdr_read(fin);
+    record = bcf_init();
+  }
+
+  void TearDown() override {
+    if (record != nullptr) bcf_destroy(record);
+    if (header != nullptr) bcf_hdr_destroy(header);
+    if (fin != nullptr) bcf_close(fin);
+    std::remove(params.genotyped_vcf_fpath.c_str());
+    std::remove(index_fpath().c_str());
+  }
+
+  std::string index_fpath() const {
+    return params.genotyped_vcf_fpath + ".csi";
+  }
+
+  GenotypeParams params;
+  coverage_Graph cov_g;
+  gtyper_ptr gtyper;
+  SegmentTracker tracker;
+  htsFile* fin = nullptr;
+  bcf_hdr_t* header = nullptr;
+  bcf1_t* record = nullptr;
+};
+
+TEST_F(WriteVcf, GivenSeveralFilters_JoinedIntoOneFtString) {
+  ASSERT_EQ(bcf_read(fin, header, record), 0);
+  EXPECT_EQ(record->pos, 5);
+  EXPECT_EQ(read_ft(header, record), "PASS");
+
+  ASSERT_EQ(bcf_read(fin, header, record), 0);
+  EXPECT_EQ(record->pos, 20);
+  EXPECT_EQ(read_ft(header, record), "AMBIG,LOWQ");
+
+  EXPECT_NE(bcf_read(fin, header, record), 0);
+}
+
+TEST_F(WriteVcf, GivenWrittenVcf_CsiIndexQueriesRegion) {
+  ASSERT_TRUE(fs::exists(index_fpath()));
+  hts_idx_t* index = bcf_index_load(params.genotyped_vcf_fpath.c_str());
+  ASSERT_NE(index, nullptr);
+
+  // 1-based, inclusive: covers the second site only
+  hts_itr_t* itr = bcf_itr_querys(index, header, "JAC:10-30");
+  ASSERT_NE(itr, nullptr);
+  std::vector<hts_pos_t> positions;
+  while (bcf_itr_next(fin, itr, record) >= 0) positions.push_back(record->pos);
+  EXPECT_EQ(positions, std::vector<hts_pos_t>{20});
+
+  hts_itr_destroy(itr);
+  hts_idx_destroy(index);
+}
@@ -256,6 +256,65 @@ TEST(PbCovRecorder_NodeProcessing,
   EXPECT_EQ(expected_mapping, pb_rec.get_cov_mapping());
 }
 
+TEST(PbCovRecorder_NodeProcessing,
+     GivenTwoRecorders_EachKeepsItsOwnDummyCovNodes) {
+  covG_ptr first_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"ACTG", 102, 5, 1});
+  covG_ptr second_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"AC", 107, 5, 2});
+
+  PbCovRecorder first_rec;
+  first_rec.process_Node(first_node, 1, 3);
+  PbCovRecorder second_rec;
+  second_rec.process_Node(second_node, 0, 1);
+
+  realCov_to_dummyCov expected_first{{first_node, DummyCovNode(1, 3, 4)}};
+  realCov_to_dummyCov expected_second{{second_node, DummyCovNode(0, 1, 2)}};
+  EXPECT_EQ(expected_first, first_rec.get_cov_mapping());
+  EXPECT_EQ(expected_second, second_rec.get_cov_mapping());
+}
+
+TEST(DummyCovNodes, GivenUnattachedNodes_EachGetsItsOwnDummyCovNode) {
+  covG_ptr first_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"ACTG", 102, 5, 1});
+  covG_ptr second_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"AC", 107, 5, 2});
+  auto store = boost::make_shared<PbCovStore>();
+  covG_ptr attached_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"CC", 110, 5, 3});
+  attached_node->attach_coverage(store);
+
+  DummyCovNodes dummy_nodes;
+  dummy_nodes.insert(attached_node, DummyCovNode{0, 0, 2});
+  EXPECT_EQ(dummy_nodes.find(first_node), nullptr);
+  dummy_nodes.insert(first_node, DummyCovNode{1, 3, 4});
+  EXPECT_EQ(dummy_nodes.find(second_node), nullptr);
+  dummy_nodes.insert(second_node, DummyCovNode{0, 1, 2});
+
+  EXPECT_EQ(*dummy_nodes.find(first_node), (DummyCovNode{1, 3, 4}));
+  EXPECT_EQ(*dummy_nodes.find(second_node), (DummyCovNode{0, 1, 2}));
+  EXPECT_EQ(*dummy_nodes.find(attached_node), (DummyCovNode{0, 0, 2}));
+}
+
+TEST(DummyCovNodes, GivenClearedSet_NodesFromBeforeClearNotFound) {
+  auto store = boost::make_shared<PbCovStore>();
+  covG_ptr first_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"ACTG", 102, 5, 1});
+  covG_ptr second_node =
+      boost::make_shared<coverage_Node>(coverage_Node{"AC", 107, 5, 2});
+  first_node->attach_coverage(store);
+  second_node->attach_coverage(store);
+
+  DummyCovNodes dummy_nodes;
+  dummy_nodes.insert(second_node, DummyCovNode{0, 1, 2});
+  EXPECT_EQ(dummy_nodes.find(first_node), nullptr);
+  EXPECT_EQ(*dummy_nodes.find(second_node), (DummyCovNode{0, 1, 2}));
+
+  dummy_nodes.clear();
+  EXPECT_EQ(dummy_nodes.find(second_node), nullptr);
+  EXPECT_TRUE(dummy_nodes.get_entries().empty());
+}
+
 /**
  * Tests full coverage recording by inspecting `DummyCovNode`s and
  * `coverage_Node`s
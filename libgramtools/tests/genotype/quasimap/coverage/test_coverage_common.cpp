@@ -37,15 +37,63 @@ TEST(LocusFinder_logic, SameSiteMoreThanOnceInSearchState_ThrowsError) {
   EXPECT_THROW(l.check_site_uniqueness(search_state), std::logic_error);
 }
 
-TEST(SameLevel0SitesDifferentOrder, SingleEntryInMap) {
-  level0_Sites s1{Marker{5}, Marker{7}, Marker{9}, Marker{11}};
-  level0_Sites s2{Marker{11}, Marker{9}, Marker{7}, Marker{5}};
+TEST(SameLevel0SitesDifferentOrder, SingleEquivalenceClass) {
+  SearchStates search_states = {
+      SearchState{SA_Interval{},
+                  VariantSitePath{VariantLocus{5, FIRST_ALLELE},
+                                  VariantLocus{7, FIRST_ALLELE},
+                                  VariantLocus{9, FIRST_ALLELE},
+                                  VariantLocus{11, FIRST_ALLELE}}},
+      SearchState{SA_Interval{},
+                  VariantSitePath{VariantLocus{11, FIRST_ALLELE},
+                                  VariantLocus{9, FIRST_ALLELE},
+                                  VariantLocus{7, FIRST_ALLELE},
+                                  VariantLocus{5, FIRST_ALLELE}}}};
+  PRG_Info prg_info;
+  MappingInstanceSelector m{&prg_info};
+  m.process_searchstates(search_states);
 
-  uniqueSitePaths unique_map{};
-  unique_map.insert({s1, traversal_info{}});
-  unique_map.insert({s2, traversal_info{}});
+  EXPECT_EQ(1, m.num_classes());
+  auto usps = m.get_usps();
+  EXPECT_EQ(usps.begin()->first, (level0_Sites{5, 7, 9, 11}));
+}
 
-  EXPECT_EQ(1, unique_map.size());
+TEST(SelectorBuffers, GivenTwoSelectors_EachKeepsItsOwnClasses) {
+  SearchStates first_search_states = {SearchState{
+      SA_Interval{}, VariantSitePath{VariantLocus{5, FIRST_ALLELE}}}};
+  SearchStates second_search_states = {
+      SearchState{SA_Interval{},
+                  VariantSitePath{VariantLocus{7, FIRST_ALLELE}}},
+      SearchState{SA_Interval{},
+                  VariantSitePath{VariantLocus{9, FIRST_ALLELE}}}};
+  PRG_Info prg_info;
+  MappingInstanceSelector first{&prg_info};
+  first.process_searchstates(first_search_states);
+  MappingInstanceSelector second{&prg_info};
+  second.process_searchstates(second_search_states);
+
+  EXPECT_EQ(first.num_classes(), 1);
+  EXPECT_EQ(get_site_path_only(first.get_usps()),
+            (std::set<SitePath>{SitePath{5}}));
+  EXPECT_EQ(second.num_classes(), 2);
+}
+
+TEST(SelectorBuffers, GivenBuffersPassedIn_ReusedByNextSelector) {
+  SearchStates search_states = {SearchState{
+      SA_Interval{}, VariantSitePath{VariantLocus{5, FIRST_ALLELE}}}};
+  PRG_Info prg_info;
+  SelectorBuffers buffers;
+  {
+    MappingInstanceSelector m{&prg_info, nullptr, &buffers};
+    m.process_searchstates(search_states);
+  }
+  EXPECT_EQ(buffers.classes.size(), 1);
+
+  MappingInstanceSelector m{&prg_info, nullptr, &buffers};
+  EXPECT_EQ(m.num_classes(), 0);
+  m.process_searchstates(search_states);
+  EXPECT_EQ(m.num_classes(), 1);
+  EXPECT_EQ(buffers.classes.size(), 1);
 }
 
 TEST(GetUniquePathSites, TwoDifferentPaths_CorrectPaths) {
@@ -62,15 +110,16 @@ TEST(GetUniquePathSites, TwoDifferentPaths_CorrectPaths) {
   PRG_Info prg_info;
   MappingInstanceSelector m{&prg_info};
   m.process_searchstates(search_states);
-  auto result = get_site_path_only(m.usps);
+  auto result = get_site_path_only(m.get_usps());
   std::set<SitePath> expected = {SitePath{5, 7}, SitePath{9, 11}};
   EXPECT_EQ(result, expected);
 
   // Check SearchState dispatch
-  auto ss_result1 = m.usps[SitePath{5, 7}].first.front();
+  auto usps = m.get_usps();
+  auto ss_result1 = usps[SitePath{5, 7}].first.front();
   EXPECT_EQ(ss_result1, search_states.front());
 
-  auto ss_result2 = m.usps[SitePath{9, 11}].first.front();
+  auto ss_result2 = usps[SitePath{9, 11}].first.front();
   EXPECT_EQ(ss_result2, search_states.back());
 }
 
@@ -93,7 +142,7 @@ TEST(GetUniquePathSites,
   PRG_Info prg_info;
   MappingInstanceSelector m{&prg_info};
   m.process_searchstates(search_states);
-  auto result = get_site_path_only(m.usps);
+  auto result = get_site_path_only(m.get_usps());
   std::set<SitePath> expected = {SitePath{9, 11}};
   EXPECT_EQ(result, expected);
 }
@@ -297,6 +346,21 @@ TEST(RandomInclusiveInt, GivenSize2IntervalAndNoSeed_ReturnsInInclusiveRange) {
   EXPECT_TRUE(result <= 2);
 }
 
+TEST(CounterRandomInt, GivenKey_ReturnsKnownAnswers) {
+  CounterRandomInt r{2};
+  EXPECT_EQ(r.generate(1, 10), 1);
+  EXPECT_EQ(r.generate(1, 10), 7);
+  EXPECT_EQ(r.generate(1, 10), 2);
+}
+
+TEST(CounterRandomInt, GivenSameKey_SameDraws) {
+  auto const key = derive_key(42, 1, 7);
+  CounterRandomInt first{key}, second{key};
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(first.generate(1, 1000), second.generate(1, 1000));
+  EXPECT_NE(derive_key(42, 1, 7), derive_key(42, 7, 1));
+}
+
 class MappingInstanceSelector_addSearchStates : public ::testing::Test {
  protected:
   // In this example we pretend we have mapped "TAA" to the graph.
@@ -328,7 +392,7 @@ TEST_F(MappingInstanceSelector_addSearchStates,
       uniqueLoci{VariantLocus{5, FIRST_ALLELE}, VariantLocus{7, FIRST_ALLELE}}};
   uniqueSitePaths expected_map{{SitePath{5}, expected_info}};
 
-  EXPECT_EQ(selector.usps, expected_map);
+  EXPECT_EQ(selector.get_usps(), expected_map);
 }
 
 TEST_F(MappingInstanceSelector_addSearchStates,
@@ -338,15 +402,16 @@ TEST_F(MappingInstanceSelector_addSearchStates,
 
   traversal_info expected_i1{
       SearchStates{s1, s2},
-      uniqueLoci{VariantLocus{5, FIRST_ALLELE}, VariantLocus{7, FIRST_ALLELE},
-                 VariantLocus{5, FIRST_ALLELE + 1}}};
+      uniqueLoci{VariantLocus{5, FIRST_ALLELE},
+                 VariantLocus{5, FIRST_ALLELE + 1},
+                 VariantLocus{7, FIRST_ALLELE}}};
 
   traversal_info expected_i2{SearchStates{s3},
                              uniqueLoci{VariantLocus{9, FIRST_ALLELE}}};
 
   uniqueSitePaths expected_map{{SitePath{5}, expected_i1},
                                {SitePath{9}, expected_i2}};
-  EXPECT_EQ(selector.usps, expected_map);
+  EXPECT_EQ(selector.get_usps(), expected_map);
 }
 
 class MappingInstanceSelector_select : public ::testing::Test {
@@ -379,9 +444,9 @@ TEST_F(MappingInstanceSelector_select,
       .WillOnce(Return(3));
 
   MappingInstanceSelector m{&prg_info, &r};
-  m.set_searchstates(ss);  // Copies them to m
+  m.set_searchstates(ss);  // Refers to them from m, without copying
   m.process_searchstates(ss);
-  EXPECT_EQ(m.usps.size(), 1);  // Expect one unique site recorded: 7
+  EXPECT_EQ(m.num_classes(), 1);  // Expect one unique site recorded: 7
 
   int32_t selected_index;
   selected_index = m.random_select_entry();
@@ -421,3 +486,22 @@ TEST_F(MappingInstanceSelector_select, selectvariant_nonemptyMappingSelector) {
                            {VariantLocus{7, FIRST_ALLELE + 1}}};
   EXPECT_EQ(selection.equivalence_class_loci, expected_loci);
 }
+
+TEST(MappingInstanceSelector_order,
+     ClassesDispatchedOutOfOrder_SelectedInLevel0SitesOrder) {
+  using namespace ::testing;
+  MockRandomGenerator r;
+  EXPECT_CALL(r, generate(1, 2)).Times(Exactly(1)).WillOnce(Return(1));
+  PRG_Info prg_info;
+  SearchStates ss{
+      SearchState{SA_Interval{1, 1},
+                  VariantSitePath{VariantLocus{9, FIRST_ALLELE}}},
+      SearchState{SA_Interval{2, 2},
+                  VariantSitePath{VariantLocus{5, FIRST_ALLELE + 1}}}};
+
+  MappingInstanceSelector m{ss, &prg_info, &r};
+  auto selection = m.get_selection();
+  EXPECT_EQ(selection.navigational_search_states, SearchStates{ss.back()});
+  EXPECT_EQ(selection.equivalence_class_loci,
+            uniqueLoci{VariantLocus(5, FIRST_ALLELE + 1)});
+}
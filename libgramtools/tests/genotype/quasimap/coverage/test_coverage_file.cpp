@@ -0,0 +1,136 @@
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "genotype/quasimap/coverage/coverage_file.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+using namespace gram;
+
+class CoverageFile : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    coverage.allele_sum_coverage = {{1, 12}, {0, 3, 0}};
+    coverage.grouped_allele_counts = {
+        GroupedAlleleCounts{{AlleleIds{0, 1}, 5}, {AlleleIds{1}, 7}},
+        GroupedAlleleCounts{{AlleleIds{1}, 3}}};
+    coverage.allele_base_coverage = {SitePbCoverage{{1}, {12, 11}},
+                                     SitePbCoverage{{0}, {0, 3}, {}}};
+  }
+
+  void TearDown() override { std::remove(fpath.c_str()); }
+
+  void expect_same_coverage(Coverage const &result) {
+    EXPECT_EQ(result.allele_sum_coverage, coverage.allele_sum_coverage);
+    EXPECT_EQ(result.grouped_allele_counts, coverage.grouped_allele_counts);
+    EXPECT_EQ(result.allele_base_coverage, coverage.allele_base_coverage);
+    EXPECT_EQ(result.graph_base_coverage, coverage.graph_base_coverage);
+  }
+
+  Coverage coverage;
+  std::string const fpath{"@coverage_file"};
+};
+
+TEST_F(CoverageFile, GivenCoverage_ReadBackUnchanged) {
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  expect_same_coverage(coverage::file::read(stream));
+}
+
+TEST_F(CoverageFile, GivenNoPerBaseCoverage_ReadBackWithoutIt) {
+  coverage.allele_base_coverage.clear();
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  expect_same_coverage(coverage::file::read(stream));
+}
+
+TEST_F(CoverageFile, GivenCompressedFile_LoadedUnchanged) {
+  coverage::file::dump(fpath, coverage, true);
+  expect_same_coverage(coverage::file::load(fpath));
+  coverage::file::dump(fpath, coverage, false);
+  expect_same_coverage(coverage::file::load(fpath));
+}
+
+TEST_F(CoverageFile, GivenTruncatedStream_Throws) {
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  auto const contents = stream.str();
+  std::stringstream truncated{contents.substr(0, contents.size() - 1)};
+  EXPECT_THROW(coverage::file::read(truncated), std::runtime_error);
+  std::stringstream not_coverage{"{\"allele_base_counts\":[]}"};
+  EXPECT_THROW(coverage::file::read(not_coverage), std::runtime_error);
+}
+
+TEST_F(CoverageFile, GivenCorruptCount_ThrowsBeforeAllocating) {
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  auto contents = stream.str();
+  // The first site's number of alleles, right after the 24-byte header
+  contents.replace(24, 4, "\xff\xff\xff\xff");
+  std::stringstream corrupt{contents};
+  EXPECT_THROW(coverage::file::read(corrupt), std::runtime_error);
+
+  // Compressed streams cannot tell their size: reading runs out of data first
+  {
+    std::ofstream ofs{fpath, std::ios::binary};
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(ofs);
+    out << contents;
+  }
+  EXPECT_THROW(coverage::file::load(fpath), std::runtime_error);
+}
+
+TEST_F(CoverageFile, GivenCoverage_SameLegacyJSONAfterReadBack) {
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  auto const result = coverage::file::read(stream);
+  EXPECT_EQ(dump_allele_base_coverage(result.allele_base_coverage),
+            "{\"allele_base_counts\":[[[1],[12,11]],[[0],[0,3],[]]]}");
+}
+
+TEST_F(CoverageFile, GivenGraphPerBaseCoverage_ReadBackUnchanged) {
+  coverage.allele_base_coverage.clear();
+  coverage.graph_base_coverage = {0, 4, 1, 0, 70000};
+  std::stringstream stream;
+  coverage::file::write(stream, coverage);
+  expect_same_coverage(coverage::file::read(stream));
+}
+
+TEST_F(CoverageFile, GivenNestedPrg_PerBaseCoverageReloadedOntoGraph) {
+  // PRG: "A[T[TT,T]T,a[at,]a]G[C,g]" ; Read: "ATTTTGC"
+  std::string const prg{"a[t[tt,t]t,a[at,]a]g[c,g]"};
+  prg_positions const positions{0, 2, 4, 7, 9, 11, 13, 17, 19, 21, 23};
+  prg_setup mapped;
+  mapped.setup_bracketed_prg(prg);
+  quasimap_read(encode_dna_bases("ATTTTGC"), mapped.coverage,
+                mapped.kmer_index, mapped.prg_info, mapped.parameters,
+                mapped.quasimap_stats);
+  auto const expected =
+      collect_coverage(mapped.prg_info.coverage_graph, positions);
+
+  mapped.quasimap_stats.coverage = mapped.coverage;
+  mapped.parameters.coverage_fpath = fpath;
+  finalise_coverage(mapped.quasimap_stats, mapped.read_stats,
+                    mapped.parameters, mapped.prg_info);
+  auto const loaded = coverage::file::load(fpath);
+  EXPECT_TRUE(loaded.allele_base_coverage.empty());
+  ASSERT_FALSE(loaded.graph_base_coverage.empty());
+
+  prg_setup reloaded;
+  reloaded.setup_bracketed_prg(prg);
+  coverage::file::restore_graph_base_coverage(loaded.graph_base_coverage,
+                                              reloaded.prg_info);
+  EXPECT_EQ(collect_coverage(reloaded.prg_info.coverage_graph, positions),
+            expected);
+
+  prg_setup other_prg;
+  other_prg.setup_bracketed_prg("a[c,g]t");
+  EXPECT_THROW(coverage::file::restore_graph_base_coverage(
+                   loaded.graph_base_coverage, other_prg.prg_info),
+               std::runtime_error);
+}
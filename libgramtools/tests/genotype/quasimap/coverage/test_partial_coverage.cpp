@@ -0,0 +1,99 @@
+#include <cstdio>
+
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "genotype/quasimap/coverage/partial_coverage.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+class PartialCoverage : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (auto *setup : {&first, &second, &all, &merged}) {
+      setup->setup_numbered_prg(prg, 3);
+      setup->quasimap_stats.coverage = setup->coverage;
+    }
+  }
+
+  void TearDown() override {
+    for (auto const &fpath : fpaths) std::remove(fpath.c_str());
+  }
+
+  static void map(prg_setup &setup, GenomicRead_vector const &reads) {
+    for (auto const &read : reads) {
+      setup.read_stats.record_read(read);
+      quasimap_forward_reverse(
+          setup.quasimap_stats, setup.quasimap_stats.coverage,
+          encode_dna_bases(read.seq), setup.parameters, setup.kmer_index,
+          setup.prg_info, 0);
+    }
+    setup.read_stats.finalise_base_error_rate();
+  }
+
+  std::string const prg{"gct5c6g6t6ag7t8c8cta"};
+  std::vector<std::string> const fpaths{"@partial_coverage_1",
+                                        "@partial_coverage_2"};
+  prg_setup first, second, all, merged;
+};
+
+TEST_F(PartialCoverage, GivenShardedReads_MergedSameAsMappedTogether) {
+  GenomicRead_vector const first_reads{GenomicRead{"r1", "ctcagt", "5555"},
+                                       GenomicRead{"r2", "tgagcc", "????"}};
+  GenomicRead_vector const second_reads{GenomicRead{"r3", "agccta", ""},
+                                        GenomicRead{"r4", "ctcagt", "5555"},
+                                        GenomicRead{"r5", "aaaaaaa", "5555"}};
+  map(first, first_reads);
+  map(second, second_reads);
+  map(all, first_reads);
+  map(all, second_reads);
+
+  coverage::partial::dump(fpaths[0], first.quasimap_stats, first.read_stats,
+                          first.prg_info);
+  coverage::partial::dump(fpaths[1], second.quasimap_stats, second.read_stats,
+                          second.prg_info);
+  ReadStats merged_read_stats;
+  auto const result = coverage::partial::merge_all(fpaths, merged_read_stats,
+                                                   merged.prg_info);
+
+  auto const &expected = all.quasimap_stats;
+  EXPECT_EQ(result.all_reads_count, expected.all_reads_count);
+  EXPECT_EQ(result.exact_mapped_reads_count, expected.exact_mapped_reads_count);
+  EXPECT_EQ(result.missing_kmer_reads_count, expected.missing_kmer_reads_count);
+  EXPECT_EQ(result.coverage.allele_sum_coverage,
+            expected.coverage.allele_sum_coverage);
+  EXPECT_EQ(result.coverage.grouped_allele_counts,
+            expected.coverage.grouped_allele_counts);
+  EXPECT_EQ(coverage::generate::allele_base_non_nested(merged.prg_info),
+            coverage::generate::allele_base_non_nested(all.prg_info));
+
+  EXPECT_EQ(merged_read_stats.get_max_read_len(),
+            all.read_stats.get_max_read_len());
+  EXPECT_EQ(merged_read_stats.get_num_no_qual_reads(),
+            all.read_stats.get_num_no_qual_reads());
+  EXPECT_EQ(merged_read_stats.get_num_bases_processed(),
+            all.read_stats.get_num_bases_processed());
+  EXPECT_FLOAT_EQ(merged_read_stats.get_mean_pb_error(),
+                  all.read_stats.get_mean_pb_error());
+}
+
+TEST_F(PartialCoverage, GivenPartialCoverageOfOtherPrg_Throws) {
+  prg_setup other;
+  other.setup_numbered_prg("gct5c6g6t6ag", 3);
+  coverage::partial::dump(fpaths[0], other.quasimap_stats, other.read_stats,
+                          other.prg_info);
+  ReadStats read_stats;
+  EXPECT_THROW(coverage::partial::merge_all({fpaths[0]}, read_stats,
+                                            merged.prg_info),
+               std::runtime_error);
+}
+
+TEST_F(PartialCoverage, GivenPartialCoverageOfPrgWithMovedSites_Throws) {
+  // Same size, number of sites and site bases: only where sites end differs
+  prg_setup other;
+  other.setup_numbered_prg("ctag5c6g6t6g7t8c8cta", 3);
+  coverage::partial::dump(fpaths[0], other.quasimap_stats, other.read_stats,
+                          other.prg_info);
+  ReadStats read_stats;
+  EXPECT_THROW(coverage::partial::merge_all({fpaths[0]}, read_stats,
+                                            merged.prg_info),
+               std::runtime_error);
+}
@@ -0,0 +1,79 @@
+#include "genotype/quasimap/search/approximate_search.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+/*
+PRG: ACGTGCATTA[C,G]CCAGT
+Reads come from GCATTA[C,G]CCAG, with substitutions.
+*/
+class ApproximateSearch : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    setup.setup_numbered_prg("acgtgcatta5c6g6ccagt", 3);
+  }
+
+  SearchStates search(
+      std::string const &read,
+      std::size_t max_search_states = DEFAULT_MAX_SEARCH_STATES) {
+    return search_read_approximate(encode_dna_bases(read), 3, setup.kmer_index,
+                                   setup.prg_info, 1, max_search_states);
+  }
+
+  SearchStates search_exactly(std::string const &read) {
+    auto const encoded_read = encode_dna_bases(read);
+    return search_read_backwards(encoded_read,
+                                 get_last_kmer_in_read(3, encoded_read),
+                                 setup.kmer_index, setup.prg_info);
+  }
+
+  prg_setup setup;
+};
+
+TEST_F(ApproximateSearch, GivenOneErrorInRead_ErrorPositionFound) {
+  auto read = encode_dna_bases("gcatgacccag");
+  auto result = likely_error_positions(3, read, setup.kmer_index);
+  std::vector<bool> expected(read.size(), false);
+  expected[4] = true;
+  EXPECT_EQ(result, expected);
+}
+
+TEST_F(ApproximateSearch, GivenNoMissingKmer_AllPositionsPossibleErrors) {
+  auto read = encode_dna_bases("gcattaccc");
+  auto result = likely_error_positions(3, read, setup.kmer_index);
+  EXPECT_EQ(result, std::vector<bool>(read.size(), true));
+}
+
+TEST_F(ApproximateSearch, GivenOneSubstitution_MapsAsCorrectRead) {
+  auto const expected = search_exactly("gcattacccag");
+  ASSERT_FALSE(expected.empty());
+  EXPECT_EQ(search("gcatgacccag"), expected);
+}
+
+TEST_F(ApproximateSearch, GivenSubstitutionInLastKmer_MapsAsCorrectRead) {
+  auto const expected = search_exactly("gcattagccag");
+  ASSERT_FALSE(expected.empty());
+  EXPECT_EQ(search("gcattagccat"), expected);
+}
+
+TEST_F(ApproximateSearch, GivenTwoSubstitutions_NoMapping) {
+  EXPECT_TRUE(search("gcatgacccat").empty());
+}
+
+TEST_F(ApproximateSearch, GivenNoSearchStatesBudget_NoMapping) {
+  EXPECT_TRUE(search("gcatgacccag", 0).empty());
+}
+
+TEST_F(ApproximateSearch,
+       GivenMaxMismatchesAndDefaultParameters_ReadWithErrorCounted) {
+  auto const read = encode_dna_bases("gcatgacccag");
+  quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
+                setup.parameters, setup.quasimap_stats);
+  EXPECT_EQ(setup.quasimap_stats.missing_kmer_reads_count, 1);
+
+  setup.parameters.max_mismatches = 1;
+  quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
+                setup.parameters, setup.quasimap_stats);
+  EXPECT_EQ(setup.quasimap_stats.inexact_mapped_reads_count, 1);
+  AlleleSumCoverage expected{{1, 0}};
+  EXPECT_EQ(setup.coverage.allele_sum_coverage, expected);
+}
@@ -1,8 +1,13 @@
+#include <filesystem>
+
 #include "genotype/quasimap/search/encapsulated_search.hpp"
 #include "gtest/gtest.h"
+#include "prg/make_data_structures.hpp"
+#include "prg/prg_info.hpp"
 #include "submod_resources.hpp"
 
 using namespace gram::submods;
+namespace fs = std::filesystem;
 
 /*
 PRG: AC5T6CAGTAGTC6TA
@@ -252,3 +257,95 @@ TEST(HandleAlleleEncapsulatedState,
       }};
   EXPECT_EQ(result, expected);
 }
+
+/*
+PRG: AC5 C{70} 6G6TA
+SA indices 3 to 73 hold the 'C' suffixes, sorted as:
+C{70}6G6TA ... CC6G6TA, C5 C{70}6G6TA, C6G6TA
+The interval spans more than one block of the scan.
+*/
+TEST(HandleAlleleEncapsulatedState,
+     LongSaIntervalAcrossBlocks_RunsOfSameAlleleMerged) {
+  auto prg_raw = encode_prg("ac5" + std::string(70, 'c') + "6g6ta");
+  auto prg_info = generate_prg_info(prg_raw);
+  SearchState search_state{SA_Interval{3, 73}};
+  auto result = handle_allele_encapsulated_state(search_state, prg_info);
+  SearchStates expected = {
+      SearchState{
+          SA_Interval{3, 71},
+          VariantSitePath{VariantLocus{5, FIRST_ALLELE}},
+          VariantSitePath{},
+      },
+      SearchState{
+          SA_Interval{72, 72},
+          VariantSitePath{},
+          VariantSitePath{},
+      },
+      SearchState{
+          SA_Interval{73, 73},
+          VariantSitePath{VariantLocus{5, FIRST_ALLELE}},
+          VariantSitePath{},
+      }};
+  EXPECT_EQ(result, expected);
+}
+
+/**
+ * Builds the PRG the way `build` does, to disk, and loads it back the way
+ * `genotype` does, so that the site and allele ID arrays come from the
+ * deserialised coverage graph.
+ */
+class HandleAlleleEncapsulatedState_LoadedPrg : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // One directory per test, so that concurrently run tests do not clash
+    auto const test_name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    fill_common_parameters(parameters, "@" + std::string(test_name));
+    fs::create_directories(parameters.gram_dirpath);
+
+    PRG_String ps{prg_raw};
+    ps.write(parameters.encoded_prg_fpath, endianness::little);
+    dump_site_ends(parameters, ps.get_end_positions());
+    generate_cov_graph(parameters, ps);
+    auto const fm_index = generate_fm_index(parameters);
+    generate_bwt_masks(fm_index, parameters);
+
+    prg_info = load_prg_info(parameters);
+  }
+
+  void TearDown() override {
+    fs::remove_all(parameters.gram_dirpath);
+    // '@'-prefixed directories get their BWT masks written alongside them
+    for (auto const base : {"a", "c", "g", "t"})
+      fs::remove(parameters.gram_dirpath + "_" + base + "_base_bwt_mask");
+  }
+
+  marker_vec const prg_raw =
+      encode_prg("tcagtt5tcagtcag6atcagtttcag6ta7atcagt8gtg8g");
+  BuildParams parameters;
+  PRG_Info prg_info;
+};
+
+TEST_F(HandleAlleleEncapsulatedState_LoadedPrg,
+       GivenLoadedPrg_SiteAndAlleleIDsIndexed) {
+  auto const prg_size = prg_info.coverage_graph.random_access.size();
+  EXPECT_EQ(prg_size, prg_raw.size());
+  EXPECT_EQ(prg_info.pos_site_IDs.size(), prg_size);
+  EXPECT_EQ(prg_info.pos_allele_IDs.size(), prg_size);
+  // First 't' of the second allele of site 5
+  EXPECT_EQ(prg_info.pos_site_IDs[17], 5);
+  EXPECT_EQ(prg_info.pos_allele_IDs[17], FIRST_ALLELE + 1);
+  // Outside of variant sites
+  EXPECT_EQ(prg_info.pos_site_IDs[0], 0);
+}
+
+TEST_F(HandleAlleleEncapsulatedState_LoadedPrg,
+       MappingMultipleAlleleEncapsulation_SameAsGeneratedPrg) {
+  // All the C's; see MappingMultipleAlleleEncapsulation_CorrectSearchStates
+  SearchState search_state{SA_Interval{10, 15}};
+  auto result = handle_allele_encapsulated_state(search_state, prg_info);
+  auto expected = handle_allele_encapsulated_state(
+      search_state, generate_prg_info(prg_raw));
+  EXPECT_EQ(result.size(), 6);
+  EXPECT_EQ(result, expected);
+}
@@ -0,0 +1,117 @@
+#include <tuple>
+
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "genotype/quasimap/search/seed_extend.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+using Occurrences =
+    std::vector<std::tuple<SA_Index, VariantSitePath, VariantSitePath>>;
+
+/** One entry per SA index, so that the grouping of SA intervals is ignored */
+static Occurrences get_occurrences(SearchStates const &search_states) {
+  Occurrences result;
+  for (auto const &search_state : search_states) {
+    for (auto i = search_state.sa_interval.first;
+         i <= search_state.sa_interval.second; ++i)
+      result.emplace_back(i, search_state.traversed_path,
+                          search_state.traversing_path);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+TEST(MostSelectiveKmer, GivenRareKmerInRead_RareKmerChosen) {
+  prg_setup setup;
+  setup.setup_numbered_prg("aaaaacgt5a6c6aaaa", 3);
+  auto read = encode_dna_bases("aacgt");
+  // All kmers occur once, so the rightmost one gets chosen
+  EXPECT_EQ(most_selective_kmer_offset(3, read, setup.kmer_index), 2);
+
+  read = encode_dna_bases("acgtaaa");
+  // Only the rightmost kmer, 'aaa', occurs more than once
+  EXPECT_EQ(most_selective_kmer_offset(3, read, setup.kmer_index), 3);
+}
+
+TEST(MatchReadForward, GivenReadThroughNestedSites_CorrectPaths) {
+  prg_setup setup;
+  setup.setup_bracketed_prg("AATAA[CCC[A,G],T]AA[C,G]AA");
+  // Starts before the outer site, goes through its first allele and the
+  // nested site's second allele, and ends in the last site
+  auto read = encode_dna_bases("AACCCGAAG");
+  auto result = match_read_forward(read, 3, setup.prg_info);
+  ASSERT_EQ(result.size(), 1);
+  VariantSitePath expected_traversed{
+      VariantLocus{9, FIRST_ALLELE + 1},
+      VariantLocus{7, FIRST_ALLELE + 1},
+      VariantLocus{5, FIRST_ALLELE},
+  };
+  EXPECT_EQ(result[0].traversed_path, expected_traversed);
+  EXPECT_TRUE(result[0].traversing_path.empty());
+
+  // Starts in the nested site, and leaves both sites
+  read = encode_dna_bases("GAAC");
+  result = match_read_forward(read, 12, setup.prg_info);
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0].traversed_path,
+            VariantSitePath({VariantLocus{9, FIRST_ALLELE}}));
+  VariantSitePath expected_traversing{VariantLocus{5, ALLELE_UNKNOWN},
+                                      VariantLocus{7, ALLELE_UNKNOWN}};
+  EXPECT_EQ(result[0].traversing_path, expected_traversing);
+}
+
+class SeedExtendSearch : public ::testing::TestWithParam<std::string> {};
+
+TEST_P(SeedExtendSearch, GivenAllReads_SameMappingsAsBackwardSearch) {
+  uint32_t const kmer_size{3};
+  prg_setup setup;
+  setup.setup_bracketed_prg(GetParam(), kmer_size);
+
+  std::size_t num_mapped{0};
+  for (auto const &read : generate_all_kmers(6)) {
+    if (!all_read_kmers_occur_in_index(kmer_size, read, setup.kmer_index))
+      continue;
+    auto const expected = search_read_backwards(
+        read, get_last_kmer_in_read(kmer_size, read), setup.kmer_index,
+        setup.prg_info);
+    auto const result = search_read_seed_extend(
+        read, kmer_size, setup.kmer_index, setup.prg_info);
+    EXPECT_EQ(get_occurrences(result), get_occurrences(expected));
+    if (!expected.empty()) ++num_mapped;
+  }
+  EXPECT_GT(num_mapped, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Prgs, SeedExtendSearch,
+    ::testing::Values("GCTAC[C,G,TTA]AGTC[T,C]CTAAG",
+                      "AATAA[CCC[A,G],T]AA[C,G]AA",
+                      "AC[GA,]TT[A[C,G][T,],AC]ACGT",
+                      "TT[A,C][G,T][A,AC]TTCAGT"));
+
+TEST(SeedExtendSearch, GivenReads_SameCoverageAsBackwardSearch) {
+  std::string const prg{"gct5c6g6t6ag7t8c8cta"};
+  prg_setup setup;
+  setup.setup_numbered_prg(prg, 3);
+  prg_setup seed_setup;
+  seed_setup.setup_numbered_prg(prg, 3);
+  seed_setup.parameters.search_mode = SearchMode::SeedExtend;
+
+  Sequences reads = {encode_dna_bases("ctcagt"), encode_dna_bases("tgagcc"),
+                     encode_dna_bases("agccta"), encode_dna_bases("gcttag")};
+  for (auto const &read : reads) {
+    quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
+                  setup.parameters, setup.quasimap_stats);
+    quasimap_read(read, seed_setup.coverage, seed_setup.kmer_index,
+                  seed_setup.prg_info, seed_setup.parameters,
+                  seed_setup.quasimap_stats);
+  }
+  EXPECT_EQ(seed_setup.quasimap_stats.exact_mapped_reads_count,
+            setup.quasimap_stats.exact_mapped_reads_count);
+  EXPECT_EQ(seed_setup.coverage.allele_sum_coverage,
+            setup.coverage.allele_sum_coverage);
+  EXPECT_EQ(seed_setup.coverage.grouped_allele_counts,
+            setup.coverage.grouped_allele_counts);
+  EXPECT_EQ(coverage::generate::allele_base_non_nested(seed_setup.prg_info),
+            coverage::generate::allele_base_non_nested(setup.prg_info));
+}
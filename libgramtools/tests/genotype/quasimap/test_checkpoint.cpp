@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "genotype/quasimap/checkpoint.hpp"
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+class Checkpoint : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (auto *setup : {&uninterrupted, &interrupted}) {
+      setup->setup_numbered_prg("gct5c6g6t6ag7t8c8cta", 3);
+      setup->parameters.reads_fpaths = {reads_fpath};
+      setup->parameters.checkpoint_fpath = checkpoint_fpath;
+      setup->parameters.seed = 42;
+    }
+  }
+
+  void TearDown() override {
+    std::remove(reads_fpath.c_str());
+    std::remove(checkpoint_fpath.c_str());
+  }
+
+  void write_reads(std::size_t num_reads) {
+    std::ofstream fhandle(reads_fpath);
+    for (std::size_t i = 0; i < num_reads; ++i) {
+      fhandle << "@r" << i << "\n"
+              << reads[i].first << "\n+\n"
+              << reads[i].second << "\n";
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> const reads{
+      {"ctcagt", "555555"}, {"tgagcc", "??????"}, {"agccta", "5?5?5?"},
+      {"gcttag", "555555"}, {"aaaaaa", "??????"}, {"ctcagt", "5555??"},
+      {"tagtcc", "??5555"}, {"gctcag", "555555"}};
+  std::string const reads_fpath{"@checkpoint_reads.fq"};
+  std::string const checkpoint_fpath{"@checkpoint"};
+  prg_setup uninterrupted, interrupted;
+};
+
+TEST_F(Checkpoint, GivenResumedRun_SameResultsAsUninterrupted) {
+  write_reads(reads.size());
+  auto const expected =
+      quasimap_reads(uninterrupted.parameters, uninterrupted.kmer_index,
+                     uninterrupted.prg_info, uninterrupted.read_stats);
+
+  // A run killed after mapping the first reads, and checkpointing them
+  std::size_t const num_mapped{3};
+  write_reads(num_mapped);
+  auto &parameters = interrupted.parameters;
+  SeedSize const master_seed{42};
+  ReadsProgress progress;
+  QuasimapReadsStats killed_stats;
+  killed_stats.coverage =
+      coverage::generate::empty_structure(interrupted.prg_info);
+  handle_read_files(killed_stats, parameters, interrupted.kmer_index,
+                    interrupted.prg_info, master_seed, progress);
+  EXPECT_EQ(progress.num_reads, std::vector<uint64_t>{num_mapped});
+  Checkpointer checkpointer{parameters, interrupted.prg_info, master_seed};
+  checkpointer.write(killed_stats, progress);
+
+  write_reads(reads.size());
+  parameters.resume = true;
+  auto const result =
+      quasimap_reads(parameters, interrupted.kmer_index, interrupted.prg_info,
+                     interrupted.read_stats);
+
+  EXPECT_EQ(result.all_reads_count, expected.all_reads_count);
+  EXPECT_EQ(result.exact_mapped_reads_count, expected.exact_mapped_reads_count);
+  EXPECT_EQ(result.coverage.allele_sum_coverage,
+            expected.coverage.allele_sum_coverage);
+  EXPECT_EQ(result.coverage.grouped_allele_counts,
+            expected.coverage.grouped_allele_counts);
+  EXPECT_EQ(coverage::generate::allele_base_non_nested(interrupted.prg_info),
+            coverage::generate::allele_base_non_nested(uninterrupted.prg_info));
+  EXPECT_EQ(interrupted.read_stats.get_mean_pb_error(),
+            uninterrupted.read_stats.get_mean_pb_error());
+  EXPECT_EQ(interrupted.read_stats.get_max_read_len(),
+            uninterrupted.read_stats.get_max_read_len());
+}
+
+TEST_F(Checkpoint, GivenCheckpointOfOtherReads_Throws) {
+  write_reads(reads.size());
+  auto &parameters = interrupted.parameters;
+  Checkpointer checkpointer{parameters, interrupted.prg_info, 42};
+  QuasimapReadsStats quasimap_stats;
+  checkpointer.write(quasimap_stats, ReadsProgress{{1}, {ReadStats{}}});
+
+  parameters.reads_fpaths = {"other_reads.fq"};
+  RandomInclusiveInt seed_generator;
+  EXPECT_THROW(load_checkpoint(parameters, interrupted.prg_info,
+                               quasimap_stats, seed_generator),
+               std::runtime_error);
+}
+
+TEST_F(Checkpoint, GivenOtherMappingOptionsOrSeed_Throws) {
+  write_reads(reads.size());
+  auto &parameters = interrupted.parameters;
+  Checkpointer checkpointer{parameters, interrupted.prg_info, 42};
+  QuasimapReadsStats quasimap_stats;
+  checkpointer.write(quasimap_stats, ReadsProgress{{1}, {ReadStats{}}});
+  RandomInclusiveInt seed_generator;
+  auto load = [&]() {
+    load_checkpoint(parameters, interrupted.prg_info, quasimap_stats,
+                    seed_generator);
+  };
+
+  parameters.max_mismatches = 1;
+  EXPECT_THROW(load(), std::runtime_error);
+  parameters.max_mismatches = 0;
+  parameters.search_mode = SearchMode::SeedExtend;
+  EXPECT_THROW(load(), std::runtime_error);
+  parameters.search_mode = SearchMode::Backward;
+  parameters.kmers_size += 1;
+  EXPECT_THROW(load(), std::runtime_error);
+  parameters.kmers_size -= 1;
+  parameters.seed = 43;
+  EXPECT_THROW(load(), std::runtime_error);
+
+  // Without a given seed, the checkpoint's gets used
+  parameters.seed = std::nullopt;
+  EXPECT_NO_THROW(load());
+  EXPECT_EQ(seed_generator.get_seed(), Seed{42});
+}
+
+TEST_F(Checkpoint, GivenDefaultParameters_NoCheckpointWritten) {
+  write_reads(reads.size());
+  quasimap_reads(uninterrupted.parameters, uninterrupted.kmer_index,
+                 uninterrupted.prg_info, uninterrupted.read_stats);
+  EXPECT_FALSE(std::filesystem::exists(checkpoint_fpath));
+
+  interrupted.parameters.checkpoint_seconds = 600;
+  quasimap_reads(interrupted.parameters, interrupted.kmer_index,
+                 interrupted.prg_info, interrupted.read_stats);
+  EXPECT_TRUE(std::filesystem::exists(checkpoint_fpath));
+}
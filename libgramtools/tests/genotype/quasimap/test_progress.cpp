@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "genotype/quasimap/progress.hpp"
+#include "gtest/gtest.h"
+
+using namespace gram;
+
+TEST(ProgressReporter, GivenThreadsProgress_SnapshotSumsThem) {
+  ProgressReporter reporter{3, 1000, "", 0};
+  ThreadProgress::add(reporter.thread_progress(0).num_reads, 10);
+  ThreadProgress::add(reporter.thread_progress(2).num_reads, 30);
+  ThreadProgress::add(reporter.thread_progress(2).num_mapped_reads, 20);
+  ThreadProgress::add(reporter.thread_progress(1).num_bytes, 250);
+
+  auto const snapshot = reporter.snapshot();
+  EXPECT_EQ(snapshot.num_reads, 40);
+  EXPECT_EQ(snapshot.num_mapped_reads, 20);
+  EXPECT_EQ(snapshot.num_bytes, 250);
+  EXPECT_EQ(snapshot.total_bytes, 1000);
+  EXPECT_DOUBLE_EQ(snapshot.mapped_fraction(), 0.5);
+}
+
+TEST(ProgressSnapshot, GivenBytesLoaded_EtaFromBytesLeft) {
+  ProgressSnapshot snapshot;
+  snapshot.seconds = 10;
+  snapshot.total_bytes = 1000;
+  EXPECT_LT(snapshot.eta_seconds(), 0);
+
+  snapshot.num_bytes = 250;
+  EXPECT_DOUBLE_EQ(snapshot.eta_seconds(), 30);
+}
+
+TEST(ProgressReporter, GivenProgressFile_LastReportWrittenAsJson) {
+  std::string const fpath{"@progress.json"};
+  {
+    ProgressReporter reporter{1, 0, fpath, 0};
+    ThreadProgress::add(reporter.thread_progress(0).num_reads, 7);
+  }
+  std::ifstream ifs{fpath};
+  auto const json = nlohmann::json::parse(ifs);
+  EXPECT_EQ(json.at("reads"), 7);
+  EXPECT_TRUE(json.at("eta_seconds").is_null());
+  std::remove(fpath.c_str());
+}
+
+TEST(ProgressReporter, GivenNoReportingAsked_NothingReported) {
+  testing::internal::CaptureStderr();
+  { ProgressReporter reporter{1, 0, "", 0}; }
+  EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+
+  testing::internal::CaptureStderr();
+  { ProgressReporter reporter{1, 0, "", DEFAULT_PROGRESS_SECONDS}; }
+  EXPECT_FALSE(testing::internal::GetCapturedStderr().empty());
+}
@@ -12,6 +12,10 @@
  *
  */
 
+#include <omp.h>
+
+#include <cstdio>
+#include <fstream>
 #include <stdexcept>
 
 #include "genotype/quasimap/coverage/allele_base.hpp"
@@ -175,24 +179,24 @@ TEST(Coverage, ReadMapsToThreePositions_CorrectAlleleCoverage) {
   /**
    * The read has three mapping instances, with two distinct site paths:
    * site 5 only, or site 5 and site 7.
-   * Depending on choice of seed, can choose one or the other.
+   * Depending on choice of selection key, can choose one or the other.
    */
   prg_setup setup;
   setup.setup_numbered_prg("TAG5Tc6g6T6AG7T8c8cta");
   const auto read = encode_dna_bases("tagt");
 
   // Chooses mapping instance in site 5 only
-  SeedSize const random_seed1 = 42;
+  SelectionKey const selection_key1 = 150;
   quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
-                setup.parameters, setup.quasimap_stats, random_seed1);
+                setup.parameters, setup.quasimap_stats, selection_key1);
   auto &result = setup.coverage.allele_sum_coverage;
   AlleleSumCoverage expected = {{1, 0, 1}, {0, 0}};
   EXPECT_EQ(result, expected);
 
   // Chooses mapping instance in site 5 + site 7
-  SeedSize const random_seed2 = 150;
+  SelectionKey const selection_key2 = 42;
   quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
-                setup.parameters, setup.quasimap_stats, random_seed2);
+                setup.parameters, setup.quasimap_stats, selection_key2);
   expected = {{1, 0, 2}, {1, 0}};
   EXPECT_EQ(result, expected);
 }
@@ -241,10 +245,10 @@ TEST(Coverage, ReadMapsWithinAlleleAndOutsideSite_CorrectSumCoverage) {
   prg_setup setup;
   setup.setup_numbered_prg("gtagtac5gtagtact6t6ta");
 
-  SeedSize const random_seed = 29;
+  SelectionKey const selection_key = 42;
   Sequence read = encode_dna_bases("gtagt");
   quasimap_read(read, setup.coverage, setup.kmer_index, setup.prg_info,
-                setup.parameters, setup.quasimap_stats, random_seed);
+                setup.parameters, setup.quasimap_stats, selection_key);
 
   auto const &sumCovResult = setup.coverage.allele_sum_coverage;
   AlleleSumCoverage sumCovExpected = {{1, 0}};
@@ -830,3 +834,97 @@ TEST_F(Coverage_Nested_SingleNestingPlusSNP,
       PerBaseCoverage{0},    PerBaseCoverage{1}};
   EXPECT_EQ(PbCov, expectedPbCov);
 }
+
+TEST(ReadBatchSizer, GivenThroughput_BatchSizeTargetsBatchTime) {
+  ReadBatchSizer batch_sizer;
+  EXPECT_EQ(batch_sizer.size(), INITIAL_READS_BATCH_SIZE);
+
+  batch_sizer.update(5000, 0.25 * TARGET_READS_BATCH_SECONDS);
+  EXPECT_EQ(batch_sizer.size(), 20000);
+
+  // No time measured: size unchanged
+  batch_sizer.update(5000, 0);
+  EXPECT_EQ(batch_sizer.size(), 20000);
+}
+
+TEST(ReadBatchSizer, GivenExtremeThroughputs_BatchSizeBounded) {
+  ReadBatchSizer batch_sizer;
+  batch_sizer.update(5000, 1000 * TARGET_READS_BATCH_SECONDS);
+  EXPECT_EQ(batch_sizer.size(), MIN_READS_BATCH_SIZE);
+
+  batch_sizer.update(5000, 1e-6 * TARGET_READS_BATCH_SECONDS);
+  EXPECT_EQ(batch_sizer.size(), MAX_READS_BATCH_SIZE);
+}
+
+class ReadFiles_Quasimap : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    for (auto const &reads_fpath : reads_fpaths)
+      std::remove(reads_fpath.c_str());
+  }
+
+  /** Spreads the reads over several reads files, of different sizes */
+  void write_reads() {
+    std::size_t read_index = 0;
+    for (std::size_t i = 0; i < 5; ++i) {
+      reads_fpaths.push_back("@quasimap_reads_" + std::to_string(i) + ".fq");
+      std::ofstream fhandle(reads_fpaths.back());
+      for (std::size_t j = 0; j <= i; ++j, ++read_index)
+        fhandle << "@r" << read_index << "\n"
+                << reads[read_index % reads.size()].first << "\n+\n"
+                << reads[read_index % reads.size()].second << "\n";
+    }
+  }
+
+  QuasimapReadsStats map_with_threads(prg_setup &setup, int num_threads) {
+    setup.setup_numbered_prg("gct5c6g6t6ag7t8c8cta", 3);
+    setup.parameters.reads_fpaths = reads_fpaths;
+    setup.parameters.seed = 42;
+    auto const max_threads = omp_get_max_threads();
+    omp_set_num_threads(num_threads);
+    auto const result = quasimap_reads(setup.parameters, setup.kmer_index,
+                                       setup.prg_info, setup.read_stats);
+    omp_set_num_threads(max_threads);
+    return result;
+  }
+
+  std::vector<std::pair<std::string, std::string>> const reads{
+      {"ctcagt", "555555"}, {"tgagcc", "??????"}, {"agccta", "5?5?5?"},
+      {"gcttag", "555555"}, {"ctcagt", "5555??"}, {"tagtcc", "??5555"},
+      {"gctcag", "555555"}};
+  std::vector<std::string> reads_fpaths;
+};
+
+TEST_F(ReadFiles_Quasimap, GivenMoreThreads_SameResults) {
+  write_reads();
+  prg_setup one_thread, four_threads;
+  auto const expected = map_with_threads(one_thread, 1);
+  auto const result = map_with_threads(four_threads, 4);
+
+  EXPECT_EQ(result.all_reads_count, 30);
+  EXPECT_EQ(result.all_reads_count, expected.all_reads_count);
+  EXPECT_EQ(result.exact_mapped_reads_count, expected.exact_mapped_reads_count);
+  EXPECT_EQ(result.coverage.allele_sum_coverage,
+            expected.coverage.allele_sum_coverage);
+  EXPECT_EQ(result.coverage.grouped_allele_counts,
+            expected.coverage.grouped_allele_counts);
+  EXPECT_EQ(coverage::generate::allele_base_non_nested(four_threads.prg_info),
+            coverage::generate::allele_base_non_nested(one_thread.prg_info));
+  EXPECT_EQ(four_threads.read_stats.get_mean_pb_error(),
+            one_thread.read_stats.get_mean_pb_error());
+  EXPECT_EQ(four_threads.read_stats.get_max_read_len(),
+            one_thread.read_stats.get_max_read_len());
+}
+
+TEST_F(ReadFiles_Quasimap, GivenThreadTeam_ThreadTimeFromTeamSize) {
+  write_reads();
+  prg_setup setup;
+  setup.parameters.maximum_threads = 1;
+  auto const result = map_with_threads(setup, 3);
+
+  EXPECT_GT(result.mapping_seconds, 0);
+  EXPECT_NEAR(result.mapping_thread_seconds, 3 * result.mapping_seconds,
+              1e-9 * result.mapping_thread_seconds);
+  EXPECT_LE(result.loading_thread_seconds + result.idle_thread_seconds,
+            result.mapping_thread_seconds);
+}
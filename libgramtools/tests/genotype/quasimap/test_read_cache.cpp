@@ -0,0 +1,89 @@
+#include "genotype/quasimap/coverage/allele_base.hpp"
+#include "genotype/quasimap/quasimap.hpp"
+#include "genotype/quasimap/read_cache.hpp"
+#include "gtest/gtest.h"
+#include "test_resources.hpp"
+
+static ReadMappingsPtr make_mappings(SA_Index sa_index) {
+  SearchStates search_states{SearchState{SA_Interval{sa_index, sa_index}}};
+  return std::make_shared<ReadMappings const>(
+      ReadMappings{ReadMapping{ReadMappingOutcome::mapped, search_states},
+                   ReadMapping{ReadMappingOutcome::missing_kmer, {}}});
+}
+
+TEST(MappedReadCache, GivenInsertedRead_FoundWithItsMappings) {
+  MappedReadCache cache{10};
+  auto const read = encode_dna_bases("ACGT");
+  EXPECT_EQ(cache.find(read), nullptr);
+
+  auto const mappings = make_mappings(3);
+  cache.insert(read, mappings);
+  EXPECT_EQ(cache.find(read), mappings);
+  EXPECT_EQ(cache.find(encode_dna_bases("ACGA")), nullptr);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_GT(cache.memory_usage(), 0);
+  EXPECT_EQ(cache.num_lookups(), 3);
+  EXPECT_EQ(cache.num_hits(), 1);
+}
+
+TEST(MappedReadCache, GivenMoreReadsThanCapacity_SizeBounded) {
+  // One read per shard
+  MappedReadCache cache{READ_CACHE_SHARDS};
+  for (auto const& kmer : generate_all_kmers(5))
+    cache.insert(kmer, make_mappings(1));
+  EXPECT_LE(cache.size(), READ_CACHE_SHARDS);
+}
+
+TEST(MappedReadCache, GivenMoreBytesThanCapacity_MemoryBounded) {
+  auto const kmers = generate_all_kmers(5);
+  auto const mappings = make_mappings(1);
+  // Room for about two reads per shard
+  auto const max_bytes =
+      2 * READ_CACHE_SHARDS * read_mappings_bytes(*kmers.begin(), *mappings);
+  MappedReadCache cache{kmers.size(), max_bytes};
+  for (auto const& kmer : kmers) cache.insert(kmer, mappings);
+  EXPECT_GT(cache.size(), 0);
+  EXPECT_LT(cache.size(), 2 * READ_CACHE_SHARDS);
+  EXPECT_LE(cache.memory_usage(), max_bytes);
+}
+
+TEST(MappedReadCache, GivenDefaultParameters_CacheOnWithDefaultSize) {
+  EXPECT_EQ(GenotypeParams{}.read_cache_size, DEFAULT_READ_CACHE_SIZE);
+}
+
+TEST(MappedReadCache, GivenDuplicateReads_SameCoverageAsWithoutCache) {
+  prg_setup setup;
+  setup.setup_numbered_prg("gct5c6g6T6AG7T8c8cta");
+  setup.quasimap_stats.coverage = setup.coverage;
+  prg_setup cached_setup;
+  cached_setup.setup_numbered_prg("gct5c6g6T6AG7T8c8cta");
+  cached_setup.quasimap_stats.coverage = cached_setup.coverage;
+
+  MappedReadCache cache{10};
+  Sequences reads = {encode_dna_bases("tagt"), encode_dna_bases("tagt"),
+                     encode_dna_bases("ttag")};
+  for (auto const& read : reads) {
+    quasimap_forward_reverse(setup.quasimap_stats,
+                             setup.quasimap_stats.coverage, read,
+                             setup.parameters, setup.kmer_index,
+                             setup.prg_info, 42);
+    quasimap_forward_reverse(cached_setup.quasimap_stats,
+                             cached_setup.quasimap_stats.coverage, read,
+                             cached_setup.parameters, cached_setup.kmer_index,
+                             cached_setup.prg_info, 42, &cache);
+  }
+
+  auto const& stats = setup.quasimap_stats;
+  auto const& cached_stats = cached_setup.quasimap_stats;
+  EXPECT_EQ(cached_stats.cached_reads_count, 2);
+  EXPECT_EQ(cached_stats.exact_mapped_reads_count,
+            stats.exact_mapped_reads_count);
+  EXPECT_EQ(cached_stats.missing_kmer_reads_count,
+            stats.missing_kmer_reads_count);
+  EXPECT_EQ(cached_stats.coverage.allele_sum_coverage,
+            stats.coverage.allele_sum_coverage);
+  EXPECT_EQ(cached_stats.coverage.grouped_allele_counts,
+            stats.coverage.grouped_allele_counts);
+  EXPECT_EQ(coverage::generate::allele_base_non_nested(cached_setup.prg_info),
+            coverage::generate::allele_base_non_nested(setup.prg_info));
+}
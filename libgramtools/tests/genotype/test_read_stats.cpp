@@ -38,6 +38,36 @@ TEST(ReadProcessingStats, GivenOneOKAndOneEmptyGenomicRead_CorrectStats) {
   EXPECT_FLOAT_EQ(r.get_mean_pb_error(), 0.001);
 }
 
+TEST(ReadProcessingStats, GivenMoreReadsThanSampled_StatsOverAllReads) {
+  ReadStats r;
+  for (int i = 0; i < 3 * NUM_READS_USED; ++i) {
+    r.record_read(GenomicRead{"Read", "AAAA", "5555"});
+    r.record_read(GenomicRead{"Read", "AAAA", ""});
+  }
+  r.record_read(GenomicRead{"Read", "AAAAAAAA", "55555555"});
+  r.finalise_base_error_rate();
+
+  // Qualities are only kept for a sample of the reads
+  EXPECT_GE(r.get_num_bases_processed(), 4 * NUM_READS_USED);
+  EXPECT_LE(r.get_num_bases_processed(), 4 * NUM_READS_USED + 4);
+  EXPECT_EQ(r.get_num_no_qual_reads(), 3 * NUM_READS_USED);
+  EXPECT_EQ(r.get_max_read_len(), 8);
+  EXPECT_FLOAT_EQ(r.get_mean_pb_error(), 0.01);
+}
+
+TEST(ReadProcessingStats, GivenSamplerSeeds_SampleDependsOnSeed) {
+  auto sample = [](uint64_t const seed) {
+    ReadStats r;
+    r.seed_sampler(seed);
+    for (int i = 0; i < 2 * NUM_READS_USED; ++i)
+      r.record_read(GenomicRead{"Read", "AAAA", i % 2 == 0 ? "5555" : "????"});
+    r.finalise_base_error_rate();
+    return r.get_mean_pb_error();
+  };
+  EXPECT_EQ(sample(7), sample(7));
+  EXPECT_NE(sample(7), sample(8));
+}
+
 /**
  * Coverage mean and variance
  * Notes:
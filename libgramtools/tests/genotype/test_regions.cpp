@@ -0,0 +1,82 @@
+#include "../test_resources/test_resources.hpp"
+#include "genotype/regions.hpp"
+#include "gtest/gtest.h"
+
+using namespace gram::genotype;
+using namespace gram::genotype::infer;
+
+TEST(LoadBed, GivenHeaderAndCommentLines_OnlyRegionsLoaded) {
+  std::stringstream bed{
+      "track name=sites\n"
+      "# comment\n"
+      "\n"
+      "chr1\t10\t20\tname\n"
+      "chr2 0 5\n"};
+  auto regions = load_bed(bed);
+  ASSERT_EQ(regions.size(), 2);
+  EXPECT_EQ(regions.at(0).chrom, "chr1");
+  EXPECT_EQ(regions.at(0).start, 10);
+  EXPECT_EQ(regions.at(0).end, 20);
+  EXPECT_EQ(regions.at(1).chrom, "chr2");
+}
+
+TEST(LoadBed, GivenInvalidLines_Throws) {
+  std::stringstream missing_end{"chr1\t10\n"};
+  EXPECT_THROW(load_bed(missing_end), RegionsException);
+  std::stringstream inverted{"chr1\t20\t10\n"};
+  EXPECT_THROW(load_bed(inverted), RegionsException);
+}
+
+class SelectRegions : public ::testing::Test {
+ protected:
+  void SetUp() {
+    // Site 5 spans [5, 9) of the REF, with site 7 nested in it; site 9 spans
+    // [11, 12).
+    setup.setup_bracketed_prg("AATAA[CCC[A,G],T]AA[C,G]AA");
+  }
+  SiteSelection select(Regions const& regions) {
+    return select_sites(setup.prg_info.coverage_graph, regions, tracker);
+  }
+  prg_setup setup;
+  std::stringstream coords_file{""};
+  SegmentTracker tracker{coords_file};
+};
+
+TEST_F(SelectRegions, GivenRegionOverLevel1Site_NestedSitesSelected) {
+  auto selection = select({{"gramtools_prg", 8, 9}});
+  EXPECT_EQ(selection, (SiteSelection{true, true, false}));
+}
+
+TEST_F(SelectRegions, GivenRegionsOutsideSites_NoSitesSelected) {
+  auto selection = select({{"gramtools_prg", 0, 5}, {"gramtools_prg", 9, 11}});
+  EXPECT_EQ(selection, (SiteSelection{false, false, false}));
+}
+
+TEST_F(SelectRegions, GivenOverlappingRegions_SitesSelectedOnce) {
+  auto selection =
+      select({{"gramtools_prg", 10, 12}, {"gramtools_prg", 0, 11}});
+  EXPECT_EQ(selection, (SiteSelection{true, true, true}));
+}
+
+TEST_F(SelectRegions, GivenRegionOnUnknownSequence_Throws) {
+  EXPECT_THROW(select({{"chr1", 0, 5}}), RegionsException);
+}
+
+TEST_F(SelectRegions, GivenSelectedSite_OnlyKmersReachingItSelected) {
+  auto kmers = get_region_kmers(setup.kmer_index, setup.prg_info,
+                                SiteSelection{false, false, true},
+                                setup.parameters.kmers_size);
+  // Going into, through and out of site 9
+  EXPECT_EQ(kmers.count(encode_dna_bases("AC")), 1);
+  EXPECT_EQ(kmers.count(encode_dna_bases("GA")), 1);
+  // Only found in site 5, and before it
+  EXPECT_EQ(kmers.count(encode_dna_bases("CC")), 0);
+  EXPECT_EQ(kmers.count(encode_dna_bases("TA")), 0);
+}
+
+TEST(ReadHitsKmers, GivenReadsWithAndWithoutKmer_CorrectHits) {
+  KmerSet kmers{encode_dna_bases("GA")};
+  EXPECT_TRUE(read_hits_kmers(encode_dna_bases("TTGAT"), 2, kmers));
+  EXPECT_FALSE(read_hits_kmers(encode_dna_bases("TTAGT"), 2, kmers));
+  EXPECT_FALSE(read_hits_kmers(encode_dna_bases("G"), 2, kmers));
+}
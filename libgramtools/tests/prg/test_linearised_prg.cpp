@@ -131,9 +131,35 @@ TEST_F(PRGString_WriteAndRead, WriteAndReadBigEndian) {
   EXPECT_EQ(expected_markers, p2.get_PRG_string());
 }
 
+TEST_F(PRGString_WriteAndRead, ReadTruncatedFile_Throws) {
+  p.write(fname);
+  std::ofstream out(fname, std::ofstream::binary | std::ofstream::app);
+  out.put(1);
+  out.close();
+  EXPECT_THROW(PRG_String{fname}, std::runtime_error);
+}
+
+TEST_F(PRGString_WriteAndRead, ReadNullInteger_Throws) {
+  PRG_String{marker_vec{1, 2, 0, 3}}.write(fname);
+  EXPECT_THROW(PRG_String{fname}, std::runtime_error);
+}
+
 TEST(PRGString, ExitPoint_MapPositions) {
   marker_vec t{5, 1, 6, 2, 7, 1, 8, 3, 8, 6};  // Ie: "[A,C[A,T]]"
   PRG_String l = PRG_String(t);
   std::unordered_map<Marker, int> expected_end_positions{{6, 9}, {8, 8}};
   EXPECT_EQ(expected_end_positions, l.get_end_positions());
 }
+
+TEST(PRGString, GivenSitesFarApart_EndPositionsAndDuplicatesFound) {
+  // Long enough to be scanned for markers in several chunks
+  marker_vec t(3000000, 1);
+  t[10] = 5;
+  t[2000000] = 6;
+  t[2999998] = 6;
+  EXPECT_EQ(PRG_String(t).get_end_positions(),
+            (std::unordered_map<Marker, int>{{6, 2999998}}));
+
+  t[2999999] = 5;
+  EXPECT_THROW(PRG_String{t}, std::runtime_error);
+}
@@ -57,3 +57,12 @@ TEST(BuildChildMap, GivenParentalMap_CorrectChildMap) {
 
   EXPECT_EQ(result, expected);
 }
+
+TEST(SiteEnds, GivenDumpedSiteEnds_LoadedBack) {
+  CommonParameters parameters;
+  parameters.site_ends_fpath = "@site_ends";
+  PRG_String prg{prg_string_to_ints("[A[C,G],T]T[,C]")};
+  dump_site_ends(parameters, prg.get_end_positions());
+  EXPECT_EQ(load_site_ends(parameters), prg.get_end_positions());
+  std::remove(parameters.site_ends_fpath.c_str());
+}
@@ -0,0 +1,94 @@
+#include <omp.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "prg/coverage_graph.hpp"
+#include "prg/per_base_coverage.hpp"
+#include "submod_resources.hpp"
+
+using namespace gram;
+
+static constexpr CovCount max_counter =
+    std::numeric_limits<PbCovCounter>::max();
+
+TEST(PbCovStore, GivenAllocations_ContiguousZeroedCounters) {
+  PbCovStore store;
+  EXPECT_EQ(store.allocate(3), 0);
+  EXPECT_EQ(store.allocate(2), 3);
+  EXPECT_EQ(store.size(), 5);
+  EXPECT_EQ(store.get_range(0, 5), PerBaseCoverage(5, 0));
+}
+
+TEST(PbCovStore, GivenIncrementsPastCounterMaximum_SpillToOverflowCounter) {
+  PbCovStore store;
+  store.allocate(2);
+  for (CovCount i{0}; i < max_counter + 2; ++i) store.increment(1);
+  EXPECT_EQ(store.get(0), 0);
+  EXPECT_EQ(store.get(1), max_counter + 2);
+  EXPECT_EQ(store.num_overflow_counters(), 1);
+}
+
+TEST(PbCovStore, GivenSetValues_GetSameValues) {
+  PbCovStore store;
+  store.allocate(3);
+  store.set(0, 7);
+  store.set(1, max_counter + 10);
+  store.set(2, max_counter);
+  EXPECT_EQ(store.get_range(0, 3),
+            PerBaseCoverage({7, max_counter + 10, max_counter}));
+
+  store.set(1, 3);
+  EXPECT_EQ(store.get(1), 3);
+  EXPECT_EQ(store.num_overflow_counters(), 1);
+}
+
+TEST(PbCovStore, GivenConcurrentIncrements_NoCountLost) {
+  PbCovStore store;
+  store.allocate(2);
+  CovCount const num_increments{3 * max_counter};
+#pragma omp parallel for num_threads(4)
+  for (CovCount i = 0; i < num_increments; ++i) {
+    store.increment(0);
+    if (i % 2 == 0) store.increment(1);
+  }
+  EXPECT_EQ(store.get(0), num_increments);
+  EXPECT_EQ(store.get(1), (num_increments + 1) / 2);
+}
+
+TEST(PbCovStore, GivenOverflowCountersInSeveralShards_SerialisedAndReloaded) {
+  PbCovStore store;
+  store.allocate(PB_COV_OVERFLOW_SHARDS + 2);
+  store.set(1, max_counter + 1);
+  store.set(PB_COV_OVERFLOW_SHARDS + 1, max_counter + 2);
+  store.set(2, max_counter + 3);
+  EXPECT_EQ(store.num_overflow_counters(), 3);
+
+  std::stringstream archive;
+  {
+    boost::archive::binary_oarchive oa{archive};
+    oa << store;
+  }
+  PbCovStore reloaded;
+  boost::archive::binary_iarchive ia{archive};
+  ia >> reloaded;
+
+  EXPECT_EQ(reloaded.num_overflow_counters(), 3);
+  EXPECT_EQ(reloaded.get_range(0, store.size()),
+            store.get_range(0, store.size()));
+}
+
+TEST(PbCovStore, GivenCoverageGraph_OnlySiteBasesAllocated) {
+  auto encoded_prg = prg_string_to_ints("AA[CCC,G]T[A,]");
+  PRG_String p{encoded_prg};
+  coverage_Graph g{p};
+  EXPECT_EQ(g.pb_cov_store->size(), 5);
+
+  auto const& node = g.random_access[3].node;
+  node->increment_coverage(1);
+  EXPECT_EQ(node->get_coverage(), PerBaseCoverage({0, 1, 0}));
+  EXPECT_EQ(g.pb_cov_store->get(1), 1);
+}
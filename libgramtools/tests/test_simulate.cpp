@@ -210,3 +210,19 @@ TEST_F(TestInduceGenotypes_InduceOneSeq,
   EXPECT_EQ(expected_seqs, std::vector<std::string>({"C", "GGGGA", "GGG"}));
   EXPECT_EQ(expected_ids, AlleleIds({1, 2, 1}));
 }
+
+TEST(SimulationGenotyper, GivenSameSeed_SamePaths) {
+  coverage_Graph g{PRG_String{prg_string_to_ints("AA[A,C,G]TG[AC,[G,T]CA]C")}};
+  auto simulate_haplogroups = [&g](RandomGenerator* rand) {
+    std::vector<AlleleIds> result;
+    for (int path{0}; path < 5; ++path) {
+      SimulationGenotyper gtyper(g, rand);
+      for (auto const& site : gtyper.get_genotyped_records())
+        result.push_back(site->get_all_gtype_info().haplogroups);
+    }
+    return result;
+  };
+  RandomInclusiveInt first_rand{42}, second_rand{42};
+  EXPECT_EQ(simulate_haplogroups(&first_rand),
+            simulate_haplogroups(&second_rand));
+}